@@ -32,6 +32,7 @@
         'src/C/LzmaDec.c',
         'src/C/LzmaEnc.c',
         'src/C/MtCoder.c',
+        'src/C/MtDec.c',
         'src/C/Ppmd7.c',
         'src/C/Ppmd7Dec.c',
         'src/C/Ppmd7Enc.c',
@@ -88,6 +89,7 @@
         'src/CPP/7zip/Common/OutBuffer.cpp',
         'src/CPP/7zip/Common/ProgressUtils.cpp',
         'src/CPP/7zip/Common/PropId.cpp',
+        'src/CPP/7zip/Common/StreamBinder.cpp',
         'src/CPP/7zip/Common/StreamObjects.cpp',
         'src/CPP/7zip/Common/StreamUtils.cpp',
         'src/CPP/7zip/Common/UniqBlocks.cpp',
@@ -144,18 +146,25 @@
         'src/plzma_base_callback.cpp',
         'src/plzma_common.cpp',
         'src/plzma_decoder_impl.cpp',
+        'src/plzma_dir_scanner.cpp',
         'src/plzma_encoder_impl.cpp',
         'src/plzma_exception.cpp',
         'src/plzma_extract_callback.cpp',
         'src/plzma_file_utils.cpp',
+        'src/plzma_in_push_stream.cpp',
         'src/plzma_in_streams.cpp',
+        'src/plzma_index_cache.cpp',
         'src/plzma_item.cpp',
+        'src/plzma_item_stream.cpp',
+        'src/plzma_item_table.cpp',
         'src/plzma_open_callback.cpp',
         'src/plzma_out_streams.cpp',
         'src/plzma_path.cpp',
         'src/plzma_path_utils.cpp',
         'src/plzma_progress.cpp',
+        'src/plzma_random_access_stream.cpp',
         'src/plzma_raw_heap_memory.cpp',
+        'src/plzma_solid_checkpoints.cpp',
         'src/plzma_string.cpp',
         'src/plzma_update_callback.cpp'
       ],
@@ -26,8 +26,13 @@
 
 
 #include <thread>
+#include <string>
+#include <chrono>
 
 #include "plzma_public_tests.hpp"
+#include "../src/plzma_in_streams.hpp"
+#include "../src/plzma_base_callback.hpp"
+#include "../src/CPP/Windows/PropVariant.h"
 
 #include "../test_files/file__shutuptakemoney_jpg.h"
 #include "../test_files/file__southpark_jpg.h"
@@ -256,6 +261,276 @@ int test_plzma_encode_test3(void) {
     return 0;
 }
 
+static bool writeTestSourceFile(const Path & path, const std::string & content) {
+    FILE * file = path.openFile("wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = fwrite(content.c_str(), 1, content.size(), file) == content.size();
+    fclose(file);
+    return written;
+}
+
+static bool testSourceFileEquals(const Path & path, const std::string & content) {
+    FILE * file = path.openFile("rb");
+    if (!file) {
+        return false;
+    }
+    std::string readed(content.size() + 1, '\0');
+    const size_t size = fread(&readed[0], 1, readed.size(), file);
+    fclose(file);
+    return (size == content.size()) && (memcmp(readed.c_str(), content.c_str(), size) == 0);
+}
+
+int test_plzma_encode_mixed_sources(void) {
+    // sub-dir files, files and streams are resolved by the item index in a single archive
+    const size_t dirsCount = 3, dirFilesCount = 40, filesCount = 10, streamsCount = 10;
+    char name[64];
+    const auto rootPath = Path::tmpPath().appendingRandomComponent();
+    const auto srcPath = rootPath.appending("src");
+    const auto outPath = rootPath.appending("out");
+    PLZMA_TESTS_ASSERT(srcPath.createDir(true) == true)
+    
+    auto outStream = makeSharedOutStream();
+    auto encoder = makeSharedEncoder(outStream, plzma_file_type_7z, plzma_method_LZMA2);
+    encoder->setCompressionLevel(1);
+    for (size_t d = 0; d < dirsCount; d++) {
+        snprintf(name, sizeof(name), "d%u", static_cast<unsigned>(d));
+        const auto dirPath = srcPath.appending(name);
+        PLZMA_TESTS_ASSERT(dirPath.createDir(false) == true)
+        for (size_t f = 0; f < dirFilesCount; f++) {
+            snprintf(name, sizeof(name), "f%u.txt", static_cast<unsigned>(f));
+            const std::string content = std::string("dir ") + std::to_string(d) + " file " + std::to_string(f);
+            PLZMA_TESTS_ASSERT(writeTestSourceFile(dirPath.appending(name), content) == true)
+        }
+        encoder->add(dirPath);
+    }
+    for (size_t f = 0; f < filesCount; f++) {
+        snprintf(name, sizeof(name), "s%u.txt", static_cast<unsigned>(f));
+        const auto filePath = srcPath.appending(name);
+        PLZMA_TESTS_ASSERT(writeTestSourceFile(filePath, std::string("file ") + std::to_string(f)) == true)
+        encoder->add(filePath);
+    }
+    Vector<std::string> streamContents;
+    for (size_t s = 0; s < streamsCount; s++) {
+        snprintf(name, sizeof(name), "streams/m%u.txt", static_cast<unsigned>(s));
+        streamContents.push(std::string("stream ") + std::to_string(s) + std::string(s * 100, 'x'));
+        const std::string & content = streamContents.at(static_cast<plzma_size_t>(s));
+        encoder->add(makeSharedInStream(content.c_str(), content.size()), Path(name));
+    }
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    
+    auto archive = outStream->copyContent();
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->count() == dirsCount * dirFilesCount + filesCount + streamsCount)
+    PLZMA_TESTS_ASSERT(decoder->extract(outPath) == true)
+    for (size_t d = 0; d < dirsCount; d++) {
+        for (size_t f = 0; f < dirFilesCount; f++) {
+            snprintf(name, sizeof(name), "d%u/f%u.txt", static_cast<unsigned>(d), static_cast<unsigned>(f));
+            const std::string content = std::string("dir ") + std::to_string(d) + " file " + std::to_string(f);
+            PLZMA_TESTS_ASSERT(testSourceFileEquals(outPath.appending(name), content) == true)
+        }
+    }
+    for (size_t f = 0; f < filesCount; f++) {
+        snprintf(name, sizeof(name), "s%u.txt", static_cast<unsigned>(f));
+        PLZMA_TESTS_ASSERT(testSourceFileEquals(outPath.appending(name), std::string("file ") + std::to_string(f)) == true)
+    }
+    for (size_t s = 0; s < streamsCount; s++) {
+        snprintf(name, sizeof(name), "streams/m%u.txt", static_cast<unsigned>(s));
+        PLZMA_TESTS_ASSERT(testSourceFileEquals(outPath.appending(name), streamContents.at(static_cast<plzma_size_t>(s))) == true)
+    }
+    PLZMA_TESTS_ASSERT(rootPath.remove() == true)
+    return 0;
+}
+
+static std::string smartSolidTestWav(const unsigned seed) {
+    const uint32_t samplesCount = 64 * 1024, dataSize = samplesCount * 4; // 16 bit stereo
+    std::string wav(44 + dataSize, '\0');
+    uint8_t * p = reinterpret_cast<uint8_t *>(&wav[0]);
+    const uint32_t header[11] = { 0x46464952, 36 + dataSize, 0x45564157, 0x20746D66, 16, 0x00020001, 44100, 44100 * 4, 0x00100004, 0x61746164, dataSize };
+    for (size_t i = 0; i < 11; i++) {
+        for (size_t b = 0; b < 4; b++) {
+            p[i * 4 + b] = static_cast<uint8_t>(header[i] >> (b * 8));
+        }
+    }
+    uint32_t random = seed;
+    int32_t left = 0, right = 0;
+    for (uint32_t i = 0; i < samplesCount; i++) { // smooth random walk, the delta is small
+        random = random * 1103515245 + 12345;
+        left += static_cast<int32_t>((random >> 16) % 61) - 30;
+        right += static_cast<int32_t>((random >> 8) % 61) - 30;
+        uint8_t * sample = p + 44 + i * 4;
+        sample[0] = static_cast<uint8_t>(left); sample[1] = static_cast<uint8_t>(left >> 8);
+        sample[2] = static_cast<uint8_t>(right); sample[3] = static_cast<uint8_t>(right >> 8);
+    }
+    return wav;
+}
+
+static std::string smartSolidTestText(const unsigned seed) {
+    static const char * words[8] = { "encoder ", "archive ", "stream ", "solid ", "block ", "filter ", "item ", "path\n" };
+    std::string text;
+    uint32_t random = seed;
+    while (text.size() < 96 * 1024) {
+        random = random * 1103515245 + 12345;
+        text.append(words[(random >> 16) % 8]);
+    }
+    return text;
+}
+
+int test_plzma_encode_smart_solid(const char * executablePath) {
+    const auto rootPath = Path::tmpPath().appendingRandomComponent();
+    const auto srcPath = rootPath.appending("src");
+    PLZMA_TESTS_ASSERT(srcPath.createDir(true) == true)
+    
+    // the types are interleaved in the order of addition
+    Vector<Pair<Path, std::string> > files;
+    char name[64];
+    for (unsigned i = 0; i < 4; i++) {
+        snprintf(name, sizeof(name), "notes%u.txt", i);
+        files.push(Pair<Path, std::string>(Path(name), smartSolidTestText(i + 1)));
+        snprintf(name, sizeof(name), "sound%u.wav", i);
+        files.push(Pair<Path, std::string>(Path(name), smartSolidTestWav(i + 1)));
+    }
+    FILE * exe = executablePath ? fopen(executablePath, "rb") : nullptr; // the native executable, BCJ on x86
+    if (exe) {
+        std::string content;
+        char buffer[16 * 1024];
+        size_t readed;
+        while ( (readed = fread(buffer, 1, sizeof(buffer), exe)) > 0 && content.size() < 4 * 1024 * 1024) {
+            content.append(buffer, readed);
+        }
+        fclose(exe);
+        files.push(Pair<Path, std::string>(Path("tool"), static_cast<std::string &&>(content)));
+    }
+    for (plzma_size_t i = 0; i < files.count(); i++) {
+        PLZMA_TESTS_ASSERT(writeTestSourceFile(srcPath.appending(files.at(i).first), files.at(i).second) == true)
+    }
+    
+    uint64_t sizes[2] = { 0, 0 };
+    for (int smart = 0; smart < 2; smart++) {
+        auto outStream = makeSharedOutStream();
+        auto encoder = makeSharedEncoder(outStream, plzma_file_type_7z, plzma_method_LZMA2);
+        encoder->setCompressionLevel(6);
+        encoder->setShouldUseSmartSolid(smart ? true : false);
+        PLZMA_TESTS_ASSERT(encoder->shouldUseSmartSolid() == (smart ? true : false))
+        encoder->add(srcPath);
+        const auto start = std::chrono::steady_clock::now();
+        PLZMA_TESTS_ASSERT(encoder->open() == true)
+        PLZMA_TESTS_ASSERT(encoder->compress() == true)
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        auto archive = outStream->copyContent();
+        sizes[smart] = archive.second;
+        std::cout << (smart ? "Smart solid: " : "Solid: ") << archive.second << " bytes, " << ms << " ms" << std::endl;
+        
+        const auto outPath = rootPath.appending(smart ? "smart" : "solid");
+        auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_7z);
+        PLZMA_TESTS_ASSERT(decoder->open() == true)
+        PLZMA_TESTS_ASSERT(decoder->count() == files.count())
+        PLZMA_TESTS_ASSERT(outPath.createDir(false) == true)
+        PLZMA_TESTS_ASSERT(decoder->extract(outPath, false) == true)
+        for (plzma_size_t i = 0; i < files.count(); i++) {
+            PLZMA_TESTS_ASSERT(testSourceFileEquals(outPath.appending(files.at(i).first), files.at(i).second) == true)
+        }
+    }
+    PLZMA_TESTS_ASSERT(sizes[1] < sizes[0])
+    PLZMA_TESTS_ASSERT(rootPath.remove() == true)
+    return 0;
+}
+
+static UInt32 test_plzma_encode_7z_folders_count(const RawHeapMemorySize & archive) {
+    auto stream = makeSharedInStream(static_cast<const void *>(archive.first), archive.second).cast<InStreamBase>();
+    auto inArchive = BaseCallback::createArchive<IInArchive>(plzma_file_type_7z);
+    stream->open();
+    const UInt64 maxCheckStartPosition = 1 << 22;
+    if (!inArchive || inArchive->Open(stream.get(), &maxCheckStartPosition, nullptr) != S_OK) {
+        return 0;
+    }
+    NWindows::NCOM::CPropVariant prop;
+    const HRESULT res = inArchive->GetArchiveProperty(kpidNumBlocks, &prop);
+    inArchive->Close();
+    stream->close();
+    return (res == S_OK && prop.vt == VT_UI4) ? prop.ulVal : 0;
+}
+
+int test_plzma_encode_solid_blocks(void) {
+    const unsigned filesCount = 40, fileSize = 64 * 1024;
+    Vector<std::string> contents;
+    for (unsigned i = 0; i < filesCount; i++) {
+        contents.push(smartSolidTestText(i + 1).substr(0, fileSize));
+    }
+    
+    struct Limits {
+        uint64_t size;
+        uint32_t files;
+        bool solid;
+        UInt32 expectedFolders;
+    };
+    const Limits limits[5] = {
+        { 0, 0, true, 1 },                     // single solid block
+        { 0, 10, true, 4 },                    // 10 files per block
+        { 4 * fileSize, 0, true, 10 },         // 4 files of 64KB per block
+        { 4 * fileSize, 3, true, 14 },         // the files limit is reached first
+        { 4 * fileSize, 10, false, filesCount }// not solid, the limits are ignored
+    };
+    for (size_t i = 0; i < 5; i++) {
+        auto outStream = makeSharedOutStream();
+        auto encoder = makeSharedEncoder(outStream, plzma_file_type_7z, plzma_method_LZMA2);
+        encoder->setCompressionLevel(1);
+        encoder->setShouldCreateSolidArchive(limits[i].solid);
+        encoder->setSolidBlockSize(limits[i].size);
+        encoder->setSolidBlockFileCount(limits[i].files);
+        PLZMA_TESTS_ASSERT(encoder->solidBlockSize() == limits[i].size)
+        PLZMA_TESTS_ASSERT(encoder->solidBlockFileCount() == limits[i].files)
+        char name[32];
+        for (unsigned f = 0; f < filesCount; f++) {
+            snprintf(name, sizeof(name), "f%02u.txt", f);
+            const std::string & content = contents.at(f);
+            encoder->add(makeSharedInStream(content.c_str(), content.size()), Path(name));
+        }
+        PLZMA_TESTS_ASSERT(encoder->open() == true)
+        PLZMA_TESTS_ASSERT(encoder->compress() == true)
+        
+        auto archive = outStream->copyContent();
+        const UInt32 folders = test_plzma_encode_7z_folders_count(archive);
+        std::cout << "Solid block: " << limits[i].size << " bytes, " << limits[i].files << " files, solid: " << limits[i].solid <<
+        " -> " << folders << " folders, " << archive.second << " bytes" << std::endl;
+        PLZMA_TESTS_ASSERT(folders == limits[i].expectedFolders)
+        
+        auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_7z);
+        PLZMA_TESTS_ASSERT(decoder->open() == true)
+        PLZMA_TESTS_ASSERT(decoder->count() == filesCount)
+        auto items = makeShared<ItemOutStreamArray>();
+        for (plzma_size_t f = 0; f < filesCount; f++) {
+            items->push(Pair<SharedPtr<Item>, SharedPtr<OutStream> >(decoder->itemAt(f), makeSharedOutStream()));
+        }
+        PLZMA_TESTS_ASSERT(decoder->extract(items) == true)
+        for (plzma_size_t f = 0; f < filesCount; f++) {
+            const auto & pair = items->at(f);
+            const std::string & content = contents.at(static_cast<plzma_size_t>(pair.first->index()));
+            const auto extracted = pair.second->copyContent();
+            PLZMA_TESTS_ASSERT(extracted.second == content.size())
+            PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(extracted.first), content.c_str(), content.size()) == 0)
+        }
+    }
+    
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+    plzma_out_stream stream = plzma_out_stream_create_memory_stream();
+    plzma_encoder encoder = plzma_encoder_create(&stream, plzma_file_type_7z, plzma_method_LZMA2, plzma_context{nullptr, nullptr});
+    PLZMA_TESTS_ASSERT(encoder.exception == nullptr)
+    PLZMA_TESTS_ASSERT(plzma_encoder_solid_block_size(&encoder) == 0)
+    PLZMA_TESTS_ASSERT(plzma_encoder_solid_block_file_count(&encoder) == 0)
+    plzma_encoder_set_solid_block_size(&encoder, 1 << 20);
+    plzma_encoder_set_solid_block_file_count(&encoder, 100);
+    PLZMA_TESTS_ASSERT(plzma_encoder_solid_block_size(&encoder) == (1 << 20))
+    PLZMA_TESTS_ASSERT(plzma_encoder_solid_block_file_count(&encoder) == 100)
+    plzma_out_stream_release(&stream);
+    plzma_encoder_release(&encoder);
+#endif // !LIBPLZMA_NO_C_BINDINGS
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << plzma_version();
     int ret = 0;
@@ -276,6 +551,18 @@ int main(int argc, char* argv[]) {
         if ( (ret = test_plzma_encode_example()) ) {
             return ret;
         }
+        
+        if ( (ret = test_plzma_encode_mixed_sources()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_encode_smart_solid((argc > 0) ? argv[0] : nullptr)) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_encode_solid_blocks()) ) {
+            return ret;
+        }
     } catch (const Exception & e) {
         std::cout << "PLZMA Exception [" << e.code() << "]:" << std::endl;
         if (e.what()) {
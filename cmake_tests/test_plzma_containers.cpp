@@ -25,6 +25,8 @@
 //
 
 
+#include <chrono>
+
 #include "plzma_public_tests.hpp"
 
 using namespace plzma;
@@ -252,6 +254,74 @@ int test_plzma_containers_test6(void) {
     return 0;
 }
 
+// Counts the alive instances to check the construction and destruction of the vector elements.
+struct TestVectorElement {
+    static int alive;
+    int value;
+    
+    TestVectorElement(const int v = 0) : value(v) { alive++; }
+    TestVectorElement(const int a, const int b) : value(a * b) { alive++; }
+    TestVectorElement(const TestVectorElement & element) : value(element.value) { alive++; }
+    TestVectorElement(TestVectorElement && element) noexcept : value(element.value) { element.value = -1; alive++; }
+    ~TestVectorElement() { alive--; }
+};
+
+int TestVectorElement::alive = 0;
+
+int test_plzma_containers_vector(void) {
+    {
+        Vector<TestVectorElement> vector;
+        PLZMA_TESTS_ASSERT(vector.count() == 0 && vector.capacity() == 0)
+        vector.reserve(3);
+        PLZMA_TESTS_ASSERT(vector.capacity() == 3 && TestVectorElement::alive == 0) // uninitialized storage
+        for (int i = 0; i < 100; i++) {
+            if (i % 2) {
+                PLZMA_TESTS_ASSERT(vector.emplace(i, 1).value == i)
+            } else {
+                vector.push(TestVectorElement(i));
+            }
+        }
+        PLZMA_TESTS_ASSERT(vector.count() == 100 && TestVectorElement::alive == 100)
+        while (vector.count() < vector.capacity()) {
+            vector.emplace(static_cast<int>(vector.count()));
+        }
+        vector.push(vector.at(5)); // the element of the vector at full capacity
+        PLZMA_TESTS_ASSERT(vector.at(vector.count() - 1).value == 5)
+        vector.pop();
+        for (plzma_size_t i = 0; i < vector.count(); i++) {
+            PLZMA_TESTS_ASSERT(vector.at(i).value == static_cast<int>(i))
+        }
+        PLZMA_TESTS_ASSERT(TestVectorElement::alive == static_cast<int>(vector.count()))
+        
+        Vector<TestVectorElement> range(&vector.at(10), &vector.at(20));
+        PLZMA_TESTS_ASSERT(range.count() == 10 && range.at(0).value == 10 && range.at(9).value == 19)
+        vector = static_cast<Vector<TestVectorElement> &&>(range);
+        PLZMA_TESTS_ASSERT(vector.count() == 10 && range.count() == 0)
+        PLZMA_TESTS_ASSERT(TestVectorElement::alive == 10)
+    }
+    PLZMA_TESTS_ASSERT(TestVectorElement::alive == 0)
+    
+    // The number of reallocations while adding 1M items.
+    static const plzma_size_t itemsCount = 1000000;
+    auto items = makeShared<ItemArray>();
+    plzma_size_t reallocations = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (plzma_size_t i = 0; i < itemsCount; i++) {
+        const plzma_size_t capacity = items->capacity();
+        items->push(makeShared<Item>(Path(), i));
+        reallocations += (capacity != items->capacity()) ? 1 : 0;
+    }
+    const auto duration = std::chrono::steady_clock::now() - start;
+    std::cout << "push " << itemsCount << " items: " << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()
+              << " ms, " << reallocations << " reallocations" << std::endl;
+    PLZMA_TESTS_ASSERT(items->count() == itemsCount)
+    PLZMA_TESTS_ASSERT(reallocations < 40)
+    for (plzma_size_t i = 0; i < itemsCount; i += 997) {
+        PLZMA_TESTS_ASSERT(items->at(i)->index() == i)
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << plzma_version() << std::endl;
     int ret = 0;
@@ -280,6 +350,10 @@ int main(int argc, char* argv[]) {
         return ret;
     }
     
+    if ( (ret = test_plzma_containers_vector()) ) {
+        return ret;
+    }
+    
 //    while (1) {
 //        usleep(50);
 //    }
@@ -217,6 +217,95 @@ int test_plzma_extract_test_settings(void) {
     return 0;
 }
 
+class TestBusyProgressDelegate : public ProgressDelegate {
+public:
+    Decoder * decoder = nullptr;
+    bool didCatchBusyException = false;
+    
+    virtual void onProgress(void * LIBPLZMA_NULLABLE context, const String & path, const double progress) override final {
+        if (decoder && !didCatchBusyException) {
+            try {
+                decoder->testMatching("*");
+            } catch (const Exception & exception) {
+                didCatchBusyException = (exception.code() == plzma_error_code_invalid_arguments);
+            }
+        }
+    }
+    virtual ~TestBusyProgressDelegate() { }
+};
+
+int test_plzma_extract_matching(void) {
+    static const char * itemPaths[] = {
+        "assets/textures/a.png",
+        "assets/textures/b/c.json",
+        "assets/sounds/d.json",
+        "assets/textures.json",
+        "readme.txt"
+    };
+    const char * content = "The content of the test item.";
+    auto outStream = makeSharedOutStream();
+    auto encoder = makeSharedEncoder(outStream, plzma_file_type_7z, plzma_method_LZMA2);
+    for (size_t i = 0; i < 5; i++) {
+        encoder->add(makeSharedInStream(content, strlen(content)), Path(itemPaths[i]));
+    }
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    
+    const auto archive = outStream->copyContent();
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(decoder->extractMatching("*", Path::tmpPath()) == false) // not opened
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->testMatching("*.json") == true)
+    
+    const auto tmpPath = Path::tmpPath().appendingRandomComponent();
+    PLZMA_TESTS_ASSERT(decoder->extractMatching("assets/textures/", tmpPath.appending("1")) == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("1/assets/textures/a.png").exists() == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("1/assets/textures/b/c.json").exists() == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("1/assets/textures.json").exists() == false)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("1/assets/sounds").exists() == false)
+    
+    PLZMA_TESTS_ASSERT(decoder->extractMatching("*.json", tmpPath.appending("2")) == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("2/assets/textures/b/c.json").exists() == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("2/assets/sounds/d.json").exists() == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("2/assets/textures.json").exists() == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("2/assets/textures/a.png").exists() == false)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("2/readme.txt").exists() == false)
+    
+    PLZMA_TESTS_ASSERT(tmpPath.appending("3").createDir(true) == true)
+    PLZMA_TESTS_ASSERT(decoder->extractMatching("assets/?ounds", tmpPath.appending("3"), false) == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("3/d.json").exists() == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("3/a.png").exists() == false)
+    
+    PLZMA_TESTS_ASSERT(decoder->extractMatching("no/such/*", tmpPath.appending("4")) == true)
+    PLZMA_TESTS_ASSERT(tmpPath.appending("4").exists() == false)
+    
+#if !defined(LIBPLZMA_NO_PROGRESS)
+    // selecting while testing is not a 'no match' result
+    TestBusyProgressDelegate busyDelegate;
+    busyDelegate.decoder = decoder.get();
+    decoder->setProgressDelegate(&busyDelegate);
+    PLZMA_TESTS_ASSERT(decoder->test() == true)
+    decoder->setProgressDelegate(nullptr);
+    PLZMA_TESTS_ASSERT(busyDelegate.didCatchBusyException == true)
+#endif
+    
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+    plzma_in_stream cStream = plzma_in_stream_create_with_memory_copy(static_cast<const void *>(archive.first), archive.second);
+    plzma_decoder cDecoder = plzma_decoder_create(&cStream, plzma_file_type_7z, plzma_context{nullptr, nullptr});
+    plzma_in_stream_release(&cStream);
+    PLZMA_TESTS_ASSERT(plzma_decoder_open(&cDecoder) == true)
+    plzma_path cPath = plzma_path_create_with_utf8_string(tmpPath.appending("5").utf8());
+    PLZMA_TESTS_ASSERT(plzma_decoder_extract_matching_items_to_path(&cDecoder, "readme.*", &cPath, true) == true)
+    PLZMA_TESTS_ASSERT(plzma_decoder_test_matching_items(&cDecoder, "readme.txt") == true)
+    PLZMA_TESTS_ASSERT(cDecoder.exception == nullptr)
+    plzma_path_release(&cPath);
+    plzma_decoder_release(&cDecoder);
+    PLZMA_TESTS_ASSERT(tmpPath.appending("5/readme.txt").exists() == true)
+#endif
+    PLZMA_TESTS_ASSERT(tmpPath.remove() == true)
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     int ret = 0;
     try {
@@ -245,6 +334,10 @@ int main(int argc, char* argv[]) {
         if ( (ret = test_plzma_extract_test1()) ) {
             return ret;
         }
+        
+        if ( (ret = test_plzma_extract_matching()) ) {
+            return ret;
+        }
     } catch (const Exception & e) {
         std::cout << "PLZMA Exception [" << e.code() << "]:" << std::endl;
         if (e.what()) {
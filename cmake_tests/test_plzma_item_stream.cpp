@@ -0,0 +1,316 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "plzma_public_tests.hpp"
+
+using namespace plzma;
+
+static const size_t kTestItemsCount = 3;
+
+static size_t testItemSize(const size_t index) {
+    return 1536 * 1024 * (index + 1); // larger than the item stream buffer
+}
+
+static RawHeapMemory createTestContent(const size_t size, uint32_t seed) {
+    RawHeapMemory content(size);
+    uint8_t * ptr = static_cast<uint8_t *>(content);
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1664525 + 1013904223;
+        ptr[i] = ((seed >> 24) < 64) ? static_cast<uint8_t>(seed >> 16) : static_cast<uint8_t>('a' + (i % 26));
+    }
+    return content;
+}
+
+static RawHeapMemorySize encodeTestContent(const plzma_file_type type, RawHeapMemory * contents, const uint64_t blockSize = 0) {
+    auto outStream = makeSharedOutStream();
+    auto encoder = makeSharedEncoder(outStream, type, plzma_method_LZMA2);
+    encoder->setCompressionLevel(1);
+    encoder->setBlockSize(blockSize);
+    const size_t itemsCount = (type == plzma_file_type_xz) ? 1 : kTestItemsCount;
+    for (size_t i = 0; i < itemsCount; i++) {
+        char name[16];
+        snprintf(name, 16, "item%u.txt", static_cast<unsigned>(i));
+        const size_t size = testItemSize(i);
+        contents[i] = createTestContent(size, static_cast<uint32_t>(i + 1));
+        encoder->add(makeSharedInStream(static_cast<const void *>(contents[i]), size), Path(name));
+    }
+    if (!encoder->open() || !encoder->compress()) {
+        return RawHeapMemorySize(RawHeapMemory(), 0);
+    }
+    return outStream->takeContent();
+}
+
+static int readItemStream(SharedPtr<ItemStream> & stream, const RawHeapMemory & content, const size_t contentSize) {
+    PLZMA_TESTS_ASSERT(stream)
+    RawHeapMemory buffer(64 * 1024 + 7);
+    size_t offset = 0, readSize = 0;
+    while ( (readSize = stream->read(static_cast<void *>(buffer), 64 * 1024 + 7)) > 0 ) {
+        PLZMA_TESTS_ASSERT(offset + readSize <= contentSize)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(buffer), static_cast<const uint8_t *>(content) + offset, readSize) == 0)
+        offset += readSize;
+    }
+    PLZMA_TESTS_ASSERT(offset == contentSize)
+    PLZMA_TESTS_ASSERT(stream->read(static_cast<void *>(buffer), 1) == 0)
+    return 0;
+}
+
+static int test_plzma_item_stream_decoder(SharedPtr<Decoder> & decoder, const RawHeapMemory * contents, const size_t itemsCount) {
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->count() == itemsCount)
+    int ret = 0;
+    for (plzma_size_t i = itemsCount; i > 0; i--) { // backward, each stream decodes own solid block
+        auto item = decoder->itemAt(i - 1);
+        auto stream = decoder->openItemStream(item);
+        PLZMA_TESTS_ASSERT(stream->item()->index() == item->index())
+        if ( (ret = readItemStream(stream, contents[i - 1], testItemSize(i - 1))) ) {
+            return ret;
+        }
+    }
+    
+    // Close before the end of the content.
+    auto stream = decoder->openItemStream(decoder->itemAt(0));
+    uint8_t buffer[1024];
+    PLZMA_TESTS_ASSERT(stream->read(buffer, 1024) > 0)
+    stream->close();
+    PLZMA_TESTS_ASSERT(stream->read(buffer, 1024) == 0)
+    stream.clear();
+    
+    // The decoder is still usable.
+    stream = decoder->openItemStream(decoder->itemAt(0));
+    stream.clear();
+    PLZMA_TESTS_ASSERT(decoder->test() == true)
+    return 0;
+}
+
+int test_plzma_item_stream_test1(void) {
+    RawHeapMemory contents[kTestItemsCount];
+    auto archive = encodeTestContent(plzma_file_type_7z, contents);
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_7z);
+    return test_plzma_item_stream_decoder(decoder, contents, kTestItemsCount);
+}
+
+int test_plzma_item_stream_test2(void) {
+    RawHeapMemory contents[1];
+    auto archive = encodeTestContent(plzma_file_type_xz, contents);
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_xz);
+    return test_plzma_item_stream_decoder(decoder, contents, 1);
+}
+
+struct TestCallbackStream {
+    const uint8_t * memory;
+    uint64_t size;
+    uint64_t offset;
+};
+
+static bool testCallbackOpen(void * context) {
+    static_cast<TestCallbackStream *>(context)->offset = 0;
+    return true;
+}
+
+static void testCallbackClose(void * context) {
+    
+}
+
+static bool testCallbackSeek(void * context, int64_t offset, uint32_t seekOrigin, uint64_t * newPosition) {
+    TestCallbackStream * stream = static_cast<TestCallbackStream *>(context);
+    const int64_t base = (seekOrigin == 0) ? 0 : ((seekOrigin == 1) ? static_cast<int64_t>(stream->offset) : static_cast<int64_t>(stream->size));
+    if (base + offset < 0 || base + offset > static_cast<int64_t>(stream->size)) {
+        return false;
+    }
+    *newPosition = stream->offset = static_cast<uint64_t>(base + offset);
+    return true;
+}
+
+static bool testCallbackRead(void * context, void * data, uint32_t size, uint32_t * processedSize) {
+    TestCallbackStream * stream = static_cast<TestCallbackStream *>(context);
+    const uint64_t available = stream->size - stream->offset;
+    const uint32_t sizeToRead = (size < available) ? size : static_cast<uint32_t>(available);
+    memcpy(data, stream->memory + stream->offset, sizeToRead);
+    stream->offset += sizeToRead;
+    *processedSize = sizeToRead;
+    return true;
+}
+
+int test_plzma_item_stream_test3(void) {
+    RawHeapMemory contents[kTestItemsCount];
+    auto archive = encodeTestContent(plzma_file_type_7z, contents);
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    TestCallbackStream callbackStream;
+    callbackStream.memory = static_cast<const uint8_t *>(archive.first);
+    callbackStream.size = archive.second;
+    callbackStream.offset = 0;
+    plzma_context context;
+    context.context = &callbackStream;
+    context.deinitializer = nullptr;
+    auto stream = makeSharedInStream(testCallbackOpen, testCallbackClose, testCallbackSeek, testCallbackRead, context);
+    auto decoder = makeSharedDecoder(stream, plzma_file_type_7z); // not clonable -> extracted to memory
+    return test_plzma_item_stream_decoder(decoder, contents, kTestItemsCount);
+}
+
+int test_plzma_item_stream_checkpoints(void) {
+    RawHeapMemory contents[kTestItemsCount];
+    auto archive = encodeTestContent(plzma_file_type_7z, contents, 1024 * 1024);
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(decoder->buildCheckpoints() == 0) // not opened
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    const plzma_size_t checkpoints = decoder->buildCheckpoints();
+    PLZMA_TESTS_ASSERT(checkpoints == 8) // 9MB solid folder of 1MB blocks
+    PLZMA_TESTS_ASSERT(decoder->buildCheckpoints() == checkpoints)
+    int ret = 0;
+    if ( (ret = test_plzma_item_stream_decoder(decoder, contents, kTestItemsCount)) ) {
+        return ret;
+    }
+    
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+    plzma_in_stream cStream = plzma_in_stream_create_with_memory_copy(static_cast<const void *>(archive.first), archive.second);
+    plzma_decoder cDecoder = plzma_decoder_create(&cStream, plzma_file_type_7z, plzma_context{nullptr, nullptr});
+    plzma_in_stream_release(&cStream);
+    PLZMA_TESTS_ASSERT(plzma_decoder_open(&cDecoder) == true)
+    PLZMA_TESTS_ASSERT(plzma_decoder_build_checkpoints(&cDecoder) == checkpoints)
+    PLZMA_TESTS_ASSERT(cDecoder.exception == nullptr)
+    plzma_decoder_release(&cDecoder);
+#endif
+    return 0;
+}
+
+int test_plzma_item_stream_random_access(void) {
+    RawHeapMemory contents[kTestItemsCount];
+    auto archive = encodeTestContent(plzma_file_type_xz, contents, 256 * 1024);
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    const size_t contentSize = testItemSize(0);
+    const uint8_t * content = static_cast<const uint8_t *>(contents[0]);
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_xz);
+    PLZMA_TESTS_ASSERT(!decoder->openRandomAccessStream()) // not opened
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    auto stream = decoder->openRandomAccessStream();
+    PLZMA_TESTS_ASSERT(stream)
+    PLZMA_TESTS_ASSERT(stream->size() == contentSize)
+    
+    RawHeapMemory buffer(300 * 1024);
+    const size_t offsets[] = { 1000 * 1024, 7, 255 * 1024, contentSize - 100, 600 * 1024 + 3, 0 }; // across the 256KB blocks
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        const size_t expected = std::min(static_cast<size_t>(300 * 1024), contentSize - offsets[i]);
+        PLZMA_TESTS_ASSERT(stream->pread(static_cast<void *>(buffer), 300 * 1024, offsets[i]) == expected)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(buffer), content + offsets[i], expected) == 0)
+    }
+    PLZMA_TESTS_ASSERT(stream->pread(static_cast<void *>(buffer), 1, contentSize) == 0)
+    PLZMA_TESTS_ASSERT(stream->position() == 0)
+    
+    stream->seek(contentSize / 2);
+    size_t offset = contentSize / 2, readSize = 0;
+    while ( (readSize = stream->read(static_cast<void *>(buffer), 64 * 1024 + 7)) > 0 ) {
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(buffer), content + offset, readSize) == 0)
+        offset += readSize;
+    }
+    PLZMA_TESTS_ASSERT(offset == contentSize)
+    PLZMA_TESTS_ASSERT(stream->position() == contentSize)
+    stream->close();
+    PLZMA_TESTS_ASSERT(stream->pread(static_cast<void *>(buffer), 1, 0) == 0)
+    
+    bool thrown = false;
+    RawHeapMemory contents7z[kTestItemsCount];
+    auto archive7z = encodeTestContent(plzma_file_type_7z, contents7z);
+    auto decoder7z = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive7z.first), archive7z.second), plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(decoder7z->open() == true)
+    try {
+        decoder7z->openRandomAccessStream();
+    } catch (const Exception & e) {
+        thrown = e.code() == plzma_error_code_invalid_arguments;
+    }
+    PLZMA_TESTS_ASSERT(thrown)
+    
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+    plzma_in_stream cStream = plzma_in_stream_create_with_memory_copy(static_cast<const void *>(archive.first), archive.second);
+    plzma_decoder cDecoder = plzma_decoder_create(&cStream, plzma_file_type_xz, plzma_context{nullptr, nullptr});
+    plzma_in_stream_release(&cStream);
+    PLZMA_TESTS_ASSERT(plzma_decoder_open(&cDecoder) == true)
+    plzma_random_access_stream cRandomAccessStream = plzma_decoder_open_random_access_stream(&cDecoder);
+    PLZMA_TESTS_ASSERT(cRandomAccessStream.exception == nullptr && cRandomAccessStream.object != nullptr)
+    PLZMA_TESTS_ASSERT(plzma_random_access_stream_size(&cRandomAccessStream) == contentSize)
+    plzma_random_access_stream_seek(&cRandomAccessStream, 513 * 1024);
+    PLZMA_TESTS_ASSERT(plzma_random_access_stream_read(&cRandomAccessStream, static_cast<void *>(buffer), 1024) == 1024)
+    PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(buffer), content + 513 * 1024, 1024) == 0)
+    PLZMA_TESTS_ASSERT(plzma_random_access_stream_position(&cRandomAccessStream) == 514 * 1024)
+    PLZMA_TESTS_ASSERT(cRandomAccessStream.exception == nullptr)
+    plzma_random_access_stream_release(&cRandomAccessStream);
+    plzma_decoder_release(&cDecoder);
+#endif
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << plzma_version() << std::endl;
+    int ret = 0;
+    
+    try {
+        if ( (ret = test_plzma_item_stream_test1()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_item_stream_test2()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_item_stream_test3()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_item_stream_checkpoints()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_item_stream_random_access()) ) {
+            return ret;
+        }
+    } catch (const Exception & e) {
+        std::cout << "PLZMA Exception [" << e.code() << "]:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        if (e.reason()) {
+            std::cout << "reason: " << e.reason() << std::endl;
+        }
+        if (e.file()) {
+            std::cout << "file: " << e.file() << std::endl;
+        }
+        std::cout << "line: " << e.line() << std::endl;
+        throw;
+    } catch (const std::exception & e) {
+        std::cout << "std exception:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        throw;
+    } catch (...) {
+        std::cout << "unknown exception:" << std::endl;
+        throw;
+    }
+    
+    return ret;
+}
@@ -0,0 +1,341 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <chrono>
+#include <thread>
+
+#include "plzma_public_tests.hpp"
+
+// archives
+#include "../test_files/file__1_7z.h"
+#include "../test_files/file__2_7z.h"
+#include "../test_files/file__3_7z.h"
+#include "../test_files/file__4_7z.h"
+#include "../test_files/file__5_7z.h"
+#include "../test_files/file__6_7z.h"
+#include "../test_files/file__7_7z.h"
+#include "../test_files/file__8_7z.h"
+#include "../test_files/file__9_7z.h"
+#include "../test_files/file__10_7z.h"
+#include "../test_files/file__11_7z.h"
+#include "../test_files/file__12_7z.h"
+#include "../test_files/file__13_7z.h"
+#include "../test_files/file__14_7z.h"
+#include "../test_files/file__15_tar.h"
+#include "../test_files/file__16_tar_xz.h"
+#include "../test_files/file__17_jpg_xz.h"
+
+// images
+#include "../test_files/file__munchen_jpg.h"
+#include "../test_files/file__shutuptakemoney_jpg.h"
+#include "../test_files/file__southpark_jpg.h"
+#include "../test_files/file__zombies_jpg.h"
+
+using namespace plzma;
+
+static void dummy_free_callback(void * LIBPLZMA_NULLABLE p) {
+    // do nothing
+}
+
+static const size_t kTestContentSize = 3 * 1024 * 1024;
+
+static RawHeapMemory createTestContent(const size_t size, uint32_t seed) {
+    static const char * words[] = { "lorem ", "ipsum ", "dolor ", "sit ", "amet, ", "consectetur ", "adipiscing ", "elit. " };
+    RawHeapMemory content(size);
+    uint8_t * ptr = static_cast<uint8_t *>(content);
+    size_t offset = 0;
+    while (offset < size) {
+        seed = seed * 1664525 + 1013904223;
+        if ((seed >> 24) < 32) { // ~12% of random bytes
+            ptr[offset++] = static_cast<uint8_t>(seed >> 16);
+            continue;
+        }
+        const char * word = words[(seed >> 16) % 8];
+        while (*word && offset < size) {
+            ptr[offset++] = static_cast<uint8_t>(*word++);
+        }
+    }
+    return content;
+}
+
+static double millisecondsSince(const std::chrono::steady_clock::time_point & start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static uint32_t testNumberOfThreads(void) {
+    const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    return (hardwareThreads > 1) ? static_cast<uint32_t>(hardwareThreads) : 2;
+}
+
+static int encodeTestContents(const plzma_file_type type,
+                              const uint32_t numberOfThreads,
+                              const RawHeapMemory * contents,
+                              const size_t itemsCount,
+                              RawHeapMemorySize & archive,
+                              double & encodeTime) {
+    auto outStream = makeSharedOutStream();
+    auto encoder = makeSharedEncoder(outStream, type, plzma_method_LZMA2);
+    encoder->setCompressionLevel(1);
+    PLZMA_TESTS_ASSERT(encoder->numberOfThreads() == 0)
+    encoder->setNumberOfThreads(numberOfThreads);
+    PLZMA_TESTS_ASSERT(encoder->numberOfThreads() == numberOfThreads)
+    for (size_t i = 0; i < itemsCount; i++) {
+        char name[16];
+        snprintf(name, 16, "item%u.txt", static_cast<unsigned>(i));
+        encoder->add(makeSharedInStream(static_cast<const void *>(contents[i]), kTestContentSize), Path(name));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    encodeTime = millisecondsSince(start);
+
+    archive = outStream->copyContent();
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    PLZMA_TESTS_ASSERT(archive.second < kTestContentSize * itemsCount)
+    return 0;
+}
+
+static int decodeTestContents(const plzma_file_type type,
+                              const uint32_t numberOfThreads,
+                              const RawHeapMemorySize & archive,
+                              const RawHeapMemory * contents,
+                              const size_t itemsCount,
+                              double & decodeTime) {
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), type);
+    PLZMA_TESTS_ASSERT(decoder->numberOfThreads() == 0)
+    PLZMA_TESTS_ASSERT(decoder->memoryLimit() == 0)
+    decoder->setNumberOfThreads(numberOfThreads);
+    decoder->setMemoryLimit(static_cast<uint64_t>(256) * 1024 * 1024);
+    PLZMA_TESTS_ASSERT(decoder->numberOfThreads() == numberOfThreads)
+    PLZMA_TESTS_ASSERT(decoder->memoryLimit() == static_cast<uint64_t>(256) * 1024 * 1024)
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->count() == itemsCount)
+
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    for (plzma_size_t i = 0; i < decoder->count(); i++) {
+        itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(i), makeSharedOutStream()));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    decodeTime = millisecondsSince(start);
+
+    for (plzma_size_t i = 0; i < itemsStreams->count(); i++) {
+        const auto & pair = itemsStreams->at(i);
+        const auto content = pair.second->copyContent();
+        PLZMA_TESTS_ASSERT(content.second == kTestContentSize)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(content.first), static_cast<const void *>(contents[pair.first->index()]), kTestContentSize) == 0)
+    }
+    return 0;
+}
+
+static int test_plzma_multithread_roundtrip(const plzma_file_type type) {
+    const char * typeName = (type == plzma_file_type_7z) ? "7z" : "xz";
+    const size_t itemsCount = (type == plzma_file_type_7z) ? 3 : 1;
+    const uint32_t numberOfThreads = testNumberOfThreads();
+    RawHeapMemory contents[3];
+    for (size_t i = 0; i < itemsCount; i++) {
+        contents[i] = createTestContent(kTestContentSize, static_cast<uint32_t>(i + 1));
+    }
+
+    RawHeapMemorySize singleArchive, multiArchive;
+    double singleEncodeTime = 0, multiEncodeTime = 0;
+    PLZMA_TESTS_ASSERT(encodeTestContents(type, 1, contents, itemsCount, singleArchive, singleEncodeTime) == 0)
+    PLZMA_TESTS_ASSERT(encodeTestContents(type, numberOfThreads, contents, itemsCount, multiArchive, multiEncodeTime) == 0)
+
+    // each archive is decoded by the single- and the multithreaded decoders
+    double decodeTimes[4] = { 0, 0, 0, 0 };
+    PLZMA_TESTS_ASSERT(decodeTestContents(type, 1, singleArchive, contents, itemsCount, decodeTimes[0]) == 0)
+    PLZMA_TESTS_ASSERT(decodeTestContents(type, numberOfThreads, singleArchive, contents, itemsCount, decodeTimes[1]) == 0)
+    PLZMA_TESTS_ASSERT(decodeTestContents(type, 1, multiArchive, contents, itemsCount, decodeTimes[2]) == 0)
+    PLZMA_TESTS_ASSERT(decodeTestContents(type, numberOfThreads, multiArchive, contents, itemsCount, decodeTimes[3]) == 0)
+
+#if defined(LIBPLZMA_MULTITHREAD)
+    std::cout << "Multithreaded coders, ";
+#else
+    std::cout << "Single-threaded coders, ";
+#endif
+    std::cout << typeName << ": " << (kTestContentSize * itemsCount) << " -> " << singleArchive.second << " bytes with 1 thread, "
+              << multiArchive.second << " bytes with " << numberOfThreads << " threads" << std::endl;
+    std::cout << "Benchmark multithread_encode_" << typeName << ": 1 thread " << singleEncodeTime << " ms, "
+              << numberOfThreads << " threads " << multiEncodeTime << " ms, speedup " << (singleEncodeTime / multiEncodeTime) << std::endl;
+    std::cout << "Benchmark multithread_decode_" << typeName << ": 1 thread " << decodeTimes[2] << " ms, "
+              << numberOfThreads << " threads " << decodeTimes[3] << " ms, speedup " << (decodeTimes[2] / decodeTimes[3]) << std::endl;
+    return 0;
+}
+
+int test_plzma_multithread_7z(void) {
+    return test_plzma_multithread_roundtrip(plzma_file_type_7z);
+}
+
+int test_plzma_multithread_xz(void) {
+    return test_plzma_multithread_roundtrip(plzma_file_type_xz);
+}
+
+static bool bundledContentEquals(const SharedPtr<Item> & item, const RawHeapMemorySize & content, const size_t fileIndex) {
+    const void * expected = nullptr;
+    size_t expectedSize = 0;
+    if (fileIndex == 14) { // 16.tar.xz
+        expected = FILE__15_tar_PTR;
+        expectedSize = FILE__15_tar_SIZE;
+    } else if (fileIndex == 15) { // 17.jpg.xz
+        expected = FILE__shutuptakemoney_jpg_PTR;
+        expectedSize = FILE__shutuptakemoney_jpg_SIZE;
+    } else if (item->path() == "shutuptakemoney.jpg") {
+        expected = FILE__shutuptakemoney_jpg_PTR;
+        expectedSize = FILE__shutuptakemoney_jpg_SIZE;
+    } else if (item->path() == "SouthPark.jpg") {
+        expected = FILE__southpark_jpg_PTR;
+        expectedSize = FILE__southpark_jpg_SIZE;
+    } else if (item->path() == "zombies.jpg") {
+        expected = FILE__zombies_jpg_PTR;
+        expectedSize = FILE__zombies_jpg_SIZE;
+    } else if (item->path() == "Мюнхен.jpg" || item->path() == "München.jpg") {
+        expected = FILE__munchen_jpg_PTR;
+        expectedSize = FILE__munchen_jpg_SIZE;
+    } else {
+        std::cout << "Unexpected bundled item: " << item->path().utf8() << std::endl;
+        return false;
+    }
+    return (content.second == expectedSize) && (memcmp(static_cast<const void *>(content.first), expected, expectedSize) == 0);
+}
+
+// the single- and the multithreaded builds must decode the bundled archives to the same bundled originals
+static int test_plzma_multithread_test_files(const uint32_t numberOfThreads) {
+    const size_t filesCount = 16;
+    unsigned char * files[filesCount] = {
+        FILE__1_7z_PTR, FILE__2_7z_PTR, FILE__3_7z_PTR, FILE__4_7z_PTR, FILE__5_7z_PTR, FILE__6_7z_PTR, FILE__7_7z_PTR,
+        FILE__8_7z_PTR, FILE__9_7z_PTR, FILE__10_7z_PTR, FILE__11_7z_PTR, FILE__12_7z_PTR, FILE__13_7z_PTR, FILE__14_7z_PTR,
+        FILE__16_tar_xz_PTR, FILE__17_jpg_xz_PTR
+    };
+    const size_t fileSizes[filesCount] = {
+        FILE__1_7z_SIZE, FILE__2_7z_SIZE, FILE__3_7z_SIZE, FILE__4_7z_SIZE, FILE__5_7z_SIZE, FILE__6_7z_SIZE, FILE__7_7z_SIZE,
+        FILE__8_7z_SIZE, FILE__9_7z_SIZE, FILE__10_7z_SIZE, FILE__11_7z_SIZE, FILE__12_7z_SIZE, FILE__13_7z_SIZE, FILE__14_7z_SIZE,
+        FILE__16_tar_xz_SIZE, FILE__17_jpg_xz_SIZE
+    };
+    for (size_t fileIndex = 0; fileIndex < filesCount; fileIndex++) {
+        const plzma_file_type type = (fileIndex < 14) ? plzma_file_type_7z : plzma_file_type_xz;
+        auto decoder = makeSharedDecoder(makeSharedInStream(files[fileIndex], fileSizes[fileIndex], &dummy_free_callback), type);
+        decoder->setNumberOfThreads(numberOfThreads);
+#if defined(LIBPLZMA_NO_CRYPTO)
+        switch (fileIndex + 1) {
+            case 5: case 6: case 7: case 8: case 10: case 11: case 13: case 14: continue;
+            default: break;
+        }
+#else
+        if (type == plzma_file_type_7z) {
+            decoder->setPassword("1234");
+        }
+#endif
+        PLZMA_TESTS_ASSERT(decoder->open() == true)
+        PLZMA_TESTS_ASSERT(decoder->count() == ((type == plzma_file_type_7z) ? 5 : 1))
+
+        auto itemsStreams = makeShared<ItemOutStreamArray>();
+        for (plzma_size_t i = 0; i < decoder->count(); i++) {
+            itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(i), makeSharedOutStream()));
+        }
+        PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+        for (plzma_size_t i = 0; i < itemsStreams->count(); i++) {
+            const auto & pair = itemsStreams->at(i);
+            PLZMA_TESTS_ASSERT(bundledContentEquals(pair.first, pair.second->copyContent(), fileIndex) == true)
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << plzma_version() << std::endl;
+    int ret = 0;
+
+    try {
+        if ( (ret = test_plzma_multithread_7z()) ) {
+            return ret;
+        }
+
+        if ( (ret = test_plzma_multithread_xz()) ) {
+            return ret;
+        }
+
+        if ( (ret = test_plzma_multithread_test_files(1)) ) {
+            return ret;
+        }
+
+        if ( (ret = test_plzma_multithread_test_files(testNumberOfThreads())) ) {
+            return ret;
+        }
+    } catch (const Exception & e) {
+        std::cout << "PLZMA Exception [" << e.code() << "]:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        if (e.reason()) {
+            std::cout << "reason: " << e.reason() << std::endl;
+        }
+        if (e.file()) {
+            std::cout << "file: " << e.file() << std::endl;
+        }
+        std::cout << "line: " << e.line() << std::endl;
+        throw;
+    } catch (const std::exception & e) {
+        std::cout << "std exception:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        throw;
+    } catch (...) {
+        std::cout << "unknown exception:" << std::endl;
+        throw;
+    }
+
+    return ret;
+}
+
+// archives
+#include "../test_files/file__1_7z.h"
+#include "../test_files/file__2_7z.h"
+#include "../test_files/file__3_7z.h"
+#include "../test_files/file__4_7z.h"
+#include "../test_files/file__5_7z.h"
+#include "../test_files/file__6_7z.h"
+#include "../test_files/file__7_7z.h"
+#include "../test_files/file__8_7z.h"
+#include "../test_files/file__9_7z.h"
+#include "../test_files/file__10_7z.h"
+#include "../test_files/file__11_7z.h"
+#include "../test_files/file__12_7z.h"
+#include "../test_files/file__13_7z.h"
+#include "../test_files/file__14_7z.h"
+#include "../test_files/file__15_tar.h"
+#include "../test_files/file__16_tar_xz.h"
+#include "../test_files/file__17_jpg_xz.h"
+
+// images
+#include "../test_files/file__munchen_jpg.h"
+#include "../test_files/file__shutuptakemoney_jpg.h"
+#include "../test_files/file__southpark_jpg.h"
+#include "../test_files/file__zombies_jpg.h"
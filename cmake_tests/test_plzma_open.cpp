@@ -195,6 +195,42 @@ int test_plzma_open_1(void) {
         allItems = decoder->items();
         PLZMA_TESTS_ASSERT(allItems.get() != nullptr)
         PLZMA_TESTS_ASSERT(allItems->count() == 5)
+        
+        auto table = decoder->itemTable();
+        PLZMA_TESTS_ASSERT(table.get() != nullptr)
+        PLZMA_TESTS_ASSERT(table->count() == 5)
+        for (plzma_size_t itemIndex = 0; itemIndex < 5; itemIndex++) {
+            const auto & item = allItems->at(itemIndex);
+            size_t length = 0;
+            PLZMA_TESTS_ASSERT(strcmp(table->pathUtf8(itemIndex, &length), item->path().utf8()) == 0)
+            PLZMA_TESTS_ASSERT(length == strlen(item->path().utf8()))
+            if (itemsMustEqual(table->itemAt(itemIndex), item) != 0) {
+                return 1;
+            }
+        }
+        PLZMA_TESTS_ASSERT(table->itemAt(5).get() == nullptr)
+        PLZMA_TESTS_ASSERT(strcmp(table->pathUtf8(5), "") == 0)
+        
+        Path paths[3];
+        for (plzma_size_t itemIndex = 0; itemIndex < 5; itemIndex++) {
+            const auto & item = allItems->at(itemIndex);
+            const auto found = decoder->itemAtPath(item->path());
+            PLZMA_TESTS_ASSERT(found.get() != nullptr)
+            PLZMA_TESTS_ASSERT(found->index() == item->index())
+            if (itemsMustEqual(found, item) != 0) {
+                return 1;
+            }
+        }
+        PLZMA_TESTS_ASSERT(decoder->itemAtPath(Path("no/such/item")).get() == nullptr)
+        PLZMA_TESTS_ASSERT(decoder->itemAtPath(Path()).get() == nullptr)
+        paths[0] = allItems->at(4)->path();
+        paths[1] = Path("no/such/item");
+        paths[2] = allItems->at(1)->path();
+        auto selected = decoder->itemsAtPaths(paths, 3);
+        PLZMA_TESTS_ASSERT(selected.get() != nullptr)
+        PLZMA_TESTS_ASSERT(selected->count() == 2)
+        PLZMA_TESTS_ASSERT(selected->at(0)->index() == allItems->at(4)->index())
+        PLZMA_TESTS_ASSERT(selected->at(1)->index() == allItems->at(1)->index())
 
         for (plzma_size_t itemIndex = 0, n = decoder->count(); itemIndex < n; itemIndex++) {
             const auto item = decoder->itemAt(itemIndex);
@@ -392,6 +428,40 @@ int test_plzma_open_3(void) {
     thread.join();
     PLZMA_TESTS_ASSERT(opened == true)
     PLZMA_TESTS_ASSERT(plzma_decoder_count(&decoder) == 5)
+    plzma_item_table table = plzma_decoder_item_table(&decoder);
+    PLZMA_TESTS_ASSERT(table.exception == nullptr)
+    PLZMA_TESTS_ASSERT(plzma_item_table_count(&table) == 5)
+    for (plzma_size_t itemIndex = 0; itemIndex < 5; itemIndex++) {
+        plzma_item item = plzma_decoder_item_at(&decoder, itemIndex);
+        plzma_item tableItem = plzma_item_table_item_at(&table, itemIndex);
+        if (plzma_items_must_equal(&item, &tableItem) != 0) {
+            return 1;
+        }
+        PLZMA_TESTS_ASSERT(plzma_item_table_size(&table, itemIndex) == plzma_item_size(&item))
+        PLZMA_TESTS_ASSERT(plzma_item_table_path_utf8(&table, itemIndex, nullptr) != nullptr)
+        plzma_item_release(&item);
+        plzma_item_release(&tableItem);
+    }
+    plzma_item_table_release(&table);
+    plzma_path paths[2];
+    paths[0] = plzma_path_create_with_utf8_string("no/such/item");
+    plzma_item item = plzma_decoder_item_at(&decoder, 2);
+    paths[1] = plzma_item_path(&item);
+    plzma_item foundItem = plzma_decoder_item_at_path(&decoder, &paths[1]);
+    PLZMA_TESTS_ASSERT(foundItem.exception == nullptr)
+    PLZMA_TESTS_ASSERT(foundItem.object != nullptr)
+    PLZMA_TESTS_ASSERT(plzma_item_index(&foundItem) == 2)
+    plzma_item_release(&foundItem);
+    plzma_item_release(&item);
+    foundItem = plzma_decoder_item_at_path(&decoder, &paths[0]);
+    PLZMA_TESTS_ASSERT(foundItem.exception == nullptr)
+    PLZMA_TESTS_ASSERT(foundItem.object == nullptr)
+    plzma_item_array selected = plzma_decoder_items_at_paths(&decoder, paths, 2);
+    PLZMA_TESTS_ASSERT(selected.exception == nullptr)
+    PLZMA_TESTS_ASSERT(plzma_item_array_count(&selected) == 1)
+    plzma_item_array_release(&selected);
+    plzma_path_release(&paths[0]);
+    plzma_path_release(&paths[1]);
     plzma_in_stream_release(&stream);
     plzma_decoder_release(&decoder);
 #endif
@@ -494,6 +564,68 @@ int test_plzma_open_c_doc(void) {
     return 0;
 }
 
+static RawHeapMemory createBrokenHeaderArchive(const void * archive, const size_t size) {
+    RawHeapMemory copy(size);
+    memcpy(static_cast<void *>(copy), archive, size);
+    uint8_t * ptr = static_cast<uint8_t *>(copy);
+    uint64_t nextHeaderOffset = 0, nextHeaderSize = 0;
+    for (int i = 7; i >= 0; i--) {
+        nextHeaderOffset = (nextHeaderOffset << 8) | ptr[12 + i];
+        nextHeaderSize = (nextHeaderSize << 8) | ptr[20 + i];
+    }
+    memset(ptr + 32 + nextHeaderOffset, 0, static_cast<size_t>(nextHeaderSize)); // the signature header is untouched
+    return copy;
+}
+
+static bool openBrokenHeaderArchive(const RawHeapMemory & archive, const size_t size) {
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive), size), plzma_file_type_7z);
+    decoder->setPassword("1234");
+    bool opened = false;
+    try { opened = decoder->open(); } catch (...) { opened = false; }
+    if (opened) {
+        opened = (decoder->count() == 5) && decoder->test();
+    }
+    return opened;
+}
+
+int test_plzma_open_index_cache(void) {
+    PLZMA_TESTS_ASSERT(plzma_index_cache_capacity() == 0)
+    const auto broken = createBrokenHeaderArchive(FILE__2_7z_PTR, FILE__2_7z_SIZE);
+    PLZMA_TESTS_ASSERT(openBrokenHeaderArchive(broken, FILE__2_7z_SIZE) == false)
+    
+    plzma_set_index_cache_capacity(2);
+    PLZMA_TESTS_ASSERT(plzma_index_cache_capacity() == 2)
+    PLZMA_TESTS_ASSERT(openBrokenHeaderArchive(broken, FILE__2_7z_SIZE) == false)
+    
+    auto decoder = makeSharedDecoder(makeSharedInStream(FILE__2_7z_PTR, FILE__2_7z_SIZE), plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    auto items = decoder->items();
+    PLZMA_TESTS_ASSERT(openBrokenHeaderArchive(broken, FILE__2_7z_SIZE) == true) // the header from the cache
+    
+    auto cachedDecoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(broken), FILE__2_7z_SIZE), plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(cachedDecoder->open() == true)
+    auto cachedItems = cachedDecoder->items();
+    PLZMA_TESTS_ASSERT(cachedItems->count() == items->count())
+    for (plzma_size_t i = 0; i < items->count(); i++) {
+        if (itemsMustEqual(cachedItems->at(i), items->at(i)) != 0) {
+            return 1;
+        }
+    }
+    
+#if !defined(LIBPLZMA_NO_CRYPTO)
+    // the encrypted header is not cached
+    const auto brokenEncrypted = createBrokenHeaderArchive(FILE__14_7z_PTR, FILE__14_7z_SIZE);
+    decoder = makeSharedDecoder(makeSharedInStream(FILE__14_7z_PTR, FILE__14_7z_SIZE), plzma_file_type_7z);
+    decoder->setPassword("1234");
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(openBrokenHeaderArchive(brokenEncrypted, FILE__14_7z_SIZE) == false)
+#endif
+    
+    plzma_set_index_cache_capacity(0);
+    PLZMA_TESTS_ASSERT(openBrokenHeaderArchive(broken, FILE__2_7z_SIZE) == false)
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << plzma_version() << std::endl;
     int ret = 0;
@@ -510,6 +642,10 @@ int main(int argc, char* argv[]) {
         return ret;
     }
     
+    if ( (ret = test_plzma_open_index_cache()) ) {
+        return ret;
+    }
+    
     if ( (ret = test_plzma_open_cpp_doc()) ) {
         return ret;
     }
@@ -0,0 +1,471 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <thread>
+
+#include "plzma_public_tests.hpp"
+#include "../src/plzma_in_streams.hpp"
+#include "../src/plzma_base_callback.hpp"
+#include "../src/CPP/Windows/PropVariant.h"
+
+using namespace plzma;
+
+static const size_t kTestItemsCount = 7;
+
+static size_t testItemSize(const size_t index) {
+    return 64 * 1024 * (index + 1);
+}
+
+static RawHeapMemory createTestContent(const size_t size, uint32_t seed) {
+    RawHeapMemory content(size);
+    uint8_t * ptr = static_cast<uint8_t *>(content);
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1664525 + 1013904223;
+        ptr[i] = ((seed >> 24) < 64) ? static_cast<uint8_t>(seed >> 16) : static_cast<uint8_t>('a' + (i % 26));
+    }
+    return content;
+}
+
+static int test_plzma_parallel_extract_decoder(const SharedPtr<InStream> & stream, const RawHeapMemory * contents) {
+    auto decoder = makeSharedDecoder(stream, plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(decoder->extractWorkers() == 1)
+    decoder->setExtractWorkers(4);
+    PLZMA_TESTS_ASSERT(decoder->extractWorkers() == 4)
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->count() == kTestItemsCount)
+    
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    for (plzma_size_t i = 0; i < decoder->count(); i++) {
+        itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(i), makeSharedOutStream()));
+    }
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    
+    for (plzma_size_t i = 0; i < itemsStreams->count(); i++) {
+        const auto & pair = itemsStreams->at(i);
+        const size_t index = pair.first->index();
+        const auto content = pair.second->copyContent();
+        PLZMA_TESTS_ASSERT(content.second == testItemSize(index))
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(content.first), static_cast<const void *>(contents[index]), content.second) == 0)
+    }
+    
+    PLZMA_TESTS_ASSERT(decoder->test() == true)
+    return 0;
+}
+
+static int test_plzma_parallel_extract_encode(const SharedPtr<OutStream> & stream, RawHeapMemory * contents) {
+    auto encoder = makeSharedEncoder(stream, plzma_file_type_7z, plzma_method_LZMA2);
+    encoder->setShouldCreateSolidArchive(false); // each item in own solid block
+    encoder->setCompressionLevel(1);
+    for (size_t i = 0; i < kTestItemsCount; i++) {
+        char name[16];
+        snprintf(name, 16, "item%u.txt", static_cast<unsigned>(i));
+        const size_t size = testItemSize(i);
+        contents[i] = createTestContent(size, static_cast<uint32_t>(i + 1));
+        encoder->add(makeSharedInStream(static_cast<const void *>(contents[i]), size), Path(name));
+    }
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    return 0;
+}
+
+int test_plzma_parallel_extract_test1(void) {
+    RawHeapMemory contents[kTestItemsCount];
+    auto outStream = makeSharedOutStream();
+    int ret = 0;
+    if ( (ret = test_plzma_parallel_extract_encode(outStream, contents)) ) {
+        return ret;
+    }
+    const auto archive = outStream->copyContent();
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    return test_plzma_parallel_extract_decoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), contents);
+}
+
+int test_plzma_parallel_extract_test2(void) {
+    RawHeapMemory contents[kTestItemsCount];
+    Path path = Path::tmpPath();
+    path.appendRandomComponent();
+    int ret = 0;
+    if ( (ret = test_plzma_parallel_extract_encode(makeSharedOutStream(path), contents)) ) {
+        return ret;
+    }
+    ret = test_plzma_parallel_extract_decoder(makeSharedInStream(path), contents);
+    PLZMA_TESTS_ASSERT(path.remove() == true)
+    return ret;
+}
+
+static const size_t kTestXzStreamsCount = 5;
+
+// The concatenated xz streams are indexed as the blocks of the single stream.
+static RawHeapMemorySize test_plzma_parallel_extract_xz_encode(RawHeapMemory & content, size_t & contentSize) {
+    contentSize = 0;
+    for (size_t i = 0; i < kTestXzStreamsCount; i++) {
+        contentSize += testItemSize(i);
+    }
+    content = createTestContent(contentSize, 11);
+    
+    RawHeapMemory archive;
+    size_t archiveSize = 0, offset = 0;
+    for (size_t i = 0; i < kTestXzStreamsCount; i++) {
+        const size_t size = testItemSize(i);
+        auto outStream = makeSharedOutStream();
+        auto encoder = makeSharedEncoder(outStream, plzma_file_type_xz, plzma_method_LZMA2);
+        encoder->setCompressionLevel(1);
+        encoder->add(makeSharedInStream(static_cast<const uint8_t *>(content) + offset, size), Path("item"));
+        if (!encoder->open() || !encoder->compress()) {
+            return RawHeapMemorySize(RawHeapMemory(), 0);
+        }
+        const auto stream = outStream->copyContent();
+        archive.resize(archiveSize + stream.second);
+        memcpy(static_cast<uint8_t *>(archive) + archiveSize, static_cast<const void *>(stream.first), stream.second);
+        archiveSize += stream.second;
+        offset += size;
+    }
+    return RawHeapMemorySize(static_cast<RawHeapMemory &&>(archive), static_cast<size_t>(archiveSize));
+}
+
+int test_plzma_parallel_extract_test3(void) {
+    RawHeapMemory content;
+    size_t contentSize = 0;
+    const auto archive = test_plzma_parallel_extract_xz_encode(content, contentSize);
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_xz);
+    decoder->setExtractWorkers(3);
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->count() == 1)
+    
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(0), makeSharedOutStream()));
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    const auto extracted = itemsStreams->at(0).second->copyContent();
+    PLZMA_TESTS_ASSERT(extracted.second == contentSize)
+    PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(extracted.first), static_cast<const void *>(content), contentSize) == 0)
+    PLZMA_TESTS_ASSERT(decoder->test() == true)
+    
+    // Extract to the file.
+    Path path = Path::tmpPath();
+    path.appendRandomComponent();
+    PLZMA_TESTS_ASSERT(decoder->extract(path) == true)
+    FILE * file = path.openFile("rb");
+    PLZMA_TESTS_ASSERT(file != nullptr)
+    RawHeapMemory fileContent(contentSize + 1);
+    const size_t fileSize = fread(static_cast<void *>(fileContent), 1, contentSize + 1, file);
+    fclose(file);
+    PLZMA_TESTS_ASSERT(fileSize == contentSize)
+    PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(fileContent), static_cast<const void *>(content), contentSize) == 0)
+    PLZMA_TESTS_ASSERT(path.remove() == true)
+    return 0;
+}
+
+int test_plzma_parallel_extract_test4(void) {
+    RawHeapMemory content;
+    size_t contentSize = 0;
+    const auto archive = test_plzma_parallel_extract_xz_encode(content, contentSize);
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    
+    // Corrupt the data of the middle block, the index is untouched.
+    RawHeapMemory corrupted(archive.second);
+    memcpy(static_cast<void *>(corrupted), static_cast<const void *>(archive.first), archive.second);
+    static_cast<uint8_t *>(corrupted)[archive.second / 2] ^= 0x55;
+    
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(corrupted), archive.second), plzma_file_type_xz);
+    decoder->setExtractWorkers(4);
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    bool failed = false;
+    try {
+        failed = !decoder->test();
+    } catch (const Exception &) {
+        failed = true;
+    }
+    PLZMA_TESTS_ASSERT(failed == true)
+    return 0;
+}
+
+static UInt32 test_plzma_parallel_extract_xz_blocks_count(const RawHeapMemorySize & archive) {
+    auto stream = makeSharedInStream(static_cast<const void *>(archive.first), archive.second).cast<InStreamBase>();
+    auto inArchive = BaseCallback::createArchive<IInArchive>(plzma_file_type_xz);
+    stream->open();
+    const UInt64 maxCheckStartPosition = 1 << 22;
+    if (!inArchive || inArchive->Open(stream.get(), &maxCheckStartPosition, nullptr) != S_OK) {
+        return 0;
+    }
+    UInt32 blocksCount = 0;
+    CMyComPtr<IArchiveIndexedBlocks> blocks;
+    inArchive->QueryInterface(IID_IArchiveIndexedBlocks, reinterpret_cast<void**>(&blocks));
+    if (!blocks || blocks->GetNumberOfBlocks(&blocksCount) != S_OK) {
+        blocksCount = 0;
+    }
+    blocks.Release();
+    inArchive->Close();
+    stream->close();
+    return blocksCount;
+}
+
+int test_plzma_parallel_extract_test5(void) {
+    const size_t contentSize = testItemSize(kTestItemsCount);
+    const RawHeapMemory content = createTestContent(contentSize, 17);
+    const uint64_t blockSize = 100 * 1024;
+    auto outStream = makeSharedOutStream();
+    auto encoder = makeSharedEncoder(outStream, plzma_file_type_xz, plzma_method_LZMA2);
+    PLZMA_TESTS_ASSERT(encoder->blockSize() == 0)
+    encoder->setBlockSize(blockSize);
+    PLZMA_TESTS_ASSERT(encoder->blockSize() == blockSize)
+    encoder->setCompressionLevel(1);
+    encoder->add(makeSharedInStream(static_cast<const void *>(content), contentSize), Path("item"));
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    const auto archive = outStream->copyContent();
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    PLZMA_TESTS_ASSERT(test_plzma_parallel_extract_xz_blocks_count(archive) == (contentSize + blockSize - 1) / blockSize)
+    
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_xz);
+    decoder->setExtractWorkers(4);
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(0), makeSharedOutStream()));
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    const auto extracted = itemsStreams->at(0).second->copyContent();
+    PLZMA_TESTS_ASSERT(extracted.second == contentSize)
+    PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(extracted.first), static_cast<const void *>(content), contentSize) == 0)
+    
+    // 7z, the LZMA2 dictionary is reset at each block, i.e. a checkpoint per block after the first one.
+    auto outStream7z = makeSharedOutStream();
+    auto encoder7z = makeSharedEncoder(outStream7z, plzma_file_type_7z, plzma_method_LZMA2);
+    encoder7z->setBlockSize(blockSize);
+    encoder7z->setCompressionLevel(1);
+    encoder7z->add(makeSharedInStream(static_cast<const void *>(content), contentSize), Path("item"));
+    PLZMA_TESTS_ASSERT(encoder7z->open() == true)
+    PLZMA_TESTS_ASSERT(encoder7z->compress() == true)
+    const auto archive7z = outStream7z->copyContent();
+    auto decoder7z = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive7z.first), archive7z.second), plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(decoder7z->open() == true)
+    PLZMA_TESTS_ASSERT(decoder7z->buildCheckpoints() + 1 == (contentSize + blockSize - 1) / blockSize)
+    return 0;
+}
+
+#if !defined(LIBPLZMA_NO_PROGRESS)
+// Detects the progress reported by the block workers instead of the calling thread.
+class TestThreadsProgressDelegate : public ProgressDelegate {
+public:
+    std::thread::id callerId = std::this_thread::get_id();
+    bool workersReported = false;
+    
+    virtual void onProgress(void * LIBPLZMA_NULLABLE context, const String & path, const double progress) override final {
+        if (std::this_thread::get_id() != callerId) {
+            workersReported = true;
+        }
+    }
+    virtual ~TestThreadsProgressDelegate() { }
+};
+#endif
+
+static int test_plzma_parallel_extract_xz_limited(const RawHeapMemorySize & archive, const RawHeapMemory & content, const size_t contentSize,
+                                                  const uint64_t memoryLimit, bool & workersReported) {
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_xz);
+    decoder->setExtractWorkers(3);
+    decoder->setMemoryLimit(memoryLimit);
+#if !defined(LIBPLZMA_NO_PROGRESS)
+    TestThreadsProgressDelegate progressDelegate;
+    decoder->setProgressDelegate(&progressDelegate);
+#endif
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(0), makeSharedOutStream()));
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    const auto extracted = itemsStreams->at(0).second->copyContent();
+    PLZMA_TESTS_ASSERT(extracted.second == contentSize)
+    PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(extracted.first), static_cast<const void *>(content), contentSize) == 0)
+#if !defined(LIBPLZMA_NO_PROGRESS)
+    decoder->setProgressDelegate(nullptr);
+    workersReported = progressDelegate.workersReported;
+#else
+    workersReported = false;
+#endif
+    return 0;
+}
+
+int test_plzma_parallel_extract_test6(void) {
+    RawHeapMemory content;
+    size_t contentSize = 0;
+    const auto archive = test_plzma_parallel_extract_xz_encode(content, contentSize);
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    
+    // The largest block fits the limit, but two of them don't -> serial extract.
+    bool workersReported = true;
+    const uint64_t maxBlockSize = testItemSize(kTestXzStreamsCount - 1);
+    PLZMA_TESTS_ASSERT(test_plzma_parallel_extract_xz_limited(archive, content, contentSize, maxBlockSize + 1, workersReported) == 0)
+    PLZMA_TESTS_ASSERT(workersReported == false)
+    
+#if !defined(LIBPLZMA_THREAD_UNSAFE) && !defined(LIBPLZMA_NO_PROGRESS)
+    // Enough for all workers -> parallel extract.
+    PLZMA_TESTS_ASSERT(test_plzma_parallel_extract_xz_limited(archive, content, contentSize, maxBlockSize * 4, workersReported) == 0)
+    PLZMA_TESTS_ASSERT(workersReported == true)
+#endif
+    return 0;
+}
+
+static UInt64 test_plzma_parallel_extract_7z_max_folder_memory(const RawHeapMemorySize & archive) {
+    auto stream = makeSharedInStream(static_cast<const void *>(archive.first), archive.second).cast<InStreamBase>();
+    auto inArchive = BaseCallback::createArchive<IInArchive>(plzma_file_type_7z);
+    stream->open();
+    const UInt64 maxCheckStartPosition = 1 << 22;
+    if (!inArchive || inArchive->Open(stream.get(), &maxCheckStartPosition, nullptr) != S_OK) {
+        return 0;
+    }
+    UInt64 maxMemory = 0;
+    NWindows::NCOM::CPropVariant prop;
+    CMyComPtr<IArchiveFolderMemUsage> foldersMemory;
+    inArchive->QueryInterface(IID_IArchiveFolderMemUsage, reinterpret_cast<void**>(&foldersMemory));
+    if (foldersMemory && inArchive->GetArchiveProperty(kpidNumBlocks, &prop) == S_OK && prop.vt == VT_UI4) {
+        for (UInt32 i = 0; i < prop.ulVal; i++) {
+            UInt64 memory = 0;
+            if (foldersMemory->GetFolderMemUsage(i, &memory) != S_OK) {
+                maxMemory = 0;
+                break;
+            }
+            maxMemory = MyMax<UInt64>(maxMemory, memory);
+        }
+    }
+    foldersMemory.Release();
+    inArchive->Close();
+    stream->close();
+    return maxMemory;
+}
+
+static int test_plzma_parallel_extract_7z_limited(const RawHeapMemorySize & archive, const RawHeapMemory * contents,
+                                                  const uint64_t memoryLimit, bool & workersReported) {
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), plzma_file_type_7z);
+    decoder->setExtractWorkers(3);
+    decoder->setMemoryLimit(memoryLimit);
+#if !defined(LIBPLZMA_NO_PROGRESS)
+    TestThreadsProgressDelegate progressDelegate;
+    decoder->setProgressDelegate(&progressDelegate);
+#endif
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    for (plzma_size_t i = 0; i < decoder->count(); i++) {
+        itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(i), makeSharedOutStream()));
+    }
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    for (plzma_size_t i = 0; i < itemsStreams->count(); i++) {
+        const auto & pair = itemsStreams->at(i);
+        const size_t index = pair.first->index();
+        const auto content = pair.second->copyContent();
+        PLZMA_TESTS_ASSERT(content.second == testItemSize(index))
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(content.first), static_cast<const void *>(contents[index]), content.second) == 0)
+    }
+#if !defined(LIBPLZMA_NO_PROGRESS)
+    decoder->setProgressDelegate(nullptr);
+    workersReported = progressDelegate.workersReported;
+#else
+    workersReported = false;
+#endif
+    return 0;
+}
+
+int test_plzma_parallel_extract_test7(void) {
+    RawHeapMemory contents[kTestItemsCount];
+    auto outStream = makeSharedOutStream();
+    int ret = 0;
+    if ( (ret = test_plzma_parallel_extract_encode(outStream, contents)) ) {
+        return ret;
+    }
+    const auto archive = outStream->copyContent();
+    const UInt64 maxFolderMemory = test_plzma_parallel_extract_7z_max_folder_memory(archive);
+    PLZMA_TESTS_ASSERT(maxFolderMemory > 0)
+    
+    // The dictionary of the largest folder fits the limit, but two of them don't -> serial extract.
+    bool workersReported = true;
+    PLZMA_TESTS_ASSERT(test_plzma_parallel_extract_7z_limited(archive, contents, maxFolderMemory + 1, workersReported) == 0)
+    PLZMA_TESTS_ASSERT(workersReported == false)
+    
+#if !defined(LIBPLZMA_THREAD_UNSAFE) && !defined(LIBPLZMA_NO_PROGRESS)
+    // Enough for all workers -> parallel extract.
+    PLZMA_TESTS_ASSERT(test_plzma_parallel_extract_7z_limited(archive, contents, maxFolderMemory * 4, workersReported) == 0)
+    PLZMA_TESTS_ASSERT(workersReported == true)
+#endif
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << plzma_version() << std::endl;
+    int ret = 0;
+    
+    try {
+        if ( (ret = test_plzma_parallel_extract_test1()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_parallel_extract_test2()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_parallel_extract_test3()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_parallel_extract_test4()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_parallel_extract_test5()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_parallel_extract_test6()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_parallel_extract_test7()) ) {
+            return ret;
+        }
+    } catch (const Exception & e) {
+        std::cout << "PLZMA Exception [" << e.code() << "]:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        if (e.reason()) {
+            std::cout << "reason: " << e.reason() << std::endl;
+        }
+        if (e.file()) {
+            std::cout << "file: " << e.file() << std::endl;
+        }
+        std::cout << "line: " << e.line() << std::endl;
+        throw;
+    } catch (const std::exception & e) {
+        std::cout << "std exception:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        throw;
+    } catch (...) {
+        std::cout << "unknown exception:" << std::endl;
+        throw;
+    }
+    
+    return ret;
+}
@@ -25,7 +25,14 @@
 //
 
 
+#include <chrono>
+
 #include "plzma_public_tests.hpp"
+#include "../src/plzma_dir_scanner.hpp"
+
+#if defined(LIBPLZMA_POSIX)
+#include <unistd.h>
+#endif
 
 using namespace plzma;
 
@@ -706,6 +713,82 @@ int test_plzma_path_test_remove_non_empty_dir2(void) {
     return 0;
 }
 
+#if defined(LIBPLZMA_POSIX)
+static bool createScanTestTree(const Path & path, const unsigned depth, unsigned & filesCount) {
+    if (!path.createDir(false)) {
+        return false;
+    }
+    char name[32];
+    for (unsigned i = 0; i < 12; i++) {
+        snprintf(name, sizeof(name), "f%u.bin", i);
+        FILE * file = path.appending(name).openFile("wb");
+        if (!file) {
+            return false;
+        }
+        fwrite(name, 1, (i * 7 + filesCount) % 97, file);
+        fclose(file);
+        filesCount++;
+    }
+    for (unsigned i = 0; depth > 0 && i < 4; i++) {
+        snprintf(name, sizeof(name), "d%u", i);
+        if (!createScanTestTree(path.appending(name), depth - 1, filesCount)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int test_plzma_path_test_dir_scanner(void) {
+    const auto rootPath = Path::tmpPath().appendingRandomComponent();
+    unsigned filesCount = 0;
+    PLZMA_TESTS_ASSERT(createScanTestTree(rootPath, 3, filesCount) == true)
+    const auto dirLink = rootPath.appending("link_d1"), fileLink = rootPath.appending("link_f1.bin");
+    PLZMA_TESTS_ASSERT(symlink(rootPath.appending("d1").utf8(), dirLink.utf8()) == 0)
+    PLZMA_TESTS_ASSERT(symlink(rootPath.appending("f1.bin").utf8(), fileLink.utf8()) == 0)
+    
+    for (plzma_open_dir_mode_t mode = 0; mode <= plzma_open_dir_mode_follow_symlinks; mode++) {
+        auto start = std::chrono::steady_clock::now();
+        Vector<Pair<Path, plzma_path_stat> > expected;
+        auto it = rootPath.openDir(mode);
+        while (it->next()) {
+            if (!it->isDir()) {
+                expected.push(Pair<Path, plzma_path_stat>(it->path(), it->fullPath().stat()));
+            }
+        }
+        const auto iteratorTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        PLZMA_TESTS_ASSERT(expected.count() >= filesCount)
+        
+        for (plzma_size_t workers = 1; workers <= 4; workers += 3) {
+            start = std::chrono::steady_clock::now();
+            DirScanner scanner(rootPath, mode);
+            scanner.scan(workers);
+            const auto files = scanner.takeFiles();
+            const auto scannerTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "Scanned " << files.count() << " files, mode: " << static_cast<unsigned>(mode) << ", workers: " << workers <<
+            ", iterator: " << iteratorTime << " us, scanner: " << scannerTime << " us" << std::endl;
+            PLZMA_TESTS_ASSERT(files.count() == expected.count())
+            for (plzma_size_t i = 0, n = files.count(); i < n; i++) {
+                const auto & file = files.at(i);
+                const auto & pair = expected.at(i);
+                PLZMA_TESTS_ASSERT(strcmp(file.path.utf8(), pair.first.utf8()) == 0)
+                PLZMA_TESTS_ASSERT(file.stat.size == pair.second.size)
+                PLZMA_TESTS_ASSERT(file.stat.last_modification == pair.second.last_modification)
+            }
+        }
+    }
+    
+    bool thrown = false;
+    try {
+        DirScanner scanner(rootPath.appending("f1.bin"), 0);
+    } catch (const Exception & exception) {
+        thrown = exception.code() == plzma_error_code_io;
+    }
+    PLZMA_TESTS_ASSERT(thrown)
+    PLZMA_TESTS_ASSERT(rootPath.remove() == true)
+    return 0;
+}
+#endif
+
 int main(int argc, char* argv[]) {
     std::cout << plzma_version() << std::endl;
     int ret = 0;
@@ -758,6 +841,12 @@ int main(int argc, char* argv[]) {
         return ret;
     }
     
+#if defined(LIBPLZMA_POSIX)
+    if ( (ret = test_plzma_path_test_dir_scanner()) ) {
+        return ret;
+    }
+#endif
+    
 //    while (1) {
 //        usleep(50);
 //    }
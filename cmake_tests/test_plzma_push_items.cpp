@@ -0,0 +1,277 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "plzma_public_tests.hpp"
+
+#include <thread>
+#include <chrono>
+
+using namespace plzma;
+
+static const size_t kTestItemsCount = 3;
+static const char * kTestItemNames[kTestItemsCount] = { "a.bin", "b.bin", "c.bin" };
+
+static size_t testItemSize(const size_t index) {
+    static const size_t sizes[kTestItemsCount] = { 3 * 1024 * 1024 + 5, 100, 2 * 1024 * 1024 }; // larger than the push buffer
+    return sizes[index];
+}
+
+static RawHeapMemory createTestContent(const size_t size, uint32_t seed) {
+    RawHeapMemory content(size);
+    uint8_t * ptr = static_cast<uint8_t *>(content);
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1664525 + 1013904223;
+        ptr[i] = ((seed >> 24) < 64) ? static_cast<uint8_t>(seed >> 16) : static_cast<uint8_t>('a' + (i % 26));
+    }
+    return content;
+}
+
+static bool pushTestItem(SharedPtr<Encoder> & encoder, const size_t index, const RawHeapMemory & content) {
+    if (!encoder->beginItem(Path(kTestItemNames[index]))) {
+        return false;
+    }
+    const size_t size = testItemSize(index), chunkSize = 64 * 1024 + 3;
+    for (size_t offset = 0; offset < size; offset += chunkSize) {
+        const size_t chunk = (size - offset < chunkSize) ? (size - offset) : chunkSize;
+        if (!encoder->write(static_cast<const uint8_t *>(content) + offset, chunk)) {
+            return false;
+        }
+    }
+    return encoder->endItem();
+}
+
+static int readTestItem(SharedPtr<Decoder> & decoder, const Path & path, const RawHeapMemory & content, const size_t contentSize) {
+    auto items = decoder->items();
+    for (plzma_size_t i = 0, n = items->count(); i < n; i++) {
+        auto item = items->at(i);
+        if (path.count() > 0 && !(item->path() == path)) {
+            continue;
+        }
+        PLZMA_TESTS_ASSERT(item->size() == contentSize)
+        auto stream = decoder->openItemStream(item);
+        PLZMA_TESTS_ASSERT(stream)
+        RawHeapMemory buffer(contentSize + 1);
+        size_t offset = 0, readSize = 0;
+        while ( (readSize = stream->read(static_cast<uint8_t *>(buffer) + offset, contentSize + 1 - offset)) > 0 ) {
+            offset += readSize;
+        }
+        PLZMA_TESTS_ASSERT(offset == contentSize)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(buffer), static_cast<const void *>(content), contentSize) == 0)
+        return 0;
+    }
+    PLZMA_TESTS_ASSERT(false)
+    return 0;
+}
+
+static int test_plzma_push_items_roundtrip(const plzma_file_type type, const bool reversed) {
+    const size_t itemsCount = (type == plzma_file_type_xz) ? 1 : kTestItemsCount;
+    RawHeapMemory contents[kTestItemsCount];
+    for (size_t i = 0; i < itemsCount; i++) {
+        contents[i] = createTestContent(testItemSize(i), static_cast<uint32_t>(i + 1));
+    }
+    const char * streamContent = "The content of the regular stream item.";
+    
+    auto outStream = makeSharedOutStream();
+    auto encoder = makeSharedEncoder(outStream, type, plzma_method_LZMA2);
+    encoder->setCompressionLevel(1);
+    for (size_t i = 0; i < itemsCount; i++) {
+        encoder->addPushItem(Path(kTestItemNames[i]));
+    }
+    if (type != plzma_file_type_xz) {
+        encoder->add(makeSharedInStream(streamContent, strlen(streamContent)), Path("d.txt"));
+    }
+    
+    bool pushed = true;
+    std::thread producer([&]() {
+        try {
+            for (size_t i = 0; i < itemsCount && pushed; i++) {
+                const size_t index = reversed ? (itemsCount - i - 1) : i;
+                pushed = pushTestItem(encoder, index, contents[index]);
+            }
+        } catch (...) {
+            pushed = false;
+        }
+    });
+    const bool compressed = encoder->open() && encoder->compress();
+    producer.join();
+    PLZMA_TESTS_ASSERT(compressed)
+    PLZMA_TESTS_ASSERT(pushed)
+    PLZMA_TESTS_ASSERT(encoder->write(streamContent, 1) == false) // finished
+    
+    auto archive = outStream->takeContent();
+    auto decoder = makeSharedDecoder(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), type);
+    PLZMA_TESTS_ASSERT(decoder->open())
+    PLZMA_TESTS_ASSERT(decoder->count() == ((type == plzma_file_type_xz) ? 1 : (itemsCount + 1)))
+    int ret = 0;
+    for (size_t i = 0; i < itemsCount; i++) {
+        const Path path = (type == plzma_file_type_xz) ? Path() : Path(kTestItemNames[i]);
+        if ( (ret = readTestItem(decoder, path, contents[i], testItemSize(i))) ) {
+            return ret;
+        }
+    }
+    if (type != plzma_file_type_xz) {
+        RawHeapMemory content(strlen(streamContent));
+        memcpy(static_cast<void *>(content), streamContent, strlen(streamContent));
+        if ( (ret = readTestItem(decoder, Path("d.txt"), content, strlen(streamContent))) ) {
+            return ret;
+        }
+    }
+    std::cout << "Pushed " << itemsCount << (reversed ? " reversed" : "") << " items -> " << archive.second << std::endl;
+    return 0;
+}
+
+int test_plzma_push_items_test1(void) {
+    int ret = 0;
+    if ( (ret = test_plzma_push_items_roundtrip(plzma_file_type_7z, false)) ) {
+        return ret;
+    }
+    if ( (ret = test_plzma_push_items_roundtrip(plzma_file_type_7z, true)) ) {
+        return ret;
+    }
+    if ( (ret = test_plzma_push_items_roundtrip(plzma_file_type_tar, false)) ) {
+        return ret;
+    }
+    if ( (ret = test_plzma_push_items_roundtrip(plzma_file_type_tar, true)) ) {
+        return ret;
+    }
+    return test_plzma_push_items_roundtrip(plzma_file_type_xz, false);
+}
+
+int test_plzma_push_items_test2(void) {
+    auto encoder = makeSharedEncoder(makeSharedOutStream(), plzma_file_type_7z, plzma_method_LZMA2);
+    encoder->addPushItem(Path("a.bin"));
+    
+    bool thrown = false;
+    try {
+        encoder->addPushItem(Path("a.bin"));
+    } catch (const Exception & exception) {
+        thrown = true;
+    }
+    PLZMA_TESTS_ASSERT(thrown)
+    thrown = false;
+    try {
+        encoder->beginItem(Path("b.bin"));
+    } catch (const Exception & exception) {
+        thrown = true;
+    }
+    PLZMA_TESTS_ASSERT(thrown)
+    
+    // The producer pushes endlessly, the encoder aborted.
+    bool written = true;
+    std::thread producer([&]() {
+        RawHeapMemory content = createTestContent(64 * 1024, 1);
+        written = encoder->beginItem(Path("a.bin"));
+        while (written) {
+            written = encoder->write(static_cast<const void *>(content), 64 * 1024);
+        }
+    });
+    PLZMA_TESTS_ASSERT(encoder->open())
+    bool compressed = true;
+    std::thread compressor([&]() {
+        compressed = encoder->compress();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    encoder->abort();
+    compressor.join();
+    producer.join();
+    PLZMA_TESTS_ASSERT(compressed == false)
+    PLZMA_TESTS_ASSERT(written == false)
+    return 0;
+}
+
+int test_plzma_push_items_test3(void) {
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+    plzma_out_stream stream = plzma_out_stream_create_memory_stream();
+    plzma_encoder encoder = plzma_encoder_create(&stream, plzma_file_type_7z, plzma_method_LZMA2, plzma_context{nullptr, nullptr});
+    plzma_path path = plzma_path_create_with_utf8_string("a.bin");
+    plzma_encoder_add_push_item(&encoder, &path);
+    PLZMA_TESTS_ASSERT(encoder.exception == nullptr)
+    
+    // The failure of the producer doesn't touch the encoder object, it's thrown by the compress.
+    bool begun = true;
+    std::thread producer([&]() {
+        plzma_path notAddedPath = plzma_path_create_with_utf8_string("b.bin");
+        begun = plzma_encoder_begin_item(&encoder, &notAddedPath);
+        plzma_path_release(&notAddedPath);
+    });
+    producer.join();
+    PLZMA_TESTS_ASSERT(begun == false)
+    PLZMA_TESTS_ASSERT(encoder.exception == nullptr)
+    PLZMA_TESTS_ASSERT(plzma_encoder_open(&encoder) == true)
+    PLZMA_TESTS_ASSERT(encoder.exception == nullptr)
+    PLZMA_TESTS_ASSERT(plzma_encoder_compress(&encoder) == false)
+    PLZMA_TESTS_ASSERT(encoder.exception != nullptr)
+    PLZMA_TESTS_ASSERT(plzma_exception_code(encoder.exception) == plzma_error_code_invalid_arguments)
+    plzma_path_release(&path);
+    plzma_out_stream_release(&stream);
+    plzma_encoder_release(&encoder);
+#endif // !LIBPLZMA_NO_C_BINDINGS
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << plzma_version() << std::endl;
+    int ret = 0;
+    
+    try {
+        if ( (ret = test_plzma_push_items_test1()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_push_items_test2()) ) {
+            return ret;
+        }
+        
+        if ( (ret = test_plzma_push_items_test3()) ) {
+            return ret;
+        }
+    } catch (const Exception & e) {
+        std::cout << "PLZMA Exception [" << e.code() << "]:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        if (e.reason()) {
+            std::cout << "reason: " << e.reason() << std::endl;
+        }
+        if (e.file()) {
+            std::cout << "file: " << e.file() << std::endl;
+        }
+        std::cout << "line: " << e.line() << std::endl;
+        throw;
+    } catch (const std::exception & e) {
+        std::cout << "std exception:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        throw;
+    } catch (...) {
+        std::cout << "unknown exception:" << std::endl;
+        throw;
+    }
+    
+    return ret;
+}
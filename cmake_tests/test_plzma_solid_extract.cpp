@@ -0,0 +1,183 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <chrono>
+
+#include "plzma_public_tests.hpp"
+
+using namespace plzma;
+
+static const size_t kTestItemsCount = 2000;
+static const size_t kTestItemSize = 1024;
+
+// The in-memory archive stream which counts the number of read bytes.
+// The content of the items is random, i.e. the read(packed) bytes are equal to the decoded bytes.
+struct CountingStream final {
+    const uint8_t * data = nullptr;
+    uint64_t size = 0;
+    uint64_t offset = 0;
+    uint64_t readBytes = 0;
+};
+
+static bool counting_stream_open(void * LIBPLZMA_NULLABLE context) {
+    static_cast<CountingStream *>(context)->offset = 0;
+    return true;
+}
+
+static void counting_stream_close(void * LIBPLZMA_NULLABLE context) {
+    
+}
+
+static bool counting_stream_seek(void * LIBPLZMA_NULLABLE context, int64_t offset, uint32_t seek_origin, uint64_t * LIBPLZMA_NONNULL new_position) {
+    CountingStream * stream = static_cast<CountingStream *>(context);
+    int64_t position = 0;
+    switch (seek_origin) {
+        case SEEK_SET: position = offset; break;
+        case SEEK_CUR: position = static_cast<int64_t>(stream->offset) + offset; break;
+        case SEEK_END: position = static_cast<int64_t>(stream->size) + offset; break;
+        default: return false;
+    }
+    if (position < 0) {
+        return false;
+    }
+    *new_position = stream->offset = static_cast<uint64_t>(position);
+    return true;
+}
+
+static bool counting_stream_read(void * LIBPLZMA_NULLABLE context, void * LIBPLZMA_NONNULL data, uint32_t size, uint32_t * LIBPLZMA_NONNULL processed_size) {
+    CountingStream * stream = static_cast<CountingStream *>(context);
+    const uint64_t available = (stream->offset < stream->size) ? (stream->size - stream->offset) : 0;
+    const uint32_t toRead = (available < size) ? static_cast<uint32_t>(available) : size;
+    if (toRead > 0) {
+        memcpy(data, stream->data + stream->offset, toRead);
+    }
+    stream->offset += toRead;
+    stream->readBytes += toRead;
+    *processed_size = toRead;
+    return true;
+}
+
+static int test_plzma_solid_extract_items(const RawHeapMemory & archive, const size_t archiveSize, const RawHeapMemory & content, const size_t step) {
+    CountingStream counting;
+    counting.data = static_cast<const uint8_t *>(static_cast<const void *>(archive));
+    counting.size = archiveSize;
+    auto decoder = makeSharedDecoder(makeSharedInStream(counting_stream_open, counting_stream_close, counting_stream_seek, counting_stream_read, plzma_context{&counting, nullptr}), plzma_file_type_7z);
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->count() == kTestItemsCount)
+    
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    for (plzma_size_t i = 0; i < decoder->count(); i += static_cast<plzma_size_t>(step)) {
+        itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(i), makeSharedOutStream()));
+    }
+    
+    counting.readBytes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    const double decodeTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    for (plzma_size_t i = 0; i < itemsStreams->count(); i++) {
+        const auto & pair = itemsStreams->at(i);
+        const auto itemContent = pair.second->copyContent();
+        PLZMA_TESTS_ASSERT(itemContent.second == kTestItemSize)
+        const uint8_t * expected = static_cast<const uint8_t *>(static_cast<const void *>(content)) + pair.first->index() * kTestItemSize;
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(itemContent.first), expected, kTestItemSize) == 0)
+    }
+    
+    const uint64_t unpackedBytes = kTestItemsCount * kTestItemSize;
+    std::cout << "Solid extract, " << itemsStreams->count() << " of " << kTestItemsCount << " items: decoded "
+              << counting.readBytes << " of " << unpackedBytes << " unpacked bytes ("
+              << (static_cast<double>(counting.readBytes) / static_cast<double>(unpackedBytes)) << "x), " << decodeTime << " ms" << std::endl;
+    
+    // The folder must be decoded once, the batches of 256 items, which split the folder, decode it ~6.5 times.
+    PLZMA_TESTS_ASSERT(counting.readBytes < unpackedBytes + unpackedBytes / 4)
+    return 0;
+}
+
+int test_plzma_solid_extract_test1(void) {
+    RawHeapMemory content(kTestItemsCount * kTestItemSize);
+    uint8_t * ptr = static_cast<uint8_t *>(content);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < kTestItemsCount * kTestItemSize; i++) {
+        seed = seed * 1664525 + 1013904223;
+        ptr[i] = static_cast<uint8_t>(seed >> 24);
+    }
+    
+    auto outStream = makeSharedOutStream();
+    auto encoder = makeSharedEncoder(outStream, plzma_file_type_7z, plzma_method_LZMA2);
+    encoder->setShouldCreateSolidArchive(true);
+    encoder->setCompressionLevel(1);
+    for (size_t i = 0; i < kTestItemsCount; i++) {
+        char name[32];
+        snprintf(name, 32, "dir/item%04u.bin", static_cast<unsigned>(i));
+        encoder->add(makeSharedInStream(static_cast<const void *>(ptr + i * kTestItemSize), kTestItemSize), Path(name));
+    }
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    auto archive = outStream->copyContent();
+    PLZMA_TESTS_ASSERT(archive.second > kTestItemsCount * kTestItemSize)
+    
+    int ret = 0;
+    if ( (ret = test_plzma_solid_extract_items(archive.first, archive.second, content, 1)) ) {
+        return ret;
+    }
+    return test_plzma_solid_extract_items(archive.first, archive.second, content, 3);
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << plzma_version() << std::endl;
+    int ret = 0;
+    
+    try {
+        if ( (ret = test_plzma_solid_extract_test1()) ) {
+            return ret;
+        }
+    } catch (const Exception & e) {
+        std::cout << "PLZMA Exception [" << e.code() << "]:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        if (e.reason()) {
+            std::cout << "reason: " << e.reason() << std::endl;
+        }
+        if (e.file()) {
+            std::cout << "file: " << e.file() << std::endl;
+        }
+        std::cout << "line: " << e.line() << std::endl;
+        throw;
+    } catch (const std::exception & e) {
+        std::cout << "std exception:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        throw;
+    } catch (...) {
+        std::cout << "unknown exception:" << std::endl;
+        throw;
+    }
+    
+    return ret;
+}
@@ -25,7 +25,11 @@
 //
 
 
+#include <chrono>
+#include <thread>
+
 #include "plzma_public_tests.hpp"
+#include "../src/plzma_in_streams.hpp"
 
 #if 0
 #include "../src/plzma_out_streams.hpp"
@@ -38,6 +42,338 @@ int test_plzma_streams_test1(void) {
     return 0;
 }
 
+int test_plzma_streams_out_mem_capacity(void) {
+    static const size_t chunkSize = 1000;
+    static const size_t chunksCount = 300;
+    RawHeapMemory chunk(chunkSize);
+    for (size_t i = 0; i < chunkSize; i++) {
+        static_cast<uint8_t *>(chunk)[i] = static_cast<uint8_t>(i % 251);
+    }
+    
+    for (int pass = 0; pass < 2; pass++) {
+        auto stream = (pass == 0) ? makeSharedOutStream() : makeSharedOutStream(chunkSize * chunksCount);
+        auto streamBase = stream.cast<OutStreamBase>();
+        streamBase->open();
+        for (size_t i = 0; i < chunksCount; i++) {
+            UInt32 processed = 0;
+            PLZMA_TESTS_ASSERT(streamBase->Write(static_cast<const void *>(chunk), chunkSize, &processed) == S_OK)
+            PLZMA_TESTS_ASSERT(processed == chunkSize)
+        }
+        PLZMA_TESTS_ASSERT(streamBase->SetSize(chunkSize * 2) == S_OK)
+        streamBase->close();
+        stream->reserve(chunkSize); // less than capacity -> no effect
+        const auto content = stream->copyContent();
+        PLZMA_TESTS_ASSERT(content.second == chunkSize * 2)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(content.first), static_cast<const void *>(chunk), chunkSize) == 0)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const uint8_t *>(content.first) + chunkSize, static_cast<const void *>(chunk), chunkSize) == 0)
+        const auto view = stream->contentView();
+        PLZMA_TESTS_ASSERT(view.second == chunkSize * 2)
+        PLZMA_TESTS_ASSERT(memcmp(view.first, static_cast<const void *>(content.first), view.second) == 0)
+        if (pass == 0) {
+            PLZMA_TESTS_ASSERT(stream->erase(plzma_erase_zero) == true)
+        } else {
+            const auto taken = stream->takeContent();
+            PLZMA_TESTS_ASSERT(taken.second == chunkSize * 2)
+            PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(taken.first), static_cast<const void *>(content.first), taken.second) == 0)
+            PLZMA_TESTS_ASSERT(stream->takeContent().second == 0)
+        }
+        PLZMA_TESTS_ASSERT(stream->copyContent().second == 0)
+        PLZMA_TESTS_ASSERT(stream->contentView().first == nullptr)
+    }
+    return 0;
+}
+
+int test_plzma_streams_mmap(void) {
+    static const size_t itemSize = 256 * 1024;
+    RawHeapMemory contents[2] = { RawHeapMemory(itemSize), RawHeapMemory(itemSize) };
+    for (size_t i = 0; i < itemSize; i++) {
+        static_cast<uint8_t *>(contents[0])[i] = static_cast<uint8_t>(i % 251);
+        static_cast<uint8_t *>(contents[1])[i] = static_cast<uint8_t>((i * 7) % 253);
+    }
+    
+    Path path = Path::tmpPath();
+    path.appendRandomComponent();
+    auto encoder = makeSharedEncoder(makeSharedOutStream(path), plzma_file_type_7z, plzma_method_LZMA2);
+    encoder->setShouldCreateSolidArchive(false);
+    encoder->add(makeSharedInStream(static_cast<const void *>(contents[0]), itemSize), Path("a.bin"));
+    encoder->add(makeSharedInStream(static_cast<const void *>(contents[1]), itemSize), Path("b.bin"));
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    encoder.clear();
+    
+    auto decoder = makeSharedDecoder(makeSharedInStream(path, plzma_in_stream_mode_mmap), plzma_file_type_7z);
+    decoder->setExtractWorkers(2); // clones the mapped stream
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->count() == 2)
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    for (plzma_size_t i = 0; i < decoder->count(); i++) {
+        itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(i), makeSharedOutStream()));
+    }
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    for (plzma_size_t i = 0; i < itemsStreams->count(); i++) {
+        const auto & pair = itemsStreams->at(i);
+        const auto content = pair.second->copyContent();
+        PLZMA_TESTS_ASSERT(content.second == itemSize)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(content.first), static_cast<const void *>(contents[pair.first->index()]), itemSize) == 0)
+    }
+    PLZMA_TESTS_ASSERT(decoder->test() == true)
+    decoder.clear();
+    
+    // The empty file can't be mapped -> reads with the file functions.
+    FILE * file = path.openFile("wb");
+    PLZMA_TESTS_ASSERT(file != nullptr)
+    fclose(file);
+    auto stream = makeSharedInStream(path, plzma_in_stream_mode_mmap);
+    decoder = makeSharedDecoder(stream, plzma_file_type_7z);
+    bool opened = true;
+    try {
+        opened = decoder->open();
+    } catch (const Exception & exception) {
+        PLZMA_TESTS_ASSERT(exception.code() == plzma_error_code_internal)
+        opened = false;
+    }
+    PLZMA_TESTS_ASSERT(opened == false)
+    decoder.clear();
+    PLZMA_TESTS_ASSERT(stream->erase(plzma_erase_zero) == true)
+    PLZMA_TESTS_ASSERT(path.exists() == false)
+    return 0;
+}
+
+int test_plzma_streams_file_clones(void) {
+    static const size_t itemSize = 768 * 1024;
+    RawHeapMemory contents[3] = { RawHeapMemory(itemSize), RawHeapMemory(itemSize), RawHeapMemory(itemSize) };
+    for (size_t i = 0; i < itemSize; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            static_cast<uint8_t *>(contents[j])[i] = static_cast<uint8_t>((i * (j + 3)) % 251);
+        }
+    }
+    
+    Path path = Path::tmpPath();
+    path.appendRandomComponent();
+    auto encoder = makeSharedEncoder(makeSharedOutStream(path), plzma_file_type_7z, plzma_method_LZMA2);
+    encoder->setShouldCreateSolidArchive(false);
+    encoder->add(makeSharedInStream(static_cast<const void *>(contents[0]), itemSize), Path("a.bin"));
+    encoder->add(makeSharedInStream(static_cast<const void *>(contents[1]), itemSize), Path("b.bin"));
+    encoder->add(makeSharedInStream(static_cast<const void *>(contents[2]), itemSize), Path("c.bin"));
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    encoder.clear();
+    
+    auto stream = makeSharedInStream(path);
+    auto decoder = makeSharedDecoder(stream, plzma_file_type_7z);
+    decoder->setExtractWorkers(3); // the workers read the file of the decoder's stream
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    PLZMA_TESTS_ASSERT(decoder->count() == 3)
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    for (plzma_size_t i = 0; i < decoder->count(); i++) {
+        itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(i), makeSharedOutStream()));
+    }
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    for (plzma_size_t i = 0; i < itemsStreams->count(); i++) {
+        const auto & pair = itemsStreams->at(i);
+        const auto content = pair.second->copyContent();
+        PLZMA_TESTS_ASSERT(content.second == itemSize)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(content.first), static_cast<const void *>(contents[pair.first->index()]), itemSize) == 0)
+    }
+    
+    // The interleaved readers with own positions in the same file.
+    SharedPtr<ItemStream> readers[3];
+    size_t offsets[3] = { 0, 0, 0 };
+    for (plzma_size_t i = 0; i < 3; i++) {
+        readers[i] = decoder->openItemStream(decoder->itemAt(i));
+        PLZMA_TESTS_ASSERT(readers[i])
+    }
+    RawHeapMemory buffer(32 * 1024);
+    bool reading = true;
+    while (reading) {
+        reading = false;
+        for (size_t i = 0; i < 3; i++) {
+            const plzma_size_t index = readers[i]->item()->index();
+            const size_t readSize = readers[i]->read(static_cast<void *>(buffer), 32 * 1024);
+            PLZMA_TESTS_ASSERT(offsets[i] + readSize <= itemSize)
+            PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(buffer), static_cast<const uint8_t *>(contents[index]) + offsets[i], readSize) == 0)
+            offsets[i] += readSize;
+            reading |= (readSize > 0);
+            if (decoder && offsets[0] >= itemSize / 2) {
+                decoder.clear(); // closes the shared file after the last reader
+            }
+        }
+    }
+    for (size_t i = 0; i < 3; i++) {
+        PLZMA_TESTS_ASSERT(offsets[i] == itemSize)
+        readers[i].clear();
+    }
+    decoder.clear();
+    PLZMA_TESTS_ASSERT(stream->opened() == false)
+    PLZMA_TESTS_ASSERT(stream->erase(plzma_erase_zero) == true)
+    PLZMA_TESTS_ASSERT(path.exists() == false)
+    return 0;
+}
+
+// The stream reopened while the clone reads the file starts from the beginning, as a newly opened file.
+int test_plzma_streams_file_reopen(void) {
+    Path path = Path::tmpPath();
+    path.appendRandomComponent();
+    FILE * file = path.openFile("wb");
+    PLZMA_TESTS_ASSERT(file != nullptr)
+    PLZMA_TESTS_ASSERT(fwrite("0123456789", 1, 10, file) == 10)
+    fclose(file);
+    
+    auto stream = makeSharedInStream(path).cast<InStreamBase>();
+    stream->open();
+    auto clone = stream->clone();
+    PLZMA_TESTS_ASSERT(clone)
+    clone->open();
+    char buffer[4] = { 0 };
+    UInt32 processed = 0;
+    PLZMA_TESTS_ASSERT(stream->Read(buffer, 4, &processed) == S_OK)
+    PLZMA_TESTS_ASSERT(processed == 4 && memcmp(buffer, "0123", 4) == 0)
+    stream->close(); // pending, the clone is still reading
+    stream->open();
+    PLZMA_TESTS_ASSERT(stream->Read(buffer, 4, &processed) == S_OK)
+    PLZMA_TESTS_ASSERT(processed == 4 && memcmp(buffer, "0123", 4) == 0)
+    PLZMA_TESTS_ASSERT(clone->Read(buffer, 4, &processed) == S_OK)
+    PLZMA_TESTS_ASSERT(processed == 4 && memcmp(buffer, "0123", 4) == 0)
+    clone->close();
+    clone.Release();
+    stream->close();
+    stream.clear();
+    PLZMA_TESTS_ASSERT(path.remove() == true)
+    return 0;
+}
+
+// The callback stream with the delay of the slow storage, 1 millisecond per 16KB.
+struct TestSlowStream {
+    const uint8_t * memory;
+    uint64_t size;
+    uint64_t offset;
+    uint64_t readSize;
+    std::thread::id readThread;
+};
+
+static bool testSlowStreamOpen(void * context) {
+    static_cast<TestSlowStream *>(context)->offset = 0;
+    return true;
+}
+
+static void testSlowStreamClose(void * context) {
+    
+}
+
+static bool testSlowStreamSeek(void * context, int64_t offset, uint32_t seekOrigin, uint64_t * newPosition) {
+    TestSlowStream * stream = static_cast<TestSlowStream *>(context);
+    const int64_t base = (seekOrigin == 0) ? 0 : ((seekOrigin == 1) ? static_cast<int64_t>(stream->offset) : static_cast<int64_t>(stream->size));
+    if (base + offset < 0) {
+        return false;
+    }
+    *newPosition = stream->offset = static_cast<uint64_t>(base + offset);
+    return true;
+}
+
+static bool testSlowStreamRead(void * context, void * data, uint32_t size, uint32_t * processedSize) {
+    TestSlowStream * stream = static_cast<TestSlowStream *>(context);
+    const uint64_t available = (stream->offset < stream->size) ? stream->size - stream->offset : 0;
+    const uint32_t sizeToRead = (size < available) ? size : static_cast<uint32_t>(available);
+    std::this_thread::sleep_for(std::chrono::microseconds(1 + (sizeToRead * 1000ULL) / (16 * 1024)));
+    memcpy(data, stream->memory + stream->offset, sizeToRead);
+    stream->offset += sizeToRead;
+    stream->readSize += sizeToRead;
+    stream->readThread = std::this_thread::get_id();
+    *processedSize = sizeToRead;
+    return true;
+}
+
+static int test_plzma_streams_read_ahead_extract(const SharedPtr<InStream> & stream, const plzma_file_type type,
+                                                 const RawHeapMemory & content, const size_t contentSize) {
+    auto decoder = makeSharedDecoder(stream, type);
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    auto itemsStreams = makeShared<ItemOutStreamArray>();
+    itemsStreams->push(ItemOutStreamArray::ElementType(decoder->itemAt(0), makeSharedOutStream()));
+    PLZMA_TESTS_ASSERT(decoder->extract(itemsStreams) == true)
+    const auto extracted = itemsStreams->at(0).second->copyContent();
+    PLZMA_TESTS_ASSERT(extracted.second == contentSize)
+    PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(extracted.first), static_cast<const void *>(content), contentSize) == 0)
+    return 0;
+}
+
+int test_plzma_streams_read_ahead(void) {
+    static const size_t contentSize = 3 * 1024 * 1024;
+    RawHeapMemory content(contentSize);
+    uint32_t seed = 5;
+    for (size_t i = 0; i < contentSize; i++) {
+        seed = seed * 1664525 + 1013904223;
+        static_cast<uint8_t *>(content)[i] = ((seed >> 24) < 96) ? static_cast<uint8_t>(seed >> 16) : static_cast<uint8_t>('a' + (i % 26));
+    }
+    auto outStream = makeSharedOutStream();
+    auto encoder = makeSharedEncoder(outStream, plzma_file_type_xz, plzma_method_LZMA2);
+    encoder->setCompressionLevel(1);
+    encoder->setBlockSize(256 * 1024);
+    encoder->add(makeSharedInStream(static_cast<const void *>(content), contentSize), Path("item"));
+    PLZMA_TESTS_ASSERT(encoder->open() == true)
+    PLZMA_TESTS_ASSERT(encoder->compress() == true)
+    const auto archive = outStream->copyContent();
+    PLZMA_TESTS_ASSERT(archive.second > 0)
+    
+    bool thrown = false;
+    try {
+        makeSharedInStream(SharedPtr<InStream>(), 64 * 1024, 4);
+    } catch (const Exception & exception) {
+        thrown = exception.code() == plzma_error_code_invalid_arguments;
+    }
+    PLZMA_TESTS_ASSERT(thrown)
+    
+    // The same content via the slow stream and via the read ahead of the slow stream.
+    TestSlowStream slowStreams[2];
+    std::chrono::steady_clock::duration durations[2];
+    for (size_t i = 0; i < 2; i++) {
+        TestSlowStream * context = &slowStreams[i];
+        context->memory = static_cast<const uint8_t *>(archive.first);
+        context->size = archive.second;
+        context->offset = context->readSize = 0;
+        auto stream = makeSharedInStream(testSlowStreamOpen, testSlowStreamClose, testSlowStreamSeek, testSlowStreamRead, plzma_context{context, nullptr});
+        if (i == 1) {
+            stream = makeSharedInStream(stream, 64 * 1024, 8);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        int ret = test_plzma_streams_read_ahead_extract(stream, plzma_file_type_xz, content, contentSize);
+        if (ret) {
+            return ret;
+        }
+        durations[i] = std::chrono::steady_clock::now() - start;
+    }
+    std::cout << "extract xz, slow stream: " << std::chrono::duration_cast<std::chrono::milliseconds>(durations[0]).count()
+              << " ms, read ahead: " << std::chrono::duration_cast<std::chrono::milliseconds>(durations[1]).count() << " ms" << std::endl;
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+    PLZMA_TESTS_ASSERT(slowStreams[0].readThread == std::this_thread::get_id())
+    PLZMA_TESTS_ASSERT(slowStreams[1].readThread != std::this_thread::get_id())
+#endif
+    
+    // The seeks of the random access stream between the blocks.
+    auto stream = makeSharedInStream(makeSharedInStream(static_cast<const void *>(archive.first), archive.second), 16 * 1024, 4);
+    auto decoder = makeSharedDecoder(stream, plzma_file_type_xz);
+    PLZMA_TESTS_ASSERT(decoder->open() == true)
+    auto randomAccessStream = decoder->openRandomAccessStream();
+    PLZMA_TESTS_ASSERT(randomAccessStream)
+    RawHeapMemory buffer(64 * 1024);
+    const size_t offsets[] = { 2 * 1024 * 1024 + 5, 100, contentSize - 1000, 1024 * 1024 - 7, 300 * 1024 };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        const size_t expected = (contentSize - offsets[i] < 64 * 1024) ? contentSize - offsets[i] : 64 * 1024;
+        PLZMA_TESTS_ASSERT(randomAccessStream->pread(static_cast<void *>(buffer), 64 * 1024, offsets[i]) == expected)
+        PLZMA_TESTS_ASSERT(memcmp(static_cast<const void *>(buffer), static_cast<const uint8_t *>(content) + offsets[i], expected) == 0)
+    }
+    
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+    plzma_in_stream cStream = plzma_in_stream_create_with_memory_copy(static_cast<const void *>(archive.first), archive.second);
+    plzma_in_stream cReadAheadStream = plzma_in_stream_create_read_ahead(&cStream, 32 * 1024, 2);
+    plzma_in_stream_release(&cStream);
+    PLZMA_TESTS_ASSERT(cReadAheadStream.exception == nullptr && cReadAheadStream.object != nullptr)
+    SharedPtr<InStream> streamSPtr(static_cast<InStream *>(cReadAheadStream.object));
+    plzma_in_stream_release(&cReadAheadStream);
+    PLZMA_TESTS_ASSERT(test_plzma_streams_read_ahead_extract(streamSPtr, plzma_file_type_xz, content, contentSize) == 0)
+#endif
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << plzma_version() << std::endl;
     int ret = 0;
@@ -46,5 +382,36 @@ int main(int argc, char* argv[]) {
         return ret;
     }
     
+    try {
+        if ( (ret = test_plzma_streams_out_mem_capacity()) ) {
+            return ret;
+        }
+        if ( (ret = test_plzma_streams_mmap()) ) {
+            return ret;
+        }
+        if ( (ret = test_plzma_streams_file_clones()) ) {
+            return ret;
+        }
+        if ( (ret = test_plzma_streams_file_reopen()) ) {
+            return ret;
+        }
+        if ( (ret = test_plzma_streams_read_ahead()) ) {
+            return ret;
+        }
+    } catch (const Exception & e) {
+        std::cout << "PLZMA Exception [" << e.code() << "]:" << std::endl;
+        if (e.what()) {
+            std::cout << "what: " << e.what() << std::endl;
+        }
+        if (e.reason()) {
+            std::cout << "reason: " << e.reason() << std::endl;
+        }
+        if (e.file()) {
+            std::cout << "file: " << e.file() << std::endl;
+        }
+        std::cout << "line: " << e.line() << std::endl;
+        throw;
+    }
+    
     return ret;
 }
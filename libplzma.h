@@ -226,6 +226,20 @@ typedef enum plzma_open_dir_mode {
 } plzma_open_dir_mode;
 
 
+/// @brief The mode of reading the content of the input file stream.
+typedef enum plzma_in_stream_mode {
+    /// @brief The file content is read with the buffered file functions, i.e. \a fread and \a fseek.
+    plzma_in_stream_mode_default    = 0,
+    
+    /// @brief The file is mapped into memory and the content is copied directly from the mapping.
+    ///
+    /// Avoids the stdio buffering and provides the access pattern hints to the system.
+    /// Falls back to the \a plzma_in_stream_mode_default mode if the file can't be mapped, i.e. empty file or
+    /// memory mapping is not supported by the platform.
+    plzma_in_stream_mode_mmap       = 1
+} plzma_in_stream_mode;
+
+
 typedef enum plzma_plzma_multi_stream_part_name_format {
     /// @brief "File"."Extension"."002". The maximum number of parts is 999.
     plzma_plzma_multi_stream_part_name_format_name_ext_00x   = 1
@@ -347,8 +361,11 @@ typedef plzma_object plzma_out_stream;
 typedef plzma_object plzma_out_stream_array;
 typedef plzma_object plzma_out_multi_stream;
 typedef plzma_object plzma_item_array;
+typedef plzma_object plzma_item_table;
 typedef plzma_object plzma_item_out_stream_array;
 typedef plzma_object plzma_decoder;
+typedef plzma_object plzma_item_stream;
+typedef plzma_object plzma_random_access_stream;
 typedef plzma_object plzma_encoder;
 
 typedef uint32_t plzma_size_t; // limited to 32 bit unsigned integer.
@@ -569,6 +586,20 @@ LIBPLZMA_C_API(plzma_size_t) plzma_decoder_write_size(void);
 /// @note The lower value requires less amount of allocated memory, but increases the number of write requests and vice versa.
 LIBPLZMA_C_API(void) plzma_set_decoder_write_size(const plzma_size_t size);
 
+
+/// @brief Receives the maximum number of the parsed 7z archive headers kept in the process-wide index cache.
+///
+/// The decoder opening the same archive again copies the cached header instead of reading and decoding it.
+/// The archive is identified by it's signature header, which contains the CRC of the header, and the stream size.
+/// The archives with encrypted headers are never cached. Default is 0, the cache is disabled.
+LIBPLZMA_C_API(plzma_size_t) plzma_index_cache_capacity(void);
+
+
+/// @brief Changes the maximum number of the parsed 7z archive headers kept in the process-wide index cache.
+/// @see Function \a plzma_index_cache_capacity.
+/// @note The least recently used headers are evicted. Zero disables the cache and frees all cached headers.
+LIBPLZMA_C_API(void) plzma_set_index_cache_capacity(const plzma_size_t capacity);
+
 /// Object
 
 /// @brief Releases optional \a exception of the generic object.
@@ -919,6 +950,15 @@ LIBPLZMA_C_API(plzma_in_stream) plzma_in_stream_create_with_path(const plzma_pat
 LIBPLZMA_C_API(plzma_in_stream) plzma_in_stream_create_with_pathm(plzma_path * LIBPLZMA_NONNULL path);
 
 
+/// @brief Creates the input file stream object with path and reading mode.
+/// @param path The non-empty input file path.
+/// @param mode The mode of reading the file content.
+/// @return The input stream or null, if exception was thrown.
+/// @note Call \a plzma_in_stream_release function to release the input file stream.
+/// @note The stream is ARC object.
+LIBPLZMA_C_API(plzma_in_stream) plzma_in_stream_create_with_path_mode(const plzma_path * LIBPLZMA_NONNULL path, const plzma_in_stream_mode mode);
+
+
 /// @brief Creates the input file stream object with the file memory content.
 /// During the creation, the memory will copyed.
 /// @param memory The file memory content.
@@ -970,6 +1010,23 @@ LIBPLZMA_C_API(plzma_in_stream) plzma_in_stream_create_with_callbacks(plzma_in_s
 LIBPLZMA_C_API(plzma_in_stream) plzma_in_stream_create_with_stream_arraym(plzma_in_stream_array * LIBPLZMA_NONNULL stream_array);
 
 
+/// @brief Creates the input stream object which reads the content of the source stream ahead in a separate thread.
+///
+/// The thread reads up to \a chunks_count chunks after the current position, so the reading of the source stream
+/// overlaps with the decoding. The seek outside of the read ahead content drops the chunks.
+/// The memory usage is limited to \a chunk_size * \a chunks_count bytes while the stream is opened.
+/// @param stream The source input stream.
+/// @param chunk_size The size of the chunk in bytes, less than 4GB.
+/// @param chunks_count The maximum number of the read ahead chunks.
+/// @return The input stream object or null, if exception was thrown.
+/// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the chunk size or the number of chunks is zero.
+/// @note Call \a plzma_in_stream_release function to release the input stream.
+/// @note The stream is ARC object.
+LIBPLZMA_C_API(plzma_in_stream) plzma_in_stream_create_read_ahead(plzma_in_stream * LIBPLZMA_NONNULL stream,
+                                                                  const size_t chunk_size,
+                                                                  const plzma_size_t chunks_count);
+
+
 /// @return Checks the input file stream is opened.
 /// @note Thread-safe.
 LIBPLZMA_C_API(bool) plzma_in_stream_opened(plzma_in_stream * LIBPLZMA_NONNULL stream);
@@ -1033,6 +1090,14 @@ LIBPLZMA_C_API(plzma_out_stream) plzma_out_stream_create_with_pathm(plzma_path *
 LIBPLZMA_C_API(plzma_out_stream) plzma_out_stream_create_memory_stream(void);
 
 
+/// @brief Creates the output file stream object for writing to memory with initial capacity.
+/// @param initial_capacity The number of bytes to reserve for the content of the stream.
+/// @return The output file stream or null, if exception was thrown.
+/// @note Call \a plzma_out_stream_release function to release the output stream.
+/// @note The stream is ARC object.
+LIBPLZMA_C_API(plzma_out_stream) plzma_out_stream_create_memory_stream_with_capacity(const size_t initial_capacity);
+
+
 /// @return Checks the output file stream is opened.
 /// @note Thread-safe.
 LIBPLZMA_C_API(bool) plzma_out_stream_opened(plzma_out_stream * LIBPLZMA_NULLABLE stream);
@@ -1055,6 +1120,34 @@ LIBPLZMA_C_API(bool) plzma_out_stream_erase(plzma_out_stream * LIBPLZMA_NONNULL
 LIBPLZMA_C_API(plzma_memory) plzma_out_stream_copy_content(plzma_out_stream * LIBPLZMA_NONNULL stream);
 
 
+/// @brief Takes the content of the stream without copying.
+///
+/// The stream must be closed. Use \a plzma_out_stream_opened to ckeck.
+/// The memory stream moves out it's heap memory and becomes empty, the content of other streams is copied.
+/// @return The heap memory with the stream's content. In case if stream is opened
+/// or exception was thrown, the \a memory & \a size are null/0.
+/// @note Use \a plzma_free to release the heap memory.
+/// @note Thread-safe.
+LIBPLZMA_C_API(plzma_memory) plzma_out_stream_take_content(plzma_out_stream * LIBPLZMA_NONNULL stream);
+
+
+/// @brief Provides the read-only access to the content of the memory stream.
+///
+/// The stream must be closed. The content is valid while the stream is alive, not reopened, erased or it's content is not taken.
+/// @param size The optional pointer to the size of the content.
+/// @return The pointer to the stream's content or null, if stream is opened, empty, is not a memory stream or exception was thrown.
+/// @note Thread-safe.
+LIBPLZMA_C_API(const void * LIBPLZMA_NULLABLE) plzma_out_stream_content_view(plzma_out_stream * LIBPLZMA_NONNULL stream, size_t * LIBPLZMA_NULLABLE size);
+
+
+/// @brief Reserves the memory for the content of the memory stream.
+///
+/// Does nothing for the file streams.
+/// @param size The number of bytes to reserve.
+/// @note Thread-safe.
+LIBPLZMA_C_API(void) plzma_out_stream_reserve(plzma_out_stream * LIBPLZMA_NONNULL stream, const uint64_t size);
+
+
 /// @brief Releases the output stream object.
 LIBPLZMA_C_API(void) plzma_out_stream_release(plzma_out_stream * LIBPLZMA_NONNULL stream);
 
@@ -1178,6 +1271,62 @@ LIBPLZMA_C_API(void) plzma_item_array_sort(plzma_item_array * LIBPLZMA_NONNULL a
 /// @brief Releases the array object and all items inside.
 LIBPLZMA_C_API(void) plzma_item_array_release(plzma_item_array * LIBPLZMA_NONNULL array);
 
+/// Item table
+
+/// @return The number of items inside the table.
+LIBPLZMA_C_API(plzma_size_t) plzma_item_table_count(const plzma_item_table * LIBPLZMA_NONNULL table);
+
+
+/// @brief Receives the item's path inside the archive without copying.
+/// @param index The index of the item. Must be less than the number of items, i.e. the value of the \a plzma_item_table_count function.
+/// @param length The optional length of the path in bytes.
+/// @return The null-terminated UTF-8 path, valid as long as the table exists.
+LIBPLZMA_C_API(const char * LIBPLZMA_NULLABLE) plzma_item_table_path_utf8(const plzma_item_table * LIBPLZMA_NONNULL table,
+                                                                          const plzma_size_t index,
+                                                                          size_t * LIBPLZMA_NULLABLE length);
+
+
+/// @return Receives the size in bytes of the item at index.
+LIBPLZMA_C_API(uint64_t) plzma_item_table_size(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @return Receives the packed size in bytes of the item at index.
+LIBPLZMA_C_API(uint64_t) plzma_item_table_pack_size(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @return Receives the CRC-32 checksum of the item's content at index.
+LIBPLZMA_C_API(uint32_t) plzma_item_table_crc32(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @return The creation time of the item at index. Unix timestamp.
+LIBPLZMA_C_API(time_t) plzma_item_table_creation_time(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @return The last access time of the item at index. Unix timestamp.
+LIBPLZMA_C_API(time_t) plzma_item_table_access_time(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @return The last modification time of the item at index. Unix timestamp.
+LIBPLZMA_C_API(time_t) plzma_item_table_modification_time(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @return Checks the item at index is encrypted or not.
+LIBPLZMA_C_API(bool) plzma_item_table_encrypted(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @return Checks the item at index is directory or file.
+LIBPLZMA_C_API(bool) plzma_item_table_is_dir(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @brief Creates the retained item with the properties at index, i.e. for extracting or testing selected items.
+/// @return The retained item or null if the index is out of range.
+/// @note Use \a plzma_item_release to release the item when no longer needed.
+LIBPLZMA_C_API(plzma_item) plzma_item_table_item_at(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index);
+
+
+/// @brief Releases the table object.
+LIBPLZMA_C_API(void) plzma_item_table_release(plzma_item_table * LIBPLZMA_NONNULL table);
+
 /// Item out stream array
 
 /// @brief Creates the array of item/out-stream pairs with optional capacity for a container.
@@ -1263,6 +1412,55 @@ LIBPLZMA_C_API(void) plzma_decoder_set_password_wide_string(plzma_decoder * LIBP
 LIBPLZMA_C_API(void) plzma_decoder_set_password_utf8_string(plzma_decoder * LIBPLZMA_NONNULL decoder, const char * LIBPLZMA_NULLABLE password);
 
 
+/// @brief Getter for a number of threads used by the coders.
+/// @return The number of threads or \a 0 which means all hardware threads.
+/// @note By default the value is \a 0.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint32_t) plzma_decoder_number_of_threads(plzma_decoder * LIBPLZMA_NONNULL decoder);
+
+
+/// @brief Setter for a number of threads used by the coders.
+/// @param threads The number of threads, \a 0 means all hardware threads.
+/// @note Has no effect if the library was built without 'LIBPLZMA_MULTITHREAD'.
+/// @note Thread-safe. Must be set before opening.
+LIBPLZMA_C_API(void) plzma_decoder_set_number_of_threads(plzma_decoder * LIBPLZMA_NONNULL decoder, const uint32_t threads);
+
+
+/// @brief Getter for a memory usage limit of the coders.
+/// @return The limit in bytes or \a 0 which means the default limit, a half of the physical memory.
+/// @note By default the value is \a 0.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint64_t) plzma_decoder_memory_limit(plzma_decoder * LIBPLZMA_NONNULL decoder);
+
+
+/// @brief Setter for a memory usage limit of the coders.
+///
+/// The multithreaded coders reduce the number of threads or fall back to a single thread
+/// to keep the memory usage below this limit.
+/// @param limit The limit in bytes, \a 0 means the default limit.
+/// @note Thread-safe. Must be set before opening.
+LIBPLZMA_C_API(void) plzma_decoder_set_memory_limit(plzma_decoder * LIBPLZMA_NONNULL decoder, const uint64_t limit);
+
+
+/// @brief Getter for a number of the extract workers.
+/// @return The number of workers, \a 0 means the number of hardware threads.
+/// @note By default the value is \a 1, i.e. the items are extracted sequentially.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint32_t) plzma_decoder_extract_workers(plzma_decoder * LIBPLZMA_NONNULL decoder);
+
+
+/// @brief Setter for a number of the extract workers.
+///
+/// The independent solid blocks(folders) of the 7z archive or the indexed blocks of the xz stream
+/// are extracted in parallel, each worker reads own copy of the input stream. The xz blocks are
+/// written to the output in order. Falls back to the sequential extraction if the input stream
+/// can't be copied(stream with callbacks), the archive has only one solid block, the xz stream
+/// has only one block or the type of the archive is tar.
+/// @param workers The number of workers, \a 0 means the number of hardware threads.
+/// @note Thread-safe. Must be set before extracting.
+LIBPLZMA_C_API(void) plzma_decoder_set_extract_workers(plzma_decoder * LIBPLZMA_NONNULL decoder, const uint32_t workers);
+
+
 /// @brief Opens the archive.
 ///
 /// During the process, the decoder is self-retained as long as the operation is in progress.
@@ -1294,6 +1492,16 @@ LIBPLZMA_C_API(plzma_size_t) plzma_decoder_count(plzma_decoder * LIBPLZMA_NONNUL
 LIBPLZMA_C_API(plzma_item_array) plzma_decoder_items(plzma_decoder * LIBPLZMA_NONNULL decoder);
 
 
+/// @brief Receives the columnar list of all archive items.
+///
+/// Preferred for listing and filtering the archives with a large number of items.
+/// @return Retained table with items.
+/// @note Use \a plzma_item_table_release to release the table when it's no longer needed.
+/// @note The decoder must be opened.
+/// @note Thread-safe.
+LIBPLZMA_C_API(plzma_item_table) plzma_decoder_item_table(plzma_decoder * LIBPLZMA_NONNULL decoder);
+
+
 /// @brief Receives single, retained archive item at a specific index.
 /// @param index The index of the item inside the arhive. Must be less then the number of items reported by the \a plzma_decoder_count fundtion.
 /// @return Retained item.
@@ -1303,6 +1511,29 @@ LIBPLZMA_C_API(plzma_item_array) plzma_decoder_items(plzma_decoder * LIBPLZMA_NO
 LIBPLZMA_C_API(plzma_item) plzma_decoder_item_at(plzma_decoder * LIBPLZMA_NONNULL decoder, const plzma_size_t index);
 
 
+/// @brief Receives single, retained archive item by it's path inside the archive.
+///
+/// The hash index of all item paths is created on the first call, the next lookups don't scan the items.
+/// @param path The item's path inside the archive.
+/// @return Retained item or item with \a NULL object if the archive has no item with such path.
+/// @note Use \a plzma_item_release to release the item when it's no longer needed.
+/// @note The decoder must be opened.
+/// @note Thread-safe.
+LIBPLZMA_C_API(plzma_item) plzma_decoder_item_at_path(plzma_decoder * LIBPLZMA_NONNULL decoder, const plzma_path * LIBPLZMA_NONNULL path);
+
+
+/// @brief Receives the retained array of archive items by their paths inside the archive.
+/// @param paths The array of the item paths.
+/// @param count The number of paths.
+/// @return Retained array with the found items in order of paths, the missed paths are skipped.
+/// @note Use \a plzma_item_array_release to release the array when it's no longer needed.
+/// @note The decoder must be opened.
+/// @note Thread-safe.
+LIBPLZMA_C_API(plzma_item_array) plzma_decoder_items_at_paths(plzma_decoder * LIBPLZMA_NONNULL decoder,
+                                                              const plzma_path * LIBPLZMA_NULLABLE paths,
+                                                              const plzma_size_t count);
+
+
 /// @brief Extracts all archive items to a specific path.
 ///
 /// During the process, the decoder is self-retained as long as the operation is in progress.
@@ -1331,6 +1562,25 @@ LIBPLZMA_C_API(bool) plzma_decoder_extract_items_to_path(plzma_decoder * LIBPLZM
                                                          const bool items_full_path);
 
 
+/// @brief Extracts the archive items with paths matching the wildcard pattern to a specific path.
+///
+/// The items are selected from the paths inside the archive without creating the item objects.
+/// During the process, the decoder is self-retained as long as the operation is in progress.
+/// @param pattern The UTF-8 wildcard pattern. The '*' matches any sequence of characters including separators,
+/// the '?' matches a single character. The pattern of a directory, i.e. 'assets/textures/', matches all items inside it.
+/// @param path The directory path to extract the matched items.
+/// @param items_full_path Exctract item using it's full path or only the last path component.
+/// @return \a false if the decoder is not opened.
+/// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the decoder is extracting or testing.
+/// @note The extracting progress might be executed in a separate thread.
+/// @note The extracting progress might be aborted via \a plzma_decoder_abort function.
+/// @note Thread-safe.
+LIBPLZMA_C_API(bool) plzma_decoder_extract_matching_items_to_path(plzma_decoder * LIBPLZMA_NONNULL decoder,
+                                                                  const char * LIBPLZMA_NONNULL pattern,
+                                                                  const plzma_path * LIBPLZMA_NONNULL path,
+                                                                  const bool items_full_path);
+
+
 /// @brief Extracts each archive item to a separate out-stream.
 ///
 /// During the process, the decoder is self-retained as long as the operation is in progress.
@@ -1353,6 +1603,20 @@ LIBPLZMA_C_API(bool) plzma_decoder_test_items(plzma_decoder * LIBPLZMA_NONNULL d
                                               plzma_item_array * LIBPLZMA_NONNULL items);
 
 
+/// @brief Tests the archive items with paths matching the wildcard pattern.
+///
+/// During the process, the decoder is self-retained as long as the operation is in progress.
+/// @param pattern The UTF-8 wildcard pattern.
+/// @return \a false if the decoder is not opened.
+/// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the decoder is extracting or testing.
+/// @note The testing progress might be executed in a separate thread.
+/// @note The testing progress might be aborted via \a plzma_decoder_abort function.
+/// @note Thread-safe.
+/// @see \a plzma_decoder_extract_matching_items_to_path function.
+LIBPLZMA_C_API(bool) plzma_decoder_test_matching_items(plzma_decoder * LIBPLZMA_NONNULL decoder,
+                                                       const char * LIBPLZMA_NONNULL pattern);
+
+
 /// @brief Tests all archive items.
 ///
 /// During the process, the decoder is self-retained as long as the operation is in progress.
@@ -1362,6 +1626,117 @@ LIBPLZMA_C_API(bool) plzma_decoder_test_items(plzma_decoder * LIBPLZMA_NONNULL d
 LIBPLZMA_C_API(bool) plzma_decoder_test(plzma_decoder * LIBPLZMA_NONNULL decoder);
 
 
+/// @brief Opens the stream for reading the decoded content of a single archive item.
+///
+/// The stream reads own copy of the input stream. The xz and tar items are read directly from the archive,
+/// the 7z items are decoded in a separate thread through a bounded buffer or from the nearest checkpoint
+/// found by the \a plzma_decoder_build_checkpoints function. In case if the input stream can't be copied(stream with callbacks),
+/// the item is extracted to memory before reading.
+/// @param item The archive item.
+/// @return The item stream or null, if the decoder is not opened or exception was thrown.
+/// @note Call \a plzma_item_stream_release function to release the item stream.
+/// @note Thread-safe.
+LIBPLZMA_C_API(plzma_item_stream) plzma_decoder_open_item_stream(plzma_decoder * LIBPLZMA_NONNULL decoder,
+                                                                 plzma_item * LIBPLZMA_NONNULL item);
+
+
+/// @brief Finds the checkpoints of the solid LZMA2 folders of the 7z archive.
+///
+/// The checkpoint is the point where the LZMA2 encoder reset the dictionary, i.e. the start of each LZMA2 block.
+/// Only the chunk headers are read, without decoding. The item streams opened after this call start decoding
+/// from the nearest checkpoint before the item instead of the start of the solid folder.
+/// @return The number of found checkpoints or \a 0 if the archive type is not 7z or there are no solid LZMA2 folders
+/// with more than one block.
+/// @note The decoder must be opened.
+/// @note Thread-safe.
+LIBPLZMA_C_API(plzma_size_t) plzma_decoder_build_checkpoints(plzma_decoder * LIBPLZMA_NONNULL decoder);
+
+
+/// @brief Opens the stream for reading the decoded content of the xz archive at any offset.
+///
+/// The stream reads own copy of the input stream and decodes only the xz blocks with the requested range.
+/// The multi-block xz archives can be created via the \a plzma_encoder_set_block_size function.
+/// @return The random access stream or null, if the decoder is not opened, the archive type is not xz,
+/// the xz stream has no index of the blocks, the input stream can't be copied(stream with callbacks) or exception was thrown.
+/// @note Call \a plzma_random_access_stream_release function to release the random access stream.
+/// @note Thread-safe.
+LIBPLZMA_C_API(plzma_random_access_stream) plzma_decoder_open_random_access_stream(plzma_decoder * LIBPLZMA_NONNULL decoder);
+
+
+/// @brief Reads the next portion of the decoded content of the item.
+///
+/// Waits until some content is decoded.
+/// @param buffer The buffer to read to.
+/// @param size The size of the buffer in bytes.
+/// @return The number of bytes read, \a 0 means the end of the content, the stream is closed or exception was thrown.
+/// @note Read from a single thread.
+LIBPLZMA_C_API(size_t) plzma_item_stream_read(plzma_item_stream * LIBPLZMA_NONNULL stream,
+                                              void * LIBPLZMA_NONNULL buffer,
+                                              const size_t size);
+
+
+/// @brief Stops the decoding and closes the item stream.
+/// @note Thread-safe.
+LIBPLZMA_C_API(void) plzma_item_stream_close(plzma_item_stream * LIBPLZMA_NONNULL stream);
+
+
+/// @return The archive item of the stream.
+/// @note Thread-safe.
+LIBPLZMA_C_API(plzma_item) plzma_item_stream_item(plzma_item_stream * LIBPLZMA_NONNULL stream);
+
+
+/// @brief Releases the item stream object.
+LIBPLZMA_C_API(void) plzma_item_stream_release(plzma_item_stream * LIBPLZMA_NONNULL stream);
+
+
+/// @return The size of the decoded content in bytes.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint64_t) plzma_random_access_stream_size(plzma_random_access_stream * LIBPLZMA_NONNULL stream);
+
+
+/// @return The current position of the \a plzma_random_access_stream_read function.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint64_t) plzma_random_access_stream_position(plzma_random_access_stream * LIBPLZMA_NONNULL stream);
+
+
+/// @brief Moves the current position of the \a plzma_random_access_stream_read function.
+/// @param offset The offset from the start of the content.
+/// @note Thread-safe.
+LIBPLZMA_C_API(void) plzma_random_access_stream_seek(plzma_random_access_stream * LIBPLZMA_NONNULL stream,
+                                                     const uint64_t offset);
+
+
+/// @brief Reads the decoded content from the current position and moves the position.
+/// @param buffer The buffer to read to.
+/// @param size The size of the buffer in bytes.
+/// @return The number of bytes read, \a 0 means the end of the content, the stream is closed or exception was thrown.
+/// @note Thread-safe.
+LIBPLZMA_C_API(size_t) plzma_random_access_stream_read(plzma_random_access_stream * LIBPLZMA_NONNULL stream,
+                                                       void * LIBPLZMA_NONNULL buffer,
+                                                       const size_t size);
+
+
+/// @brief Reads the decoded content from the offset without changing the current position.
+/// @param buffer The buffer to read to.
+/// @param size The size of the buffer in bytes.
+/// @param offset The offset from the start of the content.
+/// @return The number of bytes read, \a 0 means the end of the content, the stream is closed or exception was thrown.
+/// @note Thread-safe.
+LIBPLZMA_C_API(size_t) plzma_random_access_stream_pread(plzma_random_access_stream * LIBPLZMA_NONNULL stream,
+                                                        void * LIBPLZMA_NONNULL buffer,
+                                                        const size_t size,
+                                                        const uint64_t offset);
+
+
+/// @brief Closes the random access stream and releases the cached blocks.
+/// @note Thread-safe.
+LIBPLZMA_C_API(void) plzma_random_access_stream_close(plzma_random_access_stream * LIBPLZMA_NONNULL stream);
+
+
+/// @brief Releases the random access stream object.
+LIBPLZMA_C_API(void) plzma_random_access_stream_release(plzma_random_access_stream * LIBPLZMA_NONNULL stream);
+
+
 /// @brief Relases the decoder object.
 LIBPLZMA_C_API(void) plzma_decoder_release(plzma_decoder * LIBPLZMA_NONNULL decoder);
 
@@ -1438,6 +1813,21 @@ LIBPLZMA_C_API(bool) plzma_encoder_should_create_solid_archive(plzma_encoder * L
 LIBPLZMA_C_API(void) plzma_encoder_set_should_create_solid_archive(plzma_encoder * LIBPLZMA_NONNULL encoder, const bool solid);
 
 
+/// @brief Should encoder group the similar items of the 7z archive and choose the filters by the item content.
+/// @note Disabled by default, the value is \a false.
+/// @note Thread-safe.
+LIBPLZMA_C_API(bool) plzma_encoder_should_use_smart_solid(plzma_encoder * LIBPLZMA_NONNULL encoder);
+
+
+/// @brief Set encoder will group the similar items of the 7z archive and choose the filters by the item content.
+///
+/// The items are sorted by the type, i.e. by extension, so the similar content is next to each other in the solid block.
+/// The beginning of each file is analyzed to apply the executable(BCJ, ARM, etc.) or the Delta(wav) filters to the
+/// group of the detected items. The added streams are not analyzed.
+/// @note Thread-safe. Must be set before opening.
+LIBPLZMA_C_API(void) plzma_encoder_set_should_use_smart_solid(plzma_encoder * LIBPLZMA_NONNULL encoder, const bool smart);
+
+
 /// @brief Getter for a compression level.
 /// @return The level in a range [0; 9].
 /// @note Thread-safe.
@@ -1450,6 +1840,75 @@ LIBPLZMA_C_API(uint8_t) plzma_encoder_compression_level(plzma_encoder * LIBPLZMA
 LIBPLZMA_C_API(void) plzma_encoder_set_compression_level(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint8_t level);
 
 
+/// @brief Getter for a number of threads used by the coders.
+/// @return The number of threads or \a 0 which means all hardware threads.
+/// @note By default the value is \a 0.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint32_t) plzma_encoder_number_of_threads(plzma_encoder * LIBPLZMA_NONNULL encoder);
+
+
+/// @brief Setter for a number of threads used by the coders.
+/// @param threads The number of threads, \a 0 means all hardware threads.
+/// @note Has no effect if the library was built without 'LIBPLZMA_MULTITHREAD'.
+/// @note Thread-safe. Must be set before opening.
+LIBPLZMA_C_API(void) plzma_encoder_set_number_of_threads(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint32_t threads);
+
+
+/// @brief Getter for a block size of the LZMA2 compression.
+/// @return The size in bytes or \a 0 which means the default size of the coder.
+/// @note By default the value is \a 0.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint64_t) plzma_encoder_block_size(plzma_encoder * LIBPLZMA_NONNULL encoder);
+
+
+/// @brief Setter for a block size of the LZMA2 compression.
+///
+/// The xz stream is split to the independent blocks of this size, listed in the xz index.
+/// Such blocks are compressed in parallel by the multithreaded coder and can be decoded
+/// in parallel by the extract workers of the decoder. The 7z LZMA2 stream resets
+/// the dictionary after each block, the multithreaded LZMA2 coder compresses the blocks
+/// in parallel and the decoder's checkpoints are placed at the block starts.
+/// Has no effect for the other 7z methods.
+/// @param size The size in bytes, \a 0 means the default size of the coder.
+/// @note Thread-safe. Must be set before opening.
+LIBPLZMA_C_API(void) plzma_encoder_set_block_size(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint64_t size);
+
+
+/// @brief Getter for a maximum size of the solid block of the 7z archive.
+/// @return The size in bytes or \a 0 which means the default size for the compression method and level.
+/// @note By default the value is \a 0.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint64_t) plzma_encoder_solid_block_size(plzma_encoder * LIBPLZMA_NONNULL encoder);
+
+
+/// @brief Setter for a maximum size of the solid block of the 7z archive.
+///
+/// The items are compressed to the solid blocks(folders) of the limited unpacked size.
+/// The smaller blocks decrease the ratio, but the item is decoded from the start of own block
+/// and the blocks can be decoded in parallel by the extract workers of the decoder.
+/// Has no effect if the archive is not solid. The items added by \a plzma_encoder_add_push_item are counted as 64 MiB each,
+/// so a limit less than 64 MiB places each of them to own block.
+/// @param size The size in bytes, \a 0 means the default size for the compression method and level.
+/// @note Thread-safe. Must be set before opening.
+LIBPLZMA_C_API(void) plzma_encoder_set_solid_block_size(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint64_t size);
+
+
+/// @brief Getter for a maximum number of items in the solid block of the 7z archive.
+/// @return The number of items or \a 0 which means unlimited.
+/// @note By default the value is \a 0.
+/// @note Thread-safe.
+LIBPLZMA_C_API(uint32_t) plzma_encoder_solid_block_file_count(plzma_encoder * LIBPLZMA_NONNULL encoder);
+
+
+/// @brief Setter for a maximum number of items in the solid block of the 7z archive.
+///
+/// Applied together with the solid block size, the block is finished when any of the limits is reached.
+/// Has no effect if the archive is not solid.
+/// @param count The number of items, \a 0 means unlimited.
+/// @note Thread-safe. Must be set before opening.
+LIBPLZMA_C_API(void) plzma_encoder_set_solid_block_file_count(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint32_t count);
+
+
 /// @brief Should encoder compress the archive header.
 /// @note Enabled by default, the value is \a true.
 /// @note Thread-safe.
@@ -1557,6 +2016,47 @@ LIBPLZMA_C_API(void) plzma_encoder_add_stream(plzma_encoder * LIBPLZMA_NONNULL e
                                               const plzma_path * LIBPLZMA_NONNULL archive_path);
 
 
+/// @brief Adds the item which content is pushed during the compression, the size of the content is not required.
+///
+/// The content is pushed from the other thread than \a plzma_encoder_compress via \a plzma_encoder_begin_item,
+/// \a plzma_encoder_write and \a plzma_encoder_end_item functions. These functions never set the exception of the encoder
+/// object, the failure of the pushing stops the compression and the exception is reported by \a plzma_encoder_compress.
+/// The size of the item is unknown before pushing, the 7z solid block size limit(see \a plzma_encoder_set_solid_block_size)
+/// counts each push item as 64 MiB regardless of the pushed content.
+/// @param archive_path The path of how the item will be presented in archive. Empty path is not allowed.
+/// @note Thread-safe. Must be added before opening.
+LIBPLZMA_C_API(void) plzma_encoder_add_push_item(plzma_encoder * LIBPLZMA_NONNULL encoder,
+                                                 const plzma_path * LIBPLZMA_NONNULL archive_path);
+
+
+/// @brief Begins pushing the content of the previously added push item.
+///
+/// The encoder reads the items in own order, i.e. the 7z archive sorts the items by the archive path.
+/// The memory usage is bounded if the items are pushed in the same order, otherwise the pushed content
+/// is buffered until the encoder reads the item.
+/// @param archive_path The archive path of the item, provided by \a plzma_encoder_add_push_item.
+/// @return \a false if the encoder finished, aborted or the pushing failed, otherwise \a true.
+/// @note Thread-safe. The items must be pushed one by one from a single thread.
+LIBPLZMA_C_API(bool) plzma_encoder_begin_item(plzma_encoder * LIBPLZMA_NONNULL encoder,
+                                              const plzma_path * LIBPLZMA_NONNULL archive_path);
+
+
+/// @brief Pushes the next portion of the content of the begun item.
+///
+/// Waits while the encoder reads the previously pushed content.
+/// @return \a false if the encoder finished, aborted or the pushing failed, otherwise \a true.
+/// @note Thread-safe.
+LIBPLZMA_C_API(bool) plzma_encoder_write(plzma_encoder * LIBPLZMA_NONNULL encoder,
+                                         const void * LIBPLZMA_NONNULL data,
+                                         const size_t size);
+
+
+/// @brief Ends pushing the content of the begun item.
+/// @return \a false if the encoder finished, aborted or the pushing failed, otherwise \a true.
+/// @note Thread-safe.
+LIBPLZMA_C_API(bool) plzma_encoder_end_item(plzma_encoder * LIBPLZMA_NONNULL encoder);
+
+
 /// @brief Opens the encoder for compressing.
 ///
 /// During the process, the encoder is self-retained as long as the operation is in progress.
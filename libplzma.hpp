@@ -31,6 +31,7 @@
 #include <cstddef>
 #include <cstdarg>
 #include <cstdlib>
+#include <new>
 
 #include "libplzma.h"
 
@@ -819,6 +820,96 @@ namespace plzma {
     template struct LIBPLZMA_CPP_CLASS_API SharedPtr<Item>;
     template struct LIBPLZMA_CPP_CLASS_API Pair<void *, size_t>;
     
+    /// @brief The read-only, columnar list of all archive items.
+    ///
+    /// The properties of the items are stored in the parallel arrays and the paths are stored
+    /// in a single UTF-8 buffer, so the listing doesn't create an object per item.
+    /// @note The getters expect the index less than the number of items, otherwise the default value is returned.
+    class LIBPLZMA_CPP_CLASS_API ItemTable {
+    private:
+        friend struct SharedPtr<ItemTable>;
+        plzma_size_t _referenceCounter = 0;
+        
+        void retain() noexcept;
+        void release() noexcept;
+        
+        ItemTable(ItemTable &&) = delete;
+        ItemTable & operator = (ItemTable &&) = delete;
+        ItemTable & operator = (const ItemTable &) = delete;
+        ItemTable(const ItemTable &) = delete;
+        ItemTable() = delete;
+        
+    protected:
+        RawHeapMemory _sizes;
+        RawHeapMemory _packSizes;
+        RawHeapMemory _times;       // creation, access and modification time of each item
+        RawHeapMemory _crcs;
+        RawHeapMemory _flags;
+        RawHeapMemory _pathOffsets; // count + 1 offsets inside the paths
+        RawHeapMemory _paths;       // null-terminated UTF-8 paths
+        size_t _pathsCapacity = 0;
+        plzma_size_t _count = 0;
+        
+        /// @brief Constructs the \a ItemTable instance with allocated columns for a number of items.
+        /// @param count The number of items.
+        ItemTable(const plzma_size_t count);
+        virtual ~ItemTable() noexcept = default;
+        
+    public:
+        /// @return Receives the number of items.
+        plzma_size_t count() const noexcept;
+        
+        
+        /// @brief Receives the item's path inside the archive without copying.
+        /// @param index The index of the item inside the archive.
+        /// @param length The optional length of the path in bytes.
+        /// @return The null-terminated UTF-8 path, valid as long as the table exists.
+        const char * LIBPLZMA_NONNULL pathUtf8(const plzma_size_t index, size_t * LIBPLZMA_NULLABLE length = nullptr) const noexcept;
+        
+        
+        /// @return Receives the item's path inside the archive.
+        Path path(const plzma_size_t index) const;
+        
+        
+        /// @return Receives the size in bytes of the item.
+        uint64_t size(const plzma_size_t index) const noexcept;
+        
+        
+        /// @return Receives the packed size in bytes of the item.
+        uint64_t packSize(const plzma_size_t index) const noexcept;
+        
+        
+        /// @return Receives the CRC-32 checksum of the item's content.
+        uint32_t crc32(const plzma_size_t index) const noexcept;
+        
+        
+        /// @return The creation time of the item. Unix timestamp.
+        time_t creationTime(const plzma_size_t index) const noexcept;
+        
+        
+        /// @return The last access time of the item. Unix timestamp.
+        time_t accessTime(const plzma_size_t index) const noexcept;
+        
+        
+        /// @return The last modification time of the item. Unix timestamp.
+        time_t modificationTime(const plzma_size_t index) const noexcept;
+        
+        
+        /// @return Checks the item is encrypted.
+        bool encrypted(const plzma_size_t index) const noexcept;
+        
+        
+        /// @return Checks the item is directory or file.
+        bool isDir(const plzma_size_t index) const noexcept;
+        
+        
+        /// @brief Creates the item with the properties at index, i.e. for extracting or testing selected items.
+        /// @return The new item or empty pointer if the index is out of range.
+        SharedPtr<Item> itemAt(const plzma_size_t index) const;
+    };
+    
+    template struct LIBPLZMA_CPP_CLASS_API SharedPtr<ItemTable>;
+    
     /// @brief Interface to the input file stream.
     class InStream {
     private:
@@ -859,6 +950,22 @@ namespace plzma {
     LIBPLZMA_CPP_API(SharedPtr<InStream>) makeSharedInStream(Path && path);
     
     
+    /// @brief Creates the input file stream with path and reading mode.
+    /// @param path The non-empty input file path.
+    /// @param mode The mode of reading the file content.
+    /// @return The shared pointer with input file stream.
+    /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if path is empty.
+    LIBPLZMA_CPP_API(SharedPtr<InStream>) makeSharedInStream(const Path & path, const plzma_in_stream_mode mode);
+    
+    
+    /// @brief Creates the input file stream with path and reading mode.
+    /// @param path The movable non-empty input file path.
+    /// @param mode The mode of reading the file content.
+    /// @return The shared pointer with input file stream.
+    /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if path is empty.
+    LIBPLZMA_CPP_API(SharedPtr<InStream>) makeSharedInStream(Path && path, const plzma_in_stream_mode mode);
+    
+    
     /// @brief Creates the input file stream with the file memory content.
     /// During the creation, the memory will copyed.
     /// @param memory The file memory content.
@@ -904,10 +1011,28 @@ namespace plzma {
     /// @return The shared pointer with input file stream.
     /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if streams list is empty or contains empty stream.
     LIBPLZMA_CPP_API(SharedPtr<InStream>) makeSharedInStream(InStreamArray && streams);
+    
+    
+    /// @brief Creates the input stream which reads the content of the source stream ahead in a separate thread.
+    ///
+    /// The thread reads up to \a chunksCount chunks after the current position, so the reading of the source stream
+    /// overlaps with the decoding. The seek outside of the read ahead content drops the chunks.
+    /// The memory usage is limited to \a chunkSize * \a chunksCount bytes while the stream is opened.
+    /// The copies of the stream, i.e. for the extract workers, also read ahead.
+    /// @param stream The source input stream.
+    /// @param chunkSize The size of the chunk in bytes, less than 4GB.
+    /// @param chunksCount The maximum number of the read ahead chunks.
+    /// @return The shared pointer with input stream or the source stream in case of thread-unsafe build.
+    /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the source stream is empty,
+    /// the chunk size or the number of chunks is zero.
+    LIBPLZMA_CPP_API(SharedPtr<InStream>) makeSharedInStream(const SharedPtr<InStream> & stream, const size_t chunkSize, const plzma_size_t chunksCount);
 
     template struct LIBPLZMA_CPP_CLASS_API Pair<RawHeapMemory, size_t, false>;
     typedef Pair<RawHeapMemory, size_t, false> RawHeapMemorySize;
     
+    template struct LIBPLZMA_CPP_CLASS_API Pair<const void *, size_t>;
+    typedef Pair<const void *, size_t> RawMemoryView;
+    
     /// @brief Interface to the output file or memory stream.
     class OutStream {
     protected:
@@ -938,6 +1063,35 @@ namespace plzma {
         /// @exception The \a Exception with \a plzma_error_code_not_enough_memory code in case if required amount of memory can't be allocated.
         /// @note Thread-safe.
         virtual RawHeapMemorySize copyContent() const = 0;
+        
+        
+        /// @brief Takes the content of the stream without copying.
+        ///
+        /// The stream must be closed. The memory stream moves out it's heap memory and becomes empty,
+        /// the content of other streams is copied, see \a copyContent.
+        /// @return The pair with heap memory with the stream's content.
+        /// @exception The \a Exception with \a plzma_error_code_not_enough_memory code in case if required amount of memory can't be allocated.
+        /// @note Thread-safe.
+        virtual RawHeapMemorySize takeContent() = 0;
+        
+        
+        /// @brief Provides the read-only access to the content of the memory stream.
+        ///
+        /// The stream must be closed. The view is valid while the stream is alive, not reopened, erased or it's content is not taken.
+        /// @return The pair with the pointer to the stream's content and it's size.
+        /// In case if the stream is opened, empty or is not a memory stream, the pointer & size are null/0.
+        /// @note Thread-safe.
+        virtual RawMemoryView contentView() const = 0;
+        
+        
+        /// @brief Reserves the memory for the content of the memory stream.
+        ///
+        /// Helps to avoid reallocations in case if the expected size of the content is known.
+        /// Does nothing for the file streams.
+        /// @param size The number of bytes to reserve.
+        /// @exception The \a Exception with \a plzma_error_code_not_enough_memory code in case if required amount of memory can't be allocated.
+        /// @note Thread-safe.
+        virtual void reserve(const uint64_t size) = 0;
     };
     
     template struct LIBPLZMA_CPP_CLASS_API SharedPtr<OutStream>;
@@ -960,6 +1114,13 @@ namespace plzma {
     /// @return The output file stream.
     LIBPLZMA_CPP_API(SharedPtr<OutStream>) makeSharedOutStream(void);
     
+    
+    /// @brief Creates the output file stream object for writing to memory with initial capacity.
+    /// @param initialCapacity The number of bytes to reserve for the content of the stream.
+    /// @return The output file stream.
+    /// @exception The \a Exception with \a plzma_error_code_not_enough_memory code in case if required amount of memory can't be allocated.
+    LIBPLZMA_CPP_API(SharedPtr<OutStream>) makeSharedOutStream(const size_t initialCapacity);
+    
     typedef Vector<SharedPtr<OutStream> > OutStreamArray;
 
     /// @brief Interface to the output multi volume/part stream.
@@ -1083,7 +1244,10 @@ namespace plzma {
     
     /// @brief The template of vector.
     /// Similar to the \a std::vector.
-    /// @tparam T Class type with move constructor and move assignment operator.
+    ///
+    /// The elements are stored in uninitialized memory, constructed in place and relocated with the move constructor.
+    /// The capacity grows geometrically, so the \a push and \a emplace are amortized O(1).
+    /// @tparam T Class type with move constructor.
     template<typename T>
     class Vector {
     private:
@@ -1100,25 +1264,38 @@ namespace plzma {
             delete this;
         }
         
-        void extendCapacity(const size_t capacityIncrement = 10) {
-            const size_t dstCapacity = capacityIncrement + _capacity;
+        void destroyElements() noexcept {
+            for (plzma_size_t i = 0; i < _size; i++) {
+                _mem[i].~T();
+            }
+        }
+        
+        void reallocate(const size_t dstCapacity) {
             if (dstCapacity > PLZMA_SIZE_T_MAX) {
                 throw Exception(plzma_error_code_invalid_arguments, "Exceeded vector capacity.", __FILE__, __LINE__);
             }
-            T * mem = new T[dstCapacity]();
-            try {
-                for (size_t i = 0; i < _size; i++) {
-                    mem[i] = static_cast<T &&>(_mem[i]);
-                }
-                delete [] _mem;
-            } catch (...) {
-                delete [] mem;
-                throw;
+            T * mem = static_cast<T *>(plzma_malloc(dstCapacity * sizeof(T)));
+            if (!mem) {
+                throw Exception(plzma_error_code_not_enough_memory, "Can't allocate vector memory.", __FILE__, __LINE__);
+            }
+            for (plzma_size_t i = 0; i < _size; i++) {
+                ::new (static_cast<void *>(mem + i)) T(static_cast<T &&>(_mem[i])); // &&/move noexcept
+                _mem[i].~T();
             }
+            plzma_free(_mem);
             _mem = mem;
             _capacity = static_cast<plzma_size_t>(dstCapacity);
         }
         
+        void extendCapacity() {
+            const size_t capacity = static_cast<size_t>(_capacity);
+            size_t dstCapacity = (capacity < 8) ? 8 : capacity + (capacity >> 1);
+            if (dstCapacity > PLZMA_SIZE_T_MAX && capacity < PLZMA_SIZE_T_MAX) {
+                dstCapacity = PLZMA_SIZE_T_MAX;
+            }
+            reallocate(dstCapacity);
+        }
+        
         Vector & operator = (const Vector<T> &) = delete;
         Vector(const Vector<T> &) = delete;
         
@@ -1134,32 +1311,66 @@ namespace plzma {
         
         plzma_size_t count() const noexcept { return _size; }
         
+        plzma_size_t capacity() const noexcept { return _capacity; }
+        
         const T & at(const plzma_size_t index) const { return _mem[index]; }
         T & at(const plzma_size_t index) { return _mem[index]; }
         
+        /// @brief Reserves the memory for at least \a capacity elements.
+        /// @exception The \a Exception with \a plzma_error_code_not_enough_memory code in case if the memory can't be allocated.
+        void reserve(const plzma_size_t capacity) {
+            if (capacity > _capacity) {
+                reallocate(capacity);
+            }
+        }
+        
+        /// @brief Constructs the element in place at the end of the vector.
+        /// @return The reference to the constructed element.
+        template<typename ... ARGS>
+        T & emplace(ARGS && ... args) {
+            if (_capacity == _size) {
+                extendCapacity();
+            }
+            T * element = ::new (static_cast<void *>(_mem + _size)) T(static_cast<ARGS &&>(args)...);
+            _size++;
+            return *element;
+        }
+        
         void push(const T & element) {
             if (_capacity == _size) {
+                if (&element >= _mem && &element < _mem + _size) { // the element of this vector
+                    T copy(element);
+                    emplace(static_cast<T &&>(copy));
+                    return;
+                }
                 extendCapacity();
             }
-            _mem[_size++] = element;
+            ::new (static_cast<void *>(_mem + _size)) T(element);
+            _size++;
         }
         
         void push(T && element) {
             if (_capacity == _size) {
+                if (&element >= _mem && &element < _mem + _size) { // the element of this vector
+                    T tmp(static_cast<T &&>(element));
+                    emplace(static_cast<T &&>(tmp));
+                    return;
+                }
                 extendCapacity();
             }
-            _mem[_size++] = static_cast<T &&>(element);
+            ::new (static_cast<void *>(_mem + _size)) T(static_cast<T &&>(element));
+            _size++;
         }
         
         void pop() noexcept {
             if (_size > 0) {
-                T tmp = static_cast<T &&>(_mem[--_size]); // &&/move noexcept
-                (void)tmp;
+                _mem[--_size].~T();
             }
         }
         
         void clear() noexcept {
-            delete [] _mem;
+            destroyElements();
+            plzma_free(_mem);
             _mem = nullptr;
             _size = _capacity = 0;
         }
@@ -1176,12 +1387,14 @@ namespace plzma {
         }
         
         Vector & operator = (Vector<T> && vector) noexcept {
-            delete [] _mem;
-            _mem = vector._mem;
-            _size = vector._size;
-            _capacity = vector._capacity;
-            vector._mem = nullptr;
-            vector._size = vector._capacity = 0;
+            if (this != &vector) {
+                clear();
+                _mem = vector._mem;
+                _size = vector._size;
+                _capacity = vector._capacity;
+                vector._mem = nullptr;
+                vector._size = vector._capacity = 0;
+            }
             return *this;
         }
         
@@ -1191,15 +1404,31 @@ namespace plzma {
             vector._size = vector._capacity = 0;
         }
         
+        /// @brief Constructs the vector with copies of the elements in range [first, last).
+        Vector(const T * LIBPLZMA_NULLABLE first, const T * LIBPLZMA_NULLABLE last) {
+            if (first && last > first) {
+                reallocate(static_cast<size_t>(last - first));
+                try {
+                    for (; first != last; first++) {
+                        ::new (static_cast<void *>(_mem + _size)) T(*first);
+                        _size++;
+                    }
+                } catch (...) {
+                    clear();
+                    throw;
+                }
+            }
+        }
+        
         Vector(const plzma_size_t capacity = 0) {
             if (capacity > 0) {
-                extendCapacity(capacity);
-                _capacity = capacity;
+                reallocate(capacity);
             }
         }
         
         ~Vector() noexcept {
-            delete [] _mem;
+            destroyElements();
+            plzma_free(_mem);
         }
     };
     
@@ -1225,6 +1454,104 @@ namespace plzma {
     };
     
     
+    /// @brief Interface to the decoded content of a single archive item.
+    ///
+    /// The content is decoded on demand, while reading, so the memory usage doesn't depend on the item size.
+    class ItemStream {
+    private:
+        friend struct SharedPtr<ItemStream>;
+        virtual void retain() = 0;
+        virtual void release() = 0;
+        
+    protected:
+        virtual ~ItemStream() = default;
+        
+    public:
+        /// @return The archive item of the stream.
+        /// @note Thread-safe.
+        virtual SharedPtr<Item> item() const = 0;
+        
+        
+        /// @brief Reads the next portion of the decoded content.
+        ///
+        /// Waits until some content is decoded.
+        /// @param buffer The buffer to read to.
+        /// @param size The size of the buffer in bytes.
+        /// @return The number of bytes read, \a 0 means the end of the content or the stream is closed.
+        /// @exception The \a Exception in case of the decoding error, the error is reported once.
+        /// @note Read from a single thread.
+        virtual size_t read(void * LIBPLZMA_NONNULL buffer, const size_t size) = 0;
+        
+        
+        /// @brief Stops the decoding and closes the stream.
+        ///
+        /// The blocked \a read returns \a 0. The stream is closed automatically when it's no longer used.
+        /// @note Thread-safe.
+        virtual void close() = 0;
+    };
+    
+    template struct LIBPLZMA_CPP_CLASS_API SharedPtr<ItemStream>;
+    
+    
+    /// @brief Interface to the decoded content of the xz stream with random access.
+    ///
+    /// The position is located in the index of the xz blocks, only the blocks with the requested range are decoded.
+    /// The few recently used blocks are cached, so the memory usage depends on the block size, not on the content size.
+    class RandomAccessStream {
+    private:
+        friend struct SharedPtr<RandomAccessStream>;
+        virtual void retain() = 0;
+        virtual void release() = 0;
+        
+    protected:
+        virtual ~RandomAccessStream() = default;
+        
+    public:
+        /// @return The size of the decoded content in bytes.
+        /// @note Thread-safe.
+        virtual uint64_t size() const = 0;
+        
+        
+        /// @return The current position of the \a read method.
+        /// @note Thread-safe.
+        virtual uint64_t position() const = 0;
+        
+        
+        /// @brief Moves the current position of the \a read method.
+        /// @param offset The offset from the start of the content. The offset after the end is allowed, the \a read returns \a 0.
+        /// @note Thread-safe.
+        virtual void seek(const uint64_t offset) = 0;
+        
+        
+        /// @brief Reads the decoded content from the current position and moves the position.
+        /// @param buffer The buffer to read to.
+        /// @param size The size of the buffer in bytes.
+        /// @return The number of bytes read, \a 0 means the end of the content or the stream is closed.
+        /// @exception The \a Exception in case of the decoding error.
+        /// @note Thread-safe.
+        virtual size_t read(void * LIBPLZMA_NONNULL buffer, const size_t size) = 0;
+        
+        
+        /// @brief Reads the decoded content from the offset without changing the current position.
+        /// @param buffer The buffer to read to.
+        /// @param size The size of the buffer in bytes.
+        /// @param offset The offset from the start of the content.
+        /// @return The number of bytes read, \a 0 means the offset is at the end of the content or the stream is closed.
+        /// @exception The \a Exception in case of the decoding error.
+        /// @note Thread-safe.
+        virtual size_t pread(void * LIBPLZMA_NONNULL buffer, const size_t size, const uint64_t offset) = 0;
+        
+        
+        /// @brief Closes the stream and releases the cached blocks.
+        ///
+        /// The stream is closed automatically when it's no longer used.
+        /// @note Thread-safe.
+        virtual void close() = 0;
+    };
+    
+    template struct LIBPLZMA_CPP_CLASS_API SharedPtr<RandomAccessStream>;
+    
+    
     /// @brief The \a Decoder for extracting or testing archive items.
     class Decoder {
     private:
@@ -1255,6 +1582,55 @@ namespace plzma {
         virtual void setProgressDelegate(ProgressDelegate * LIBPLZMA_NULLABLE delegate) = 0;
         
         
+        /// @brief Getter for a number of threads used by the coders.
+        /// @return The number of threads or \a 0 which means all hardware threads.
+        /// @note By default the value is \a 0.
+        /// @note Thread-safe.
+        virtual uint32_t numberOfThreads() const = 0;
+        
+        
+        /// @brief Setter for a number of threads used by the coders.
+        /// @param threads The number of threads, \a 0 means all hardware threads.
+        /// @note Has no effect if the library was built without 'LIBPLZMA_MULTITHREAD'.
+        /// @note Thread-safe. Must be set before opening.
+        virtual void setNumberOfThreads(const uint32_t threads) = 0;
+        
+        
+        /// @brief Getter for a memory usage limit of the coders.
+        /// @return The limit in bytes or \a 0 which means the default limit, a half of the physical memory.
+        /// @note By default the value is \a 0.
+        /// @note Thread-safe.
+        virtual uint64_t memoryLimit() const = 0;
+        
+        
+        /// @brief Setter for a memory usage limit of the coders.
+        ///
+        /// The multithreaded coders reduce the number of threads or fall back to a single thread
+        /// to keep the memory usage below this limit.
+        /// @param limit The limit in bytes, \a 0 means the default limit.
+        /// @note Thread-safe. Must be set before opening.
+        virtual void setMemoryLimit(const uint64_t limit) = 0;
+        
+        
+        /// @brief Getter for a number of the extract workers.
+        /// @return The number of workers, \a 0 means the number of hardware threads.
+        /// @note By default the value is \a 1, i.e. the items are extracted sequentially.
+        /// @note Thread-safe.
+        virtual uint32_t extractWorkers() const = 0;
+        
+        
+        /// @brief Setter for a number of the extract workers.
+        ///
+        /// The independent solid blocks(folders) of the 7z archive or the indexed blocks of the xz stream
+        /// are extracted in parallel, each worker reads own copy of the input stream. The xz blocks are
+        /// written to the output in order. Falls back to the sequential extraction if the input stream
+        /// can't be copied(stream with callbacks), the archive has only one solid block, the xz stream
+        /// has only one block or the type of the archive is tar.
+        /// @param workers The number of workers, \a 0 means the number of hardware threads.
+        /// @note Thread-safe. Must be set before extracting.
+        virtual void setExtractWorkers(const uint32_t workers) = 0;
+        
+        
         /// @brief Opens the archive.
         ///
         /// During the process, the decoder is self-retained as long as the operation is in progress.
@@ -1285,6 +1661,15 @@ namespace plzma {
         virtual SharedPtr<ItemArray> items() const = 0;
         
         
+        /// @brief Receives the columnar list of all archive items.
+        ///
+        /// Preferred for listing and filtering the archives with a large number of items.
+        /// @return The new table instance with all archive items.
+        /// @note The decoder must be opened.
+        /// @note Thread-safe.
+        virtual SharedPtr<ItemTable> itemTable() const = 0;
+        
+        
         /// @brief Receives a single archive item at a specific index.
         /// @param index The index of the item inside the arhive. Must be less than the number of items reported by the \a count() method.
         /// @return The archive item.
@@ -1293,6 +1678,26 @@ namespace plzma {
         virtual SharedPtr<Item> itemAt(const plzma_size_t index) const = 0;
         
         
+        /// @brief Receives a single archive item by it's path inside the archive.
+        ///
+        /// The hash index of all item paths is created on the first call, the next lookups don't scan the items.
+        /// @param path The item's path inside the archive.
+        /// @return The archive item or empty pointer if the archive has no item with such path.
+        /// @note The decoder must be opened.
+        /// @note Thread-safe.
+        virtual SharedPtr<Item> itemAtPath(const Path & path) const = 0;
+        
+        
+        /// @brief Receives the archive items by their paths inside the archive, i.e. for extracting or testing selected items.
+        /// @param paths The array of the item paths.
+        /// @param count The number of paths.
+        /// @return The new array with the found items in order of paths, the missed paths are skipped.
+        /// @note The decoder must be opened.
+        /// @note Thread-safe.
+        /// @see \a itemAtPath method.
+        virtual SharedPtr<ItemArray> itemsAtPaths(const Path * LIBPLZMA_NONNULL paths, const plzma_size_t count) const = 0;
+        
+        
         /// @brief Extracts all archive items to a specific path.
         ///
         /// During the process, the decoder is self-retained as long as the operation is in progress.
@@ -1318,6 +1723,24 @@ namespace plzma {
                              const bool usingItemsFullPath = true) = 0;
         
         
+        /// @brief Extracts the archive items with paths matching the wildcard pattern to a specific path.
+        ///
+        /// The items are selected from the paths inside the archive without creating the item objects.
+        /// During the process, the decoder is self-retained as long as the operation is in progress.
+        /// @param pattern The UTF-8 wildcard pattern. The '*' matches any sequence of characters including separators,
+        /// the '?' matches a single character. The pattern of a directory, i.e. 'assets/textures/', matches all items inside it.
+        /// @param path The directory path to extract the matched items.
+        /// @param usingItemsFullPath Extract item using it's full path or only the last path component.
+        /// @return \a false if the decoder is not opened.
+        /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the decoder is extracting or testing.
+        /// @note The extracting progress might be executed in a separate thread.
+        /// @note The extracting progress might be aborted via \a abort() method.
+        /// @note Thread-safe.
+        virtual bool extractMatching(const char * LIBPLZMA_NONNULL pattern,
+                                     const Path & path,
+                                     const bool usingItemsFullPath = true) = 0;
+        
+        
         /// @brief Extracts each archive item to a separate out-stream.
         ///
         /// During the process, the decoder is self-retained as long as the operation is in progress.
@@ -1338,6 +1761,19 @@ namespace plzma {
         virtual bool test(const SharedPtr<ItemArray> & items) = 0;
         
         
+        /// @brief Tests the archive items with paths matching the wildcard pattern.
+        ///
+        /// During the process, the decoder is self-retained as long as the operation is in progress.
+        /// @param pattern The UTF-8 wildcard pattern.
+        /// @return \a false if the decoder is not opened.
+        /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the decoder is extracting or testing.
+        /// @note The testing progress might be executed in a separate thread.
+        /// @note The testing progress might be aborted via \a abort() method.
+        /// @note Thread-safe.
+        /// @see \a extractMatching method.
+        virtual bool testMatching(const char * LIBPLZMA_NONNULL pattern) = 0;
+        
+        
         /// @brief Tests all archive items.
         ///
         /// During the process, the decoder is self-retained as long as the operation is in progress.
@@ -1345,6 +1781,45 @@ namespace plzma {
         /// @note The testing progress might be aborted via \a abort() method.
         /// @note Thread-safe.
         virtual bool test() = 0;
+        
+        
+        /// @brief Opens the stream for reading the decoded content of a single archive item.
+        ///
+        /// The stream reads own copy of the input stream. The xz and tar items are read directly from the archive,
+        /// the 7z items are decoded in a separate thread through a bounded buffer or from the nearest checkpoint
+        /// found by the \a buildCheckpoints method. In case if the input stream can't be copied(stream with callbacks)
+        /// or the library is thread unsafe, the item is extracted to memory before reading.
+        /// @param item The archive item.
+        /// @return The item stream or empty pointer if the decoder is not opened or the opening was aborted.
+        /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the item is empty.
+        /// @note The decoder must be opened.
+        /// @note Thread-safe.
+        virtual SharedPtr<ItemStream> openItemStream(const SharedPtr<Item> & item) = 0;
+        
+        
+        /// @brief Opens the stream for reading the decoded content of the xz archive at any offset.
+        ///
+        /// The stream reads own copy of the input stream and decodes only the xz blocks with the requested range.
+        /// The multi-block xz archives can be created via the \a Encoder::setBlockSize method.
+        /// @return The random access stream or empty pointer if the decoder is not opened or the opening was aborted.
+        /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the type of the archive
+        /// is not xz, the xz stream has no index of the blocks, the blocks are too large or the input stream can't be copied(stream with callbacks).
+        /// @note The decoder must be opened.
+        /// @note Thread-safe.
+        virtual SharedPtr<RandomAccessStream> openRandomAccessStream() = 0;
+        
+        
+        /// @brief Finds the checkpoints of the solid LZMA2 folders of the 7z archive.
+        ///
+        /// The checkpoint is the point where the LZMA2 encoder reset the dictionary, i.e. the start of each LZMA2 block.
+        /// Only the chunk headers are read, without decoding. The item streams opened after this call start decoding
+        /// from the nearest checkpoint before the item instead of the start of the solid folder.
+        /// @return The number of found checkpoints or \a 0 if the archive type is not 7z or there are no solid LZMA2 folders
+        /// with more than one block.
+        /// @note The decoder must be opened.
+        /// @note Thread-safe.
+        /// @see \a openItemStream method.
+        virtual plzma_size_t buildCheckpoints() = 0;
     };
     
     template struct LIBPLZMA_CPP_CLASS_API SharedPtr<Decoder>;
@@ -1415,6 +1890,45 @@ namespace plzma {
         virtual void add(const SharedPtr<InStream> & stream, const Path & archivePath) = 0;
         
         
+        /// @brief Adds the item which content is pushed during the compression, the size of the content is not required.
+        ///
+        /// The content is pushed from the other thread than \a compress() via \a beginItem, \a write and \a endItem methods.
+        /// The size of the item is unknown before pushing, the 7z solid block size limit(see \a setSolidBlockSize)
+        /// counts each push item as 64 MiB regardless of the pushed content.
+        /// @param archivePath The path of how the item will be presented in archive. Empty path is not allowed.
+        /// @note Thread-safe. Must be set before opening.
+        /// @throws \a Exception in case if the library was built without thread-safety.
+        virtual void addPushItem(const Path & archivePath) = 0;
+        
+        
+        /// @brief Begins pushing the content of the previously added push item.
+        ///
+        /// The encoder reads the items in own order, i.e. the 7z archive sorts the items by the archive path.
+        /// The memory usage is bounded if the items are pushed in the same order, otherwise the pushed content
+        /// is buffered until the encoder reads the item.
+        /// @param archivePath The archive path of the item, provided by \a addPushItem.
+        /// @return \a false if the encoder finished or aborted, otherwise \a true.
+        /// @note Thread-safe. The items must be pushed one by one from a single thread.
+        /// @throws \a Exception in case if the item wasn't added or already pushed or previous item not ended.
+        virtual bool beginItem(const Path & archivePath) = 0;
+        
+        
+        /// @brief Pushes the next portion of the content of the begun item.
+        ///
+        /// Waits while the encoder reads the previously pushed content.
+        /// @return \a false if the encoder finished or aborted, otherwise \a true.
+        /// @note Thread-safe.
+        /// @throws \a Exception in case if no begun item.
+        virtual bool write(const void * LIBPLZMA_NONNULL data, const size_t size) = 0;
+        
+        
+        /// @brief Ends pushing the content of the begun item.
+        /// @return \a false if the encoder finished or aborted, otherwise \a true.
+        /// @note Thread-safe.
+        /// @throws \a Exception in case if no begun item.
+        virtual bool endItem() = 0;
+        
+        
         /// @brief Opens the encoder for compressing.
         ///
         /// During the process, the encoder is self-retained as long as the operation is in progress.
@@ -1452,6 +1966,21 @@ namespace plzma {
         virtual void setShouldCreateSolidArchive(const bool solid) = 0;
         
         
+        /// @brief Should encoder group the similar items of the 7z archive and choose the filters by the item content.
+        /// @note Disabled by default, the value is \a false.
+        /// @note Thread-safe.
+        virtual bool shouldUseSmartSolid() const = 0;
+        
+        
+        /// @brief Set encoder will group the similar items of the 7z archive and choose the filters by the item content.
+        ///
+        /// The items are sorted by the type, i.e. by extension, so the similar content is next to each other in the solid block.
+        /// The beginning of each file is analyzed to apply the executable(BCJ, ARM, etc.) or the Delta(wav) filters to the
+        /// group of the detected items. The added streams are not analyzed.
+        /// @note Thread-safe. Must be set before opening.
+        virtual void setShouldUseSmartSolid(const bool smart) = 0;
+        
+        
         /// @brief Getter for a compression level.
         /// @return The level in a range [0; 9].
         /// @note Thread-safe.
@@ -1464,6 +1993,75 @@ namespace plzma {
         virtual void setCompressionLevel(const uint8_t level) = 0;
         
         
+        /// @brief Getter for a number of threads used by the coders.
+        /// @return The number of threads or \a 0 which means all hardware threads.
+        /// @note By default the value is \a 0.
+        /// @note Thread-safe.
+        virtual uint32_t numberOfThreads() const = 0;
+        
+        
+        /// @brief Setter for a number of threads used by the coders.
+        /// @param threads The number of threads, \a 0 means all hardware threads.
+        /// @note Has no effect if the library was built without 'LIBPLZMA_MULTITHREAD'.
+        /// @note Thread-safe. Must be set before opening.
+        virtual void setNumberOfThreads(const uint32_t threads) = 0;
+        
+        
+        /// @brief Getter for a block size of the LZMA2 compression.
+        /// @return The size in bytes or \a 0 which means the default size of the coder.
+        /// @note By default the value is \a 0.
+        /// @note Thread-safe.
+        virtual uint64_t blockSize() const = 0;
+        
+        
+        /// @brief Setter for a block size of the LZMA2 compression.
+        ///
+        /// The xz stream is split to the independent blocks of this size, listed in the xz index.
+        /// Such blocks are compressed in parallel by the multithreaded coder and can be decoded
+        /// in parallel by the extract workers of the decoder. The 7z LZMA2 stream resets
+        /// the dictionary after each block, the multithreaded LZMA2 coder compresses the blocks
+        /// in parallel and the decoder's checkpoints are placed at the block starts.
+        /// Has no effect for the other 7z methods.
+        /// @param size The size in bytes, \a 0 means the default size of the coder.
+        /// @note Thread-safe. Must be set before opening.
+        virtual void setBlockSize(const uint64_t size) = 0;
+        
+        
+        /// @brief Getter for a maximum size of the solid block of the 7z archive.
+        /// @return The size in bytes or \a 0 which means the default size for the compression method and level.
+        /// @note By default the value is \a 0.
+        /// @note Thread-safe.
+        virtual uint64_t solidBlockSize() const = 0;
+        
+        
+        /// @brief Setter for a maximum size of the solid block of the 7z archive.
+        ///
+        /// The items are compressed to the solid blocks(folders) of the limited unpacked size.
+        /// The smaller blocks decrease the ratio, but the item is decoded from the start of own block
+        /// and the blocks can be decoded in parallel by the extract workers of the decoder.
+        /// Has no effect if the archive is not solid. The items added by \a addPushItem are counted as 64 MiB each,
+        /// so a limit less than 64 MiB places each of them to own block.
+        /// @param size The size in bytes, \a 0 means the default size for the compression method and level.
+        /// @note Thread-safe. Must be set before opening.
+        virtual void setSolidBlockSize(const uint64_t size) = 0;
+        
+        
+        /// @brief Getter for a maximum number of items in the solid block of the 7z archive.
+        /// @return The number of items or \a 0 which means unlimited.
+        /// @note By default the value is \a 0.
+        /// @note Thread-safe.
+        virtual uint32_t solidBlockFileCount() const = 0;
+        
+        
+        /// @brief Setter for a maximum number of items in the solid block of the 7z archive.
+        ///
+        /// Applied together with the solid block size, the block is finished when any of the limits is reached.
+        /// Has no effect if the archive is not solid.
+        /// @param count The number of items, \a 0 means unlimited.
+        /// @note Thread-safe. Must be set before opening.
+        virtual void setSolidBlockFileCount(const uint32_t count) = 0;
+        
+        
         /// @brief Should encoder compress the archive header.
         /// @note Enabled by default, the value is \a true.
         /// @note Thread-safe.
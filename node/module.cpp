@@ -30,6 +30,7 @@
 #include <iostream> // std::cout
 #include <type_traits>
 #include <node.h>
+#include <node_buffer.h>
 #include <node_object_wrap.h>
 #include <uv.h>
 #include "../libplzma.hpp"
@@ -301,6 +302,8 @@ namespace nplzma {
         
         static void Erase(const FunctionCallbackInfo<Value> & args);
         static void CopyContent(const FunctionCallbackInfo<Value> & args);
+        static void TakeContent(const FunctionCallbackInfo<Value> & args);
+        static void Reserve(const FunctionCallbackInfo<Value> & args);
         static void Opened(Local<String> property, const PropertyCallbackInfo<Value> & info);
         static void Streams(Local<String> property, const PropertyCallbackInfo<Value> & info);
         static void New(const FunctionCallbackInfo<Value> & args);
@@ -350,8 +353,18 @@ namespace nplzma {
         static void Compress(const FunctionCallbackInfo<Value> & args);
         static void ShouldCreateSolidArchive(Local<String> property, const PropertyCallbackInfo<Value> & info);
         static void SetShouldCreateSolidArchive(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
+        static void ShouldUseSmartSolid(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void SetShouldUseSmartSolid(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
         static void CompressionLevel(Local<String> property, const PropertyCallbackInfo<Value> & info);
         static void SetCompressionLevel(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
+        static void NumberOfThreads(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void SetNumberOfThreads(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
+        static void BlockSize(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void SetBlockSize(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
+        static void SolidBlockSize(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void SetSolidBlockSize(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
+        static void SolidBlockFileCount(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void SetSolidBlockFileCount(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
         static void ShouldCompressHeader(Local<String> property, const PropertyCallbackInfo<Value> & info);
         static void SetShouldCompressHeader(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
         static void ShouldCompressHeaderFull(Local<String> property, const PropertyCallbackInfo<Value> & info);
@@ -392,6 +405,12 @@ namespace nplzma {
         static void Test(const FunctionCallbackInfo<Value> & args);
         static void Count(Local<String> property, const PropertyCallbackInfo<Value> & info);
         static void Items(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void NumberOfThreads(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void SetNumberOfThreads(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
+        static void MemoryLimit(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void SetMemoryLimit(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
+        static void ExtractWorkers(Local<String> property, const PropertyCallbackInfo<Value> & info);
+        static void SetExtractWorkers(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info);
         static void New(const FunctionCallbackInfo<Value> & args);
     public:
         Decoder(plzma::SharedPtr<plzma::Decoder> && decoder) : node::ObjectWrap(),
@@ -812,6 +831,20 @@ namespace nplzma {
         encoder->_encoder->setShouldCreateSolidArchive(value->BooleanValue(isolate));
     }
     
+    void Encoder::ShouldUseSmartSolid(Local<String> property, const PropertyCallbackInfo<Value> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        info.GetReturnValue().Set(Boolean::New(isolate, encoder->_encoder->shouldUseSmartSolid()));
+    }
+    
+    void Encoder::SetShouldUseSmartSolid(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        encoder->_encoder->setShouldUseSmartSolid(value->BooleanValue(isolate));
+    }
+    
     void Encoder::CompressionLevel(Local<String> property, const PropertyCallbackInfo<Value> & info) {
         Isolate * isolate = info.GetIsolate();
         HandleScope handleScope(isolate);
@@ -834,6 +867,94 @@ namespace nplzma {
         }
     }
     
+    void Encoder::NumberOfThreads(Local<String> property, const PropertyCallbackInfo<Value> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        info.GetReturnValue().Set(Uint32::New(isolate, encoder->_encoder->numberOfThreads()));
+    }
+    
+    void Encoder::SetNumberOfThreads(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        Local<Context> context = isolate->GetCurrentContext();
+        uint32_t numberOfThreadsValue = 0;
+        bool numberOfThreadsValueDefined = false;
+        NPLZMA_GET_UINT32_FROM_VALUE(context, value, numberOfThreadsValue, numberOfThreadsValueDefined)
+        if (numberOfThreadsValueDefined) {
+            encoder->_encoder->setNumberOfThreads(numberOfThreadsValue);
+        } else {
+            NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "numberOfThreads")
+        }
+    }
+    
+    void Encoder::BlockSize(Local<String> property, const PropertyCallbackInfo<Value> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        info.GetReturnValue().Set(BigInt::NewFromUnsigned(isolate, encoder->_encoder->blockSize()));
+    }
+    
+    void Encoder::SetBlockSize(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        Local<Context> context = isolate->GetCurrentContext();
+        uint64_t blockSizeValue = 0;
+        bool blockSizeValueDefined = false;
+        NPLZMA_GET_UINT64_FROM_VALUE(context, value, blockSizeValue, blockSizeValueDefined)
+        if (blockSizeValueDefined) {
+            encoder->_encoder->setBlockSize(blockSizeValue);
+        } else {
+            NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "blockSize")
+        }
+    }
+    
+    void Encoder::SolidBlockSize(Local<String> property, const PropertyCallbackInfo<Value> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        info.GetReturnValue().Set(BigInt::NewFromUnsigned(isolate, encoder->_encoder->solidBlockSize()));
+    }
+    
+    void Encoder::SetSolidBlockSize(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        Local<Context> context = isolate->GetCurrentContext();
+        uint64_t solidBlockSizeValue = 0;
+        bool solidBlockSizeValueDefined = false;
+        NPLZMA_GET_UINT64_FROM_VALUE(context, value, solidBlockSizeValue, solidBlockSizeValueDefined)
+        if (solidBlockSizeValueDefined) {
+            encoder->_encoder->setSolidBlockSize(solidBlockSizeValue);
+        } else {
+            NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "solidBlockSize")
+        }
+    }
+    
+    void Encoder::SolidBlockFileCount(Local<String> property, const PropertyCallbackInfo<Value> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        info.GetReturnValue().Set(Uint32::New(isolate, encoder->_encoder->solidBlockFileCount()));
+    }
+    
+    void Encoder::SetSolidBlockFileCount(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Encoder * encoder = ObjectWrap::Unwrap<Encoder>(info.Holder());
+        Local<Context> context = isolate->GetCurrentContext();
+        uint32_t solidBlockFileCountValue = 0;
+        bool solidBlockFileCountValueDefined = false;
+        NPLZMA_GET_UINT32_FROM_VALUE(context, value, solidBlockFileCountValue, solidBlockFileCountValueDefined)
+        if (solidBlockFileCountValueDefined) {
+            encoder->_encoder->setSolidBlockFileCount(solidBlockFileCountValue);
+        } else {
+            NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "solidBlockFileCount")
+        }
+    }
+    
     void Encoder::ShouldCompressHeader(Local<String> property, const PropertyCallbackInfo<Value> & info) {
         Isolate * isolate = info.GetIsolate();
         HandleScope handleScope(isolate);
@@ -960,7 +1081,12 @@ namespace nplzma {
         
         // (new Encoder(...)).<prop>
         ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "shouldCreateSolidArchive").ToLocalChecked(), Encoder::ShouldCreateSolidArchive, Encoder::SetShouldCreateSolidArchive, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
+        ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "shouldUseSmartSolid").ToLocalChecked(), Encoder::ShouldUseSmartSolid, Encoder::SetShouldUseSmartSolid, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
         ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "compressionLevel").ToLocalChecked(), Encoder::CompressionLevel, Encoder::SetCompressionLevel, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
+        ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "numberOfThreads").ToLocalChecked(), Encoder::NumberOfThreads, Encoder::SetNumberOfThreads, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
+        ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "blockSize").ToLocalChecked(), Encoder::BlockSize, Encoder::SetBlockSize, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
+        ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "solidBlockSize").ToLocalChecked(), Encoder::SolidBlockSize, Encoder::SetSolidBlockSize, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
+        ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "solidBlockFileCount").ToLocalChecked(), Encoder::SolidBlockFileCount, Encoder::SetSolidBlockFileCount, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
         ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "shouldCompressHeader").ToLocalChecked(), Encoder::ShouldCompressHeader, Encoder::SetShouldCompressHeader, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
         ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "shouldCompressHeaderFull").ToLocalChecked(), Encoder::ShouldCompressHeaderFull, Encoder::SetShouldCompressHeaderFull, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
         ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "shouldEncryptContent").ToLocalChecked(), Encoder::ShouldEncryptContent, Encoder::SetShouldEncryptContent, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
@@ -1456,6 +1582,72 @@ namespace nplzma {
         info.GetReturnValue().Set(Uint32::NewFromUnsigned(isolate, count));
     }
     
+    void Decoder::NumberOfThreads(Local<String> property, const PropertyCallbackInfo<Value> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Decoder * decoder = ObjectWrap::Unwrap<Decoder>(info.Holder());
+        info.GetReturnValue().Set(Uint32::NewFromUnsigned(isolate, decoder->_decoder->numberOfThreads()));
+    }
+    
+    void Decoder::SetNumberOfThreads(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Decoder * decoder = ObjectWrap::Unwrap<Decoder>(info.Holder());
+        Local<Context> context = isolate->GetCurrentContext();
+        uint32_t numberOfThreadsValue = 0;
+        bool numberOfThreadsValueDefined = false;
+        NPLZMA_GET_UINT32_FROM_VALUE(context, value, numberOfThreadsValue, numberOfThreadsValueDefined)
+        if (numberOfThreadsValueDefined) {
+            decoder->_decoder->setNumberOfThreads(numberOfThreadsValue);
+        } else {
+            NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "numberOfThreads")
+        }
+    }
+    
+    void Decoder::MemoryLimit(Local<String> property, const PropertyCallbackInfo<Value> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Decoder * decoder = ObjectWrap::Unwrap<Decoder>(info.Holder());
+        info.GetReturnValue().Set(BigInt::NewFromUnsigned(isolate, decoder->_decoder->memoryLimit()));
+    }
+    
+    void Decoder::SetMemoryLimit(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Decoder * decoder = ObjectWrap::Unwrap<Decoder>(info.Holder());
+        Local<Context> context = isolate->GetCurrentContext();
+        uint64_t memoryLimitValue = 0;
+        bool memoryLimitValueDefined = false;
+        NPLZMA_GET_UINT64_FROM_VALUE(context, value, memoryLimitValue, memoryLimitValueDefined)
+        if (memoryLimitValueDefined) {
+            decoder->_decoder->setMemoryLimit(memoryLimitValue);
+        } else {
+            NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "memoryLimit")
+        }
+    }
+    
+    void Decoder::ExtractWorkers(Local<String> property, const PropertyCallbackInfo<Value> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Decoder * decoder = ObjectWrap::Unwrap<Decoder>(info.Holder());
+        info.GetReturnValue().Set(Uint32::NewFromUnsigned(isolate, decoder->_decoder->extractWorkers()));
+    }
+    
+    void Decoder::SetExtractWorkers(Local<String> property, Local<Value> value, const PropertyCallbackInfo<void> & info) {
+        Isolate * isolate = info.GetIsolate();
+        HandleScope handleScope(isolate);
+        Decoder * decoder = ObjectWrap::Unwrap<Decoder>(info.Holder());
+        Local<Context> context = isolate->GetCurrentContext();
+        uint32_t extractWorkersValue = 0;
+        bool extractWorkersValueDefined = false;
+        NPLZMA_GET_UINT32_FROM_VALUE(context, value, extractWorkersValue, extractWorkersValueDefined)
+        if (extractWorkersValueDefined) {
+            decoder->_decoder->setExtractWorkers(extractWorkersValue);
+        } else {
+            NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "extractWorkers")
+        }
+    }
+    
     void Decoder::Items(Local<String> property, const PropertyCallbackInfo<Value> & info) {
         Isolate * isolate = info.GetIsolate();
         HandleScope handleScope(isolate);
@@ -1524,6 +1716,9 @@ namespace nplzma {
         // (new Decoder(...)).<prop>
         ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "count").ToLocalChecked(), Decoder::Count, nullptr, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(ReadOnly | DontDelete | DontEnum));
         ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "items").ToLocalChecked(), Decoder::Items, nullptr, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(ReadOnly | DontDelete | DontEnum));
+        ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "numberOfThreads").ToLocalChecked(), Decoder::NumberOfThreads, Decoder::SetNumberOfThreads, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
+        ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "memoryLimit").ToLocalChecked(), Decoder::MemoryLimit, Decoder::SetMemoryLimit, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
+        ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "extractWorkers").ToLocalChecked(), Decoder::ExtractWorkers, Decoder::SetExtractWorkers, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(DontDelete | DontEnum));
         
         Local<Function> constructor = ctorTpl->GetFunction(context).ToLocalChecked();
         dataObject->SetInternalField(0, constructor);
@@ -1663,6 +1858,7 @@ namespace nplzma {
             std::shared_ptr<BackingStore> backingStore;
             plzma::Path path;
             plzma::InStreamArray multiStreams;
+            plzma_in_stream_mode mode = plzma_in_stream_mode_default;
             int method = 0; // 0 - data, 1 - path, 2 - multi volume streams
             bool unsupportedArg = true;
             if (args.Length() > 0) {
@@ -1714,6 +1910,13 @@ namespace nplzma {
                     }
                 }
             }
+            if (!unsupportedArg && method == 1 && args.Length() > 1) {
+                if (args[1]->IsUint32()) {
+                    mode = static_cast<plzma_in_stream_mode>(args[1]->Uint32Value(context).FromJust());
+                } else {
+                    NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "InStream(path, mode<InStreamMode>?)")
+                }
+            }
             if (unsupportedArg) {
                 NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "InStream(?)")
             }
@@ -1725,7 +1928,7 @@ namespace nplzma {
                     stream = plzma::makeSharedInStream(backingStore->Data(), backingStore->ByteLength(), InStreamDummyFreeCallback);
                     break;
                 case 1: // path
-                    stream = plzma::makeSharedInStream(std::move(path));
+                    stream = plzma::makeSharedInStream(std::move(path), mode);
                     break;
                 case 2: // multi volume streams
                     stream = plzma::makeSharedInStream(std::move(multiStreams));
@@ -1781,6 +1984,25 @@ namespace nplzma {
         args.GetReturnValue().Set(Boolean::New(isolate, erased));
     }
     
+    template<class T>
+    void OutStream<T>::Reserve(const FunctionCallbackInfo<Value> & args) {
+        Isolate * isolate = args.GetIsolate();
+        HandleScope handleScope(isolate);
+        Local<Context> context = isolate->GetCurrentContext();
+        OutStream<T> * stream = OutStream<T>::TypedUnwrap(args.Holder());
+        uint64_t size = 0;
+        bool sizeDefined = false;
+        if (args.Length() > 0) {
+            NPLZMA_GET_UINT64_FROM_VALUE(context, args[0], size, sizeDefined)
+        }
+        if (!sizeDefined) {
+            NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "reserve(size<Number|BigInt>)")
+        }
+        NPLZMA_TRY
+        stream->_stream->reserve(size);
+        NPLZMA_CATCH_RET(isolate)
+    }
+    
     static void RawHeapMemoryDeleterCallback(void* data, size_t length, void* deleter_data) {
         plzma_free(data);
     }
@@ -1798,6 +2020,32 @@ namespace nplzma {
         args.GetReturnValue().Set(ArrayBuffer::New(isolate, std::move(backingStore)));
     }
     
+    static void RawHeapMemoryBufferFreeCallback(char * data, void * hint) {
+        plzma_free(data);
+    }
+    
+    template<class T>
+    void OutStream<T>::TakeContent(const FunctionCallbackInfo<Value> & args) {
+        Isolate * isolate = args.GetIsolate();
+        HandleScope handleScope(isolate);
+        OutStream<T> * stream = OutStream<T>::TypedUnwrap(args.Holder());
+        plzma::RawHeapMemorySize content;
+        NPLZMA_TRY
+        content = stream->_stream->takeContent();
+        NPLZMA_CATCH_RET(isolate)
+        MaybeLocal<Object> buffer;
+        if (content.second > 0) {
+            char * data = static_cast<char *>(content.first.take());
+            buffer = node::Buffer::New(isolate, data, content.second, RawHeapMemoryBufferFreeCallback, nullptr);
+        } else {
+            buffer = node::Buffer::New(isolate, 0);
+        }
+        Local<Object> result;
+        if (buffer.ToLocal(&result)) {
+            args.GetReturnValue().Set(result);
+        }
+    }
+    
     template<class T>
     void OutStream<T>::Opened(Local<String> property, const PropertyCallbackInfo<Value> & info) {
         Isolate * isolate = info.GetIsolate();
@@ -1883,6 +2131,8 @@ namespace nplzma {
         Local<ObjectTemplate> ctorProtoTpl = ctorTpl->PrototypeTemplate();
         ctorProtoTpl->Set(String::NewFromUtf8(isolate, "erase").ToLocalChecked(), FunctionTemplate::New(isolate, OutStream<T>::Erase), static_cast<PropertyAttribute>(ReadOnly | DontEnum | DontDelete));
         ctorProtoTpl->Set(String::NewFromUtf8(isolate, "copyContent").ToLocalChecked(), FunctionTemplate::New(isolate, OutStream<T>::CopyContent), static_cast<PropertyAttribute>(ReadOnly | DontEnum | DontDelete));
+        ctorProtoTpl->Set(String::NewFromUtf8(isolate, "takeContent").ToLocalChecked(), FunctionTemplate::New(isolate, OutStream<T>::TakeContent), static_cast<PropertyAttribute>(ReadOnly | DontEnum | DontDelete));
+        ctorProtoTpl->Set(String::NewFromUtf8(isolate, "reserve").ToLocalChecked(), FunctionTemplate::New(isolate, OutStream<T>::Reserve), static_cast<PropertyAttribute>(ReadOnly | DontEnum | DontDelete));
         
         // (new OutStream(...)).<prop>
         ctorInstTpl->SetAccessor(String::NewFromUtf8(isolate, "opened").ToLocalChecked(), OutStream<T>::Opened, nullptr, Local<Value>(), DEFAULT, static_cast<PropertyAttribute>(ReadOnly | DontDelete | DontEnum));
@@ -2976,6 +3226,7 @@ namespace nplzma {
             case 2: retVal = plzma::kStreamWriteSize; break;
             case 3: retVal = plzma::kDecoderReadSize; break;
             case 4: retVal = plzma::kDecoderWriteSize; break;
+            case 5: retVal = plzma_index_cache_capacity(); break;
             default: break;
         }
         info.GetReturnValue().Set(Uint32::New(isolate, retVal));
@@ -2995,6 +3246,7 @@ namespace nplzma {
                 case 2: plzma::kStreamWriteSize = size; break;
                 case 3: plzma::kDecoderReadSize = size; break;
                 case 4: plzma::kDecoderWriteSize = size; break;
+                case 5: plzma_set_index_cache_capacity(size); break;
                 default: break;
             }
         } else {
@@ -3003,6 +3255,7 @@ namespace nplzma {
                 case 2: { NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "streamWriteSize") } break;
                 case 3: { NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "decoderReadSize") } break;
                 case 4: { NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "decoderWriteSize") } break;
+                case 5: { NPLZMA_THROW_ARG_TYPE_ERROR_RET(isolate, "indexCacheCapacity") } break;
                 default: break;
             }
         }
@@ -3047,6 +3300,12 @@ namespace nplzma {
         openDirModeObject->DefineOwnProperty(context, String::NewFromUtf8(isolate, "followSymlinks").ToLocalChecked(), Uint32::NewFromUnsigned(isolate, plzma_open_dir_mode_follow_symlinks), static_cast<PropertyAttribute>(ReadOnly | DontDelete)).Check();
         exports->Set(context, String::NewFromUtf8(isolate, "OpenDirMode").ToLocalChecked(), openDirModeObject).FromJust();
         
+        // plzma_in_stream_mode
+        Local<Object> inStreamModeObject = Object::New(isolate);
+        inStreamModeObject->DefineOwnProperty(context, String::NewFromUtf8(isolate, "default").ToLocalChecked(), Uint32::NewFromUnsigned(isolate, plzma_in_stream_mode_default), static_cast<PropertyAttribute>(ReadOnly | DontDelete)).Check();
+        inStreamModeObject->DefineOwnProperty(context, String::NewFromUtf8(isolate, "mmap").ToLocalChecked(), Uint32::NewFromUnsigned(isolate, plzma_in_stream_mode_mmap), static_cast<PropertyAttribute>(ReadOnly | DontDelete)).Check();
+        exports->Set(context, String::NewFromUtf8(isolate, "InStreamMode").ToLocalChecked(), inStreamModeObject).FromJust();
+        
         // plzma_plzma_multi_stream_part_name_format
         Local<Object> multiStreamPartNameFormatObject = Object::New(isolate);
         multiStreamPartNameFormatObject->DefineOwnProperty(context, String::NewFromUtf8(isolate, "nameExt00x").ToLocalChecked(), Uint32::NewFromUnsigned(isolate, plzma_plzma_multi_stream_part_name_format_name_ext_00x), static_cast<PropertyAttribute>(ReadOnly | DontDelete)).Check();
@@ -3058,6 +3317,7 @@ namespace nplzma {
         exports->SetNativeDataProperty(context, String::NewFromUtf8(isolate, "streamWriteSize").ToLocalChecked(), GetGlobalUInt32Property, SetGlobalUInt32Property, Uint32::NewFromUnsigned(isolate, 2), static_cast<PropertyAttribute>(DontDelete)).Check();
         exports->SetNativeDataProperty(context, String::NewFromUtf8(isolate, "decoderReadSize").ToLocalChecked(), GetGlobalUInt32Property, SetGlobalUInt32Property, Uint32::NewFromUnsigned(isolate, 3), static_cast<PropertyAttribute>(DontDelete)).Check();
         exports->SetNativeDataProperty(context, String::NewFromUtf8(isolate, "decoderWriteSize").ToLocalChecked(), GetGlobalUInt32Property, SetGlobalUInt32Property, Uint32::NewFromUnsigned(isolate, 4), static_cast<PropertyAttribute>(DontDelete)).Check();
+        exports->SetNativeDataProperty(context, String::NewFromUtf8(isolate, "indexCacheCapacity").ToLocalChecked(), GetGlobalUInt32Property, SetGlobalUInt32Property, Uint32::NewFromUnsigned(isolate, 5), static_cast<PropertyAttribute>(DontDelete)).Check();
     }
 }
 
@@ -16,6 +16,9 @@
 #include "7zHandler.h"
 #include "7zProperties.h"
 
+#include "../../../../plzma_index_cache.hpp"
+#include "../../../../plzma_solid_checkpoints.hpp"
+
 #ifdef __7Z_SET_PROPERTIES
 #ifdef EXTRACT_ONLY
 #include "../Common/ParseProperties.h"
@@ -688,14 +691,27 @@ STDMETHODIMP CHandler::Open(IInStream *stream,
     RINOK(archive.Open(stream, maxCheckStartPosition));
     _db.IsArc = true;
     
-    HRESULT result = archive.ReadDatabase(
-        EXTERNAL_CODECS_VARS
-        _db
-        #ifndef _NO_CRYPTO
-          , getTextPassword, _isEncrypted, _passwordIsDefined, _password
-        #endif
-        );
-    RINOK(result);
+    // libplzma: the parsed database of the opened before archive, the encrypted headers are never cached.
+    const ::plzma::IndexCacheKey cacheKey(archive);
+    const bool useCache = ::plzma::IndexCache::capacity() > 0;
+    if (!useCache || !::plzma::IndexCache::find(cacheKey, _db))
+    {
+      HRESULT result = archive.ReadDatabase(
+          EXTERNAL_CODECS_VARS
+          _db
+          #ifndef _NO_CRYPTO
+            , getTextPassword, _isEncrypted, _passwordIsDefined, _password
+          #endif
+          );
+      RINOK(result);
+      
+      if (useCache && _db.CanUpdate()
+          #ifndef _NO_CRYPTO
+          && !_isEncrypted
+          #endif
+          )
+        ::plzma::IndexCache::add(cacheKey, _db);
+    }
     
     _inStream = stream;
   }
@@ -720,6 +736,7 @@ STDMETHODIMP CHandler::Close()
   COM_TRY_BEGIN
   _inStream.Release();
   _db.Clear();
+  _checkpoints.Clear();
   #ifndef _NO_CRYPTO
   _isEncrypted = false;
   _passwordIsDefined = false;
@@ -729,6 +746,149 @@ STDMETHODIMP CHandler::Close()
   COM_TRY_END
 }
 
+// libplzma: random access inside the solid LZMA2 folders.
+
+static bool IsCheckpointFolder(const CFolder &folder)
+{
+  return folder.Coders.Size() == 1
+      && folder.PackStreams.Size() == 1
+      && folder.Coders[0].MethodID == k_LZMA2
+      && folder.Coders[0].Props.Size() == 1;
+}
+
+STDMETHODIMP CHandler::BuildCheckpoints(UInt32 *numCheckpoints)
+{
+  COM_TRY_BEGIN
+  *numCheckpoints = 0;
+  _checkpoints.Clear();
+  if (!_inStream)
+    return S_FALSE;
+  for (CNum folderIndex = 0; folderIndex < _db.NumFolders; folderIndex++)
+  {
+    CFolder folder;
+    _db.ParseFolderInfo(folderIndex, folder);
+    if (!IsCheckpointFolder(folder))
+      continue;
+    CRecordVector< ::plzma::SolidCheckpoint> checkpoints;
+    const HRESULT res = ::plzma::scanLzma2Checkpoints(_inStream,
+        _db.GetFolderStreamPos(folderIndex, 0), _db.GetFolderFullPackSize(folderIndex), checkpoints);
+    if (res == S_FALSE)
+      continue;
+    RINOK(res);
+    FOR_VECTOR (i, checkpoints)
+    {
+      _checkpoints.Add(folderIndex);
+      _checkpoints.Add(checkpoints[i].unpackOffset);
+      _checkpoints.Add(checkpoints[i].packOffset);
+    }
+  }
+  *numCheckpoints = _checkpoints.Size() / 3;
+  return S_OK;
+  COM_TRY_END
+}
+
+STDMETHODIMP CHandler::GetFolderMemUsage(UInt32 folderIndex, UInt64 *memUsage)
+{
+  COM_TRY_BEGIN
+  *memUsage = 0;
+  if (folderIndex >= _db.NumFolders)
+    return E_INVALIDARG;
+  CFolder folder;
+  _db.ParseFolderInfo(folderIndex, folder);
+  FOR_VECTOR (i, folder.Coders)
+  {
+    const CCoderInfo &coder = folder.Coders[i];
+    const Byte *props = coder.Props;
+    if (coder.MethodID == k_LZMA && coder.Props.Size() == 5)
+      *memUsage += GetUi32(props + 1);
+    else if (coder.MethodID == k_LZMA2 && coder.Props.Size() == 1)
+    {
+      const unsigned d = props[0];
+      if (d > 40)
+        return E_NOTIMPL;
+      *memUsage += (d == 40) ? (UInt32)0xFFFFFFFF : (((UInt32)2 | (d & 1)) << (d / 2 + 11));
+    }
+    else if (coder.MethodID == k_PPMD && coder.Props.Size() == 5)
+      *memUsage += GetUi32(props + 1);
+  }
+  return S_OK;
+  COM_TRY_END
+}
+
+STDMETHODIMP CHandler::GetCheckpoints(const UInt64 **checkpoints, UInt32 *numCheckpoints)
+{
+  *checkpoints = _checkpoints.IsEmpty() ? NULL : &_checkpoints.Front();
+  *numCheckpoints = _checkpoints.Size() / 3;
+  return S_OK;
+}
+
+STDMETHODIMP CHandler::SetCheckpoints(const UInt64 *checkpoints, UInt32 numCheckpoints)
+{
+  COM_TRY_BEGIN
+  _checkpoints.Clear();
+  for (UInt32 i = 0; i < numCheckpoints * 3; i += 3)
+  {
+    if (checkpoints[i] >= _db.NumFolders)
+    {
+      _checkpoints.Clear();
+      return E_INVALIDARG;
+    }
+    _checkpoints.Add(checkpoints[i]);
+    _checkpoints.Add(checkpoints[i + 1]);
+    _checkpoints.Add(checkpoints[i + 2]);
+  }
+  return S_OK;
+  COM_TRY_END
+}
+
+STDMETHODIMP CHandler::GetStream(UInt32 index, ISequentialInStream **stream)
+{
+  COM_TRY_BEGIN
+  *stream = NULL;
+  if (!_inStream || index >= _db.Files.Size())
+    return S_FALSE;
+  const CNum folderIndex = _db.FileIndexToFolderIndexMap[index];
+  if (folderIndex == kNumNoIndex)
+    return S_FALSE;
+  
+  UInt64 itemOffset = 0;
+  for (CNum i = _db.FolderStartFileIndex[folderIndex]; i < index; i++)
+    if (_db.Files[i].HasStream)
+      itemOffset += _db.Files[i].Size;
+  
+  // the start of the folder with the checkpoints is also the checkpoint.
+  bool found = false;
+  UInt64 unpackOffset = 0, packOffset = 0;
+  for (unsigned i = 0; i < _checkpoints.Size(); i += 3)
+  {
+    if (_checkpoints[i] != folderIndex)
+      continue;
+    found = true;
+    if (_checkpoints[i + 1] > itemOffset)
+      break;
+    unpackOffset = _checkpoints[i + 1];
+    packOffset = _checkpoints[i + 2];
+  }
+  if (!found)
+    return S_FALSE;
+  
+  CFolder folder;
+  _db.ParseFolderInfo(folderIndex, folder);
+  const UInt64 packSize = _db.GetFolderFullPackSize(folderIndex);
+  if (!IsCheckpointFolder(folder) || packOffset >= packSize)
+    return S_FALSE;
+  
+  const CFileItem &file = _db.Files[index];
+  ::plzma::Lzma2CheckpointInStream *checkpointStreamSpec = new ::plzma::Lzma2CheckpointInStream(_inStream,
+      _db.GetFolderStreamPos(folderIndex, 0) + packOffset, packSize - packOffset,
+      itemOffset - unpackOffset, file.Size, file.CrcDefined, file.Crc);
+  CMyComPtr<ISequentialInStream> checkpointStream = checkpointStreamSpec;
+  RINOK(checkpointStreamSpec->init(folder.Coders[0].Props[0]));
+  *stream = checkpointStream.Detach();
+  return S_OK;
+  COM_TRY_END
+}
+
 #ifdef __7Z_SET_PROPERTIES
 #ifdef EXTRACT_ONLY
 
@@ -83,6 +83,9 @@ public:
 class CHandler final :
   public IInArchive,
   public IArchiveGetRawProps,
+  public IInArchiveGetStream,      // libplzma
+  public IArchiveSolidCheckpoints, // libplzma
+  public IArchiveFolderMemUsage,   // libplzma
   
   #ifdef __7Z_SET_PROPERTIES
   public ISetProperties,
@@ -105,6 +108,9 @@ class CHandler final :
 public:
   MY_QUERYINTERFACE_BEGIN2(IInArchive)
   MY_QUERYINTERFACE_ENTRY(IArchiveGetRawProps)
+  MY_QUERYINTERFACE_ENTRY(IInArchiveGetStream)
+  MY_QUERYINTERFACE_ENTRY(IArchiveSolidCheckpoints)
+  MY_QUERYINTERFACE_ENTRY(IArchiveFolderMemUsage)
   #ifdef __7Z_SET_PROPERTIES
   MY_QUERYINTERFACE_ENTRY(ISetProperties)
   #endif
@@ -118,6 +124,15 @@ public:
   INTERFACE_IInArchive(;)
   INTERFACE_IArchiveGetRawProps(;)
 
+  // libplzma: the items of the solid LZMA2 folders are decoded from the nearest dictionary reset point.
+  STDMETHOD(GetStream)(UInt32 index, ISequentialInStream **stream);
+  STDMETHOD(BuildCheckpoints)(UInt32 *numCheckpoints);
+  STDMETHOD(GetCheckpoints)(const UInt64 **checkpoints, UInt32 *numCheckpoints);
+  STDMETHOD(SetCheckpoints)(const UInt64 *checkpoints, UInt32 numCheckpoints);
+
+  // libplzma: limits the number of the folders decoded in parallel.
+  STDMETHOD(GetFolderMemUsage)(UInt32 folderIndex, UInt64 *memUsage);
+
   #ifdef __7Z_SET_PROPERTIES
   STDMETHOD(SetProperties)(const wchar_t * const *names, const PROPVARIANT *values, UInt32 numProps);
   #endif
@@ -137,6 +152,7 @@ public:
 private:
   CMyComPtr<IInStream> _inStream;
   NArchive::N7z::CDbEx _db;
+  CRecordVector<UInt64> _checkpoints; // libplzma: folder index, unpack offset, pack offset
   
   #ifndef _NO_CRYPTO
   bool _isEncrypted;
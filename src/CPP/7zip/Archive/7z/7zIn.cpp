@@ -1525,6 +1525,62 @@ void CDbEx::FillLinks()
 }
 
 
+template <class T>
+static void CopyObjArray(CObjArray<T> &dest, const CObjArray<T> &src, size_t size)
+{
+  dest.Free();
+  if (src)
+  {
+    dest.Alloc(size);
+    for (size_t i = 0; i < size; i++)
+      dest[i] = src[i];
+  }
+}
+
+void CDbEx::CopyFrom(const CDbEx &db)
+{
+  Clear();
+
+  // CFolders
+  NumPackStreams = db.NumPackStreams;
+  NumFolders = db.NumFolders;
+  CopyObjArray(PackPositions, db.PackPositions, (size_t)NumPackStreams + 1);
+  FolderCRCs = db.FolderCRCs;
+  CopyObjArray(NumUnpackStreamsVector, db.NumUnpackStreamsVector, NumFolders);
+  CopyObjArray(CoderUnpackSizes, db.CoderUnpackSizes, db.FoToCoderUnpackSizes ? db.FoToCoderUnpackSizes[NumFolders] : 0);
+  CopyObjArray(FoToCoderUnpackSizes, db.FoToCoderUnpackSizes, (size_t)NumFolders + 1);
+  CopyObjArray(FoStartPackStreamIndex, db.FoStartPackStreamIndex, (size_t)NumFolders + 1);
+  CopyObjArray(FoToMainUnpackSizeIndex, db.FoToMainUnpackSizeIndex, NumFolders);
+  CopyObjArray(FoCodersDataOffset, db.FoCodersDataOffset, (size_t)NumFolders + 1);
+  CodersData = db.CodersData;
+  ParsedMethods = db.ParsedMethods;
+
+  // CDatabase
+  Files = db.Files;
+  CTime = db.CTime;
+  ATime = db.ATime;
+  MTime = db.MTime;
+  StartPos = db.StartPos;
+  Attrib = db.Attrib;
+  IsAnti = db.IsAnti;
+  NamesBuf = db.NamesBuf;
+  CopyObjArray(NameOffsets, db.NameOffsets, (size_t)Files.Size() + 1);
+
+  // CDbEx
+  ArcInfo = db.ArcInfo;
+  CopyObjArray(FolderStartFileIndex, db.FolderStartFileIndex, NumFolders);
+  CopyObjArray(FileIndexToFolderIndexMap, db.FileIndexToFolderIndexMap, Files.Size());
+  HeadersSize = db.HeadersSize;
+  PhySize = db.PhySize;
+  IsArc = db.IsArc;
+  PhySizeWasConfirmed = db.PhySizeWasConfirmed;
+  ThereIsHeaderError = db.ThereIsHeaderError;
+  UnexpectedEnd = db.UnexpectedEnd;
+  StartHeaderWasRecovered = db.StartHeaderWasRecovered;
+  UnsupportedFeatureWarning = db.UnsupportedFeatureWarning;
+  UnsupportedFeatureError = db.UnsupportedFeatureError;
+}
+
 HRESULT CInArchive::ReadDatabase2(
     DECL_EXTERNAL_CODECS_LOC_VARS
     CDbEx &db
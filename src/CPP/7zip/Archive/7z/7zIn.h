@@ -272,6 +272,9 @@ struct CDbEx final : public CDatabase
   }
 
   void FillLinks();
+
+  // libplzma: deep copy of the parsed database, used by the index cache.
+  void CopyFrom(const CDbEx &db);
   
   UInt64 GetFolderStreamPos(CNum folderIndex, unsigned indexInFolder) const
   {
@@ -444,6 +447,11 @@ public:
       CDbEx &db
       _7Z_DECODER_CRYPRO_VARS_DECL
       );
+
+  // libplzma: the signature header and the positions of the opened archive, i.e. the key of the index cache.
+  const Byte *GetStartHeader() const { return _header; }
+  UInt64 GetStartPosition() const { return _arhiveBeginStreamPosition; }
+  UInt64 GetFileEndPosition() const { return _fileEndPosition; }
 };
   
 }}
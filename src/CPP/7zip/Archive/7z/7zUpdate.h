@@ -70,6 +70,7 @@ struct CUpdateItem final
   CUpdateItem():
       // ParentSortIndex(-1),
       // IsAltStream(false),
+      Attrib(0), // libplzma: the analysis reads the posix attributes even if not defined
       IsAnti(false),
       IsDir(false),
       AttribDefined(false),
@@ -243,6 +243,41 @@ ARCHIVE_INTERFACE(IInArchiveGetStream, 0x40)
   STDMETHOD(GetStream)(UInt32 index, ISequentialInStream **stream) PURE;
 };
 
+/*
+  libplzma: random access inside the solid folders.
+  The checkpoints are the triplets of the folder index, the unpack offset and the pack offset
+  in the folder, where the decoding can be started from.
+*/
+ARCHIVE_INTERFACE(IArchiveSolidCheckpoints, 0xC0)
+{
+  STDMETHOD(BuildCheckpoints)(UInt32 *numCheckpoints) PURE;
+  STDMETHOD(GetCheckpoints)(const UInt64 **checkpoints, UInt32 *numCheckpoints) PURE;
+  STDMETHOD(SetCheckpoints)(const UInt64 *checkpoints, UInt32 numCheckpoints) PURE;
+};
+
+/*
+  libplzma: independent blocks of the stream(xz) located by the index.
+  GetNumberOfBlocks returns 0 if the index is not available or the blocks are too large.
+  DecodeBlock decodes the whole block to the (data) buffer of the block unpack size,
+  returns S_FALSE on data error.
+*/
+ARCHIVE_INTERFACE(IArchiveIndexedBlocks, 0xC1)
+{
+  STDMETHOD(GetNumberOfBlocks)(UInt32 *numBlocks) PURE;
+  STDMETHOD(GetBlockInfo)(UInt32 blockIndex, UInt64 *unpackPos, UInt64 *unpackSize) PURE;
+  STDMETHOD(DecodeBlock)(UInt32 blockIndex, Byte *data) PURE;
+};
+
+/*
+  libplzma: the memory required to decode the folder(solid block), the sum of
+  the LZMA/LZMA2 dictionaries and the PPMd memory of the folder coders.
+  The other coders are not counted, 0 if the folder has no such coders.
+*/
+ARCHIVE_INTERFACE(IArchiveFolderMemUsage, 0xC2)
+{
+  STDMETHOD(GetFolderMemUsage)(UInt32 folderIndex, UInt64 *memUsage) PURE;
+};
+
 
 ARCHIVE_INTERFACE(IArchiveOpenSetSubArchiveName, 0x50)
 {
@@ -47,6 +47,7 @@ class CHandler:
   public IInArchive,
   public IArchiveOpenSeq,
   public IInArchiveGetStream,
+  public IArchiveIndexedBlocks,
   public ISetProperties,
 
   #ifndef EXTRACT_ONLY
@@ -143,6 +144,7 @@ public:
   MY_QUERYINTERFACE_BEGIN2(IInArchive)
   MY_QUERYINTERFACE_ENTRY(IArchiveOpenSeq)
   MY_QUERYINTERFACE_ENTRY(IInArchiveGetStream)
+  MY_QUERYINTERFACE_ENTRY(IArchiveIndexedBlocks)
   MY_QUERYINTERFACE_ENTRY(ISetProperties)
   #ifndef EXTRACT_ONLY
   MY_QUERYINTERFACE_ENTRY(IOutArchive)
@@ -153,6 +155,9 @@ public:
   INTERFACE_IInArchive(;)
   STDMETHOD(OpenSeq)(ISequentialInStream *stream);
   STDMETHOD(GetStream)(UInt32 index, ISequentialInStream **stream);
+  STDMETHOD(GetNumberOfBlocks)(UInt32 *numBlocks);
+  STDMETHOD(GetBlockInfo)(UInt32 blockIndex, UInt64 *unpackPos, UInt64 *unpackSize);
+  STDMETHOD(DecodeBlock)(UInt32 blockIndex, Byte *data);
   STDMETHOD(SetProperties)(const wchar_t * const *names, const PROPVARIANT *values, UInt32 numProps);
 
   #ifndef EXTRACT_ONLY
@@ -996,6 +1001,59 @@ STDMETHODIMP CHandler::GetStream(UInt32 index, ISequentialInStream **stream)
 }
 
 
+// libplzma: the blocks of the index for the parallel and random access decoding.
+
+STDMETHODIMP CHandler::GetNumberOfBlocks(UInt32 *numBlocks)
+{
+  *numBlocks = 0;
+
+  if (!_blocks
+      || _blocksArraySize < 2
+      || _blocksArraySize - 1 > (UInt32)0xFFFFFFFF
+      || _maxBlocksSize == 0
+      || _maxBlocksSize > kMaxBlockSize_for_GetStream
+      || _maxBlocksSize != (size_t)_maxBlocksSize)
+    return S_OK;
+
+  UInt64 memSize;
+  if (!NSystem::GetRamSize(memSize))
+    memSize = (UInt64)(sizeof(size_t)) << 28;
+  if (_maxBlocksSize > memSize / 4)
+    return S_OK;
+
+  *numBlocks = (UInt32)(_blocksArraySize - 1);
+  return S_OK;
+}
+
+STDMETHODIMP CHandler::GetBlockInfo(UInt32 blockIndex, UInt64 *unpackPos, UInt64 *unpackSize)
+{
+  if (!_blocks || (size_t)blockIndex + 1 >= _blocksArraySize)
+    return E_INVALIDARG;
+  *unpackPos = _blocks[blockIndex].UnpackPos;
+  *unpackSize = _blocks[(size_t)blockIndex + 1].UnpackPos - _blocks[blockIndex].UnpackPos;
+  return S_OK;
+}
+
+STDMETHODIMP CHandler::DecodeBlock(UInt32 blockIndex, Byte *data)
+{
+  COM_TRY_BEGIN
+
+  if (!_blocks || !_stream || (size_t)blockIndex + 1 >= _blocksArraySize)
+    return E_INVALIDARG;
+
+  const CBlockInfo &block = _blocks[blockIndex];
+  const UInt64 unpackSize = _blocks[(size_t)blockIndex + 1].UnpackPos - block.UnpackPos;
+  if (unpackSize != (size_t)unpackSize)
+    return E_OUTOFMEMORY;
+
+  CXzUnpackerCPP2 xzu;
+  RINOK(SeekToPackPos(block.PackPos));
+  return NArchive::NXz::DecodeBlock(xzu, _seqStream, block.StreamFlags, block.PackSize, (size_t)unpackSize, data);
+
+  COM_TRY_END
+}
+
+
 static Int32 Get_Extract_OperationResult(const NCompress::NXz::CDecoder &decoder)
 {
   Int32 opRes;
@@ -400,6 +400,7 @@ const char * LIBPLZMA_NONNULL plzma_version(void) {
 
 #include "plzma_in_streams.hpp"
 #include "plzma_out_streams.hpp"
+#include "plzma_index_cache.hpp"
 
 #include "CPP/Common/Common.h"
 #include "CPP/Common/MyWindows.h"
@@ -517,6 +518,14 @@ void plzma_set_decoder_write_size(const plzma_size_t size) {
     plzma::kDecoderWriteSize = size;
 }
 
+plzma_size_t plzma_index_cache_capacity(void) {
+    return plzma::IndexCache::capacity();
+}
+
+void plzma_set_index_cache_capacity(const plzma_size_t capacity) {
+    plzma::IndexCache::setCapacity(capacity);
+}
+
 #include "plzma_c_bindings_private.hpp"
 
 #if !defined(LIBPLZMA_NO_C_BINDINGS)
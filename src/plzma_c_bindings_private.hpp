@@ -61,6 +61,14 @@ try { \
 
 
 
+#define LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY_WITH_ARG1(OBJ_TYPE, FROM_PTR, ARG1_PTR) \
+OBJ_TYPE createdCObject; \
+createdCObject.object = createdCObject.exception = nullptr; \
+if (FROM_PTR->exception || ARG1_PTR->exception) return createdCObject; \
+try { \
+
+
+
 #if defined(LIBPLZMA_HAVE_STD)
 #define LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH \
 } catch (const Exception & exception) { \
@@ -106,6 +114,12 @@ try { \
 
 
 
+#define LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_WITH_ARG1(OBJ_PTR, ARG1_PTR) \
+if (OBJ_PTR->exception || ARG1_PTR->exception) return; \
+try { \
+
+
+
 #define LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN_WITH_ARG2(OBJ_PTR, ARG1_PTR, ARG2_PTR, FAIL_RES) \
 if (OBJ_PTR->exception || ARG1_PTR->exception || ARG2_PTR->exception) return FAIL_RES; \
 try { \
@@ -49,6 +49,12 @@ namespace plzma {
 
     LIBPLZMA_CPP_API_PRIVATE(FILETIME) UnixTimeToFILETIME(const time_t t) noexcept;
     
+    /// @brief The flags column of the \a ItemTable.
+    enum ItemTableFlag : uint8_t {
+        ItemTableFlagEncrypted  = 1 << 0,
+        ItemTableFlagDir        = 1 << 1
+    };
+    
 } // namespace plzma
 
 #endif // !__PLZMA_COMMON_HPP__
@@ -26,6 +26,7 @@
 
 
 #include <cstddef>
+#include <cstring>
 
 #include "plzma_decoder_impl.hpp"
 
@@ -73,6 +74,84 @@ namespace plzma {
 #endif
     }
     
+    uint32_t DecoderImpl::numberOfThreads() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _numberOfThreads;
+    }
+    
+    void DecoderImpl::setNumberOfThreads(const uint32_t threads) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _numberOfThreads = threads;
+    }
+    
+    uint64_t DecoderImpl::memoryLimit() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _memoryLimit;
+    }
+    
+    void DecoderImpl::setMemoryLimit(const uint64_t limit) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _memoryLimit = limit;
+    }
+    
+    uint32_t DecoderImpl::extractWorkers() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _extractWorkers;
+    }
+    
+    void DecoderImpl::setExtractWorkers(const uint32_t workers) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _extractWorkers = workers;
+    }
+    
+    CMyComPtr<InStreamBase> DecoderImpl::cloneStream() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _stream->clone();
+    }
+    
+    CMyComPtr<IInArchive> DecoderImpl::openArchive(const CMyComPtr<InStreamBase> & stream) {
+        LIBPLZMA_UNIQUE_LOCK(lock, _mutex)
+#if defined(LIBPLZMA_NO_CRYPTO)
+        CMyComPtr<OpenCallback> openCallback(new OpenCallback(stream, _type));
+#else
+        CMyComPtr<OpenCallback> openCallback(new OpenCallback(stream, _password, _type));
+#endif
+        applySettings(openCallback->archive());
+        
+        LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
+        stream->open();
+        return openCallback->open() ? openCallback->archive() : CMyComPtr<IInArchive>();
+    }
+    
+    void DecoderImpl::applySettings(IInArchive * archive) {
+        using namespace NWindows::NCOM;
+        
+        if (_type == plzma_file_type_tar || (_numberOfThreads == 0 && _memoryLimit == 0)) {
+            return;
+        }
+        
+        CMyComPtr<ISetProperties> setProperties;
+        archive->QueryInterface(IID_ISetProperties, reinterpret_cast<void**>(&setProperties));
+        if (!setProperties) {
+            return;
+        }
+        
+        static const wchar_t * names[2] = {
+            L"mt",      // number of threads
+            L"memuse"   // memory usage limit
+        };
+        
+        CPropVariant values[2] = {
+            (_numberOfThreads > 0) ? CPropVariant(static_cast<UInt32>(_numberOfThreads)) : CPropVariant(true),
+            CPropVariant(static_cast<UInt64>(_memoryLimit))
+        };
+        
+        const HRESULT res = setProperties->SetProperties(names, values, (_memoryLimit > 0) ? 2 : 1);
+        if (res != S_OK) {
+            throw Exception(plzma_error_code_internal, "Can't apply archive properties.", __FILE__, __LINE__);
+        }
+    }
+    
     bool DecoderImpl::open() {
         LIBPLZMA_UNIQUE_LOCK(lock, _mutex)
         if (_opened || _opening) {
@@ -85,6 +164,7 @@ namespace plzma {
 #else
         _openCallback = CMyComPtr<OpenCallback>(new OpenCallback(_stream, _password, _type));
 #endif
+        applySettings(_openCallback->archive());
         bool opened = false;
         _opening = true;
         
@@ -119,6 +199,30 @@ namespace plzma {
         return process(NArchive::NExtract::NAskMode::kExtract, items);
     }
     
+    bool DecoderImpl::indicesForPattern(const char * LIBPLZMA_NONNULL pattern, CRecordVector<UInt32> & indices) {
+        const Path normalizedPattern(pattern);
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_extractCallback) {
+            throw Exception(plzma_error_code_invalid_arguments, "Can't select the items while the decoder is extracting or testing.", __FILE__, __LINE__);
+        }
+        if (!_opened) {
+            return false;
+        }
+        _openCallback->indicesForPattern(normalizedPattern.utf8(), indices);
+        return true;
+    }
+    
+    bool DecoderImpl::extractMatching(const char * LIBPLZMA_NONNULL pattern, const Path & path, const bool usingItemsFullPath) {
+        CRecordVector<UInt32> indices;
+        if (!indicesForPattern(pattern, indices)) {
+            return false;
+        }
+        if (_type == plzma_file_type_xz && indices.Size() > 1) {
+            throw Exception(plzma_error_code_invalid_arguments, "Xz type supports only one item.", __FILE__, __LINE__);
+        }
+        return process(NArchive::NExtract::NAskMode::kExtract, indices, path, usingItemsFullPath);
+    }
+    
     bool DecoderImpl::test(const SharedPtr<ItemArray> & items) {
         if (_type == plzma_file_type_xz && items->count() > 1) {
             throw Exception(plzma_error_code_invalid_arguments, "Xz type supports only one item.", __FILE__, __LINE__);
@@ -126,10 +230,111 @@ namespace plzma {
         return process(NArchive::NExtract::NAskMode::kTest, items);
     }
     
+    bool DecoderImpl::testMatching(const char * LIBPLZMA_NONNULL pattern) {
+        CRecordVector<UInt32> indices;
+        if (!indicesForPattern(pattern, indices)) {
+            return false;
+        }
+        return process(NArchive::NExtract::NAskMode::kTest, indices);
+    }
+    
     bool DecoderImpl::test() {
         return process(NArchive::NExtract::NAskMode::kTest);
     }
     
+    SharedPtr<ItemStream> DecoderImpl::openItemStream(const SharedPtr<Item> & item) {
+        if (!item) {
+            throw Exception(plzma_error_code_invalid_arguments, "No item to read.", __FILE__, __LINE__);
+        }
+        
+        CMyComPtr<InStreamBase> stream;
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (!_opened || _aborted) {
+                return SharedPtr<ItemStream>();
+            }
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+            stream = _stream->clone();
+#endif
+        }
+        
+        if (stream) {
+            CMyComPtr<IInArchive> archive = openArchive(stream);
+            if (!archive) {
+                stream->close();
+                return SharedPtr<ItemStream>();
+            }
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (_checkpoints.Size() > 0) {
+                CMyComPtr<IArchiveSolidCheckpoints> solidCheckpoints;
+                archive->QueryInterface(IID_IArchiveSolidCheckpoints, reinterpret_cast<void**>(&solidCheckpoints));
+                if (solidCheckpoints) {
+                    solidCheckpoints->SetCheckpoints(&_checkpoints.Front(), _checkpoints.Size() / 3);
+                }
+            }
+#if defined(LIBPLZMA_NO_CRYPTO)
+            return SharedPtr<ItemStream>(new ItemStreamImpl(item, stream, archive, _type));
+#else
+            return SharedPtr<ItemStream>(new ItemStreamImpl(item, stream, archive, _password, _type));
+#endif
+        }
+        
+        // The input stream can't be copied -> extract to memory with the archive of the decoder.
+        auto items = makeShared<ItemOutStreamArray>(1);
+        auto outStream = makeSharedOutStream(static_cast<size_t>(item->size()));
+        items->push(ItemOutStreamArray::ElementType(item, outStream));
+        if (!extract(items)) {
+            return SharedPtr<ItemStream>();
+        }
+        return SharedPtr<ItemStream>(new ItemStreamImpl(item, outStream->takeContent()));
+    }
+    
+    plzma_size_t DecoderImpl::buildCheckpoints() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (!_opened || _aborted || _extractCallback || _type != plzma_file_type_7z) {
+            return 0;
+        }
+        _checkpoints.Clear();
+        CMyComPtr<IArchiveSolidCheckpoints> solidCheckpoints;
+        _openCallback->archive()->QueryInterface(IID_IArchiveSolidCheckpoints, reinterpret_cast<void**>(&solidCheckpoints));
+        UInt32 numCheckpoints = 0;
+        if (!solidCheckpoints || solidCheckpoints->BuildCheckpoints(&numCheckpoints) != S_OK || numCheckpoints == 0) {
+            return 0;
+        }
+        const UInt64 * checkpoints = nullptr;
+        solidCheckpoints->GetCheckpoints(&checkpoints, &numCheckpoints);
+        _checkpoints.ClearAndReserve(numCheckpoints * 3);
+        for (UInt32 i = 0; i < numCheckpoints * 3; i++) {
+            _checkpoints.AddInReserved(checkpoints[i]);
+        }
+        return static_cast<plzma_size_t>(numCheckpoints);
+    }
+    
+    SharedPtr<RandomAccessStream> DecoderImpl::openRandomAccessStream() {
+        CMyComPtr<InStreamBase> stream;
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (!_opened || _aborted) {
+                return SharedPtr<RandomAccessStream>();
+            }
+            if (_type != plzma_file_type_xz) {
+                throw Exception(plzma_error_code_invalid_arguments, "Random access is supported only for xz archives.", __FILE__, __LINE__);
+            }
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+            stream = _stream->clone();
+#endif
+        }
+        if (!stream) {
+            throw Exception(plzma_error_code_invalid_arguments, "The input stream can't be copied for random access.", __FILE__, __LINE__);
+        }
+        CMyComPtr<IInArchive> archive = openArchive(stream);
+        if (!archive) {
+            stream->close();
+            return SharedPtr<RandomAccessStream>();
+        }
+        return SharedPtr<RandomAccessStream>(new RandomAccessStreamImpl(stream, archive));
+    }
+    
     void DecoderImpl::abort() {
         LIBPLZMA_LOCKGUARD(lock, _mutex)
         _aborted = true;
@@ -155,11 +360,44 @@ namespace plzma {
         return _opened ? _openCallback->allItems() : SharedPtr<ItemArray>();
     }
     
+    SharedPtr<ItemTable> DecoderImpl::itemTable() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _opened ? _openCallback->itemTable() : SharedPtr<ItemTable>();
+    }
+    
     SharedPtr<Item> DecoderImpl::itemAt(const plzma_size_t index) const {
         LIBPLZMA_LOCKGUARD(lock, _mutex)
         return _opened ? _openCallback->itemAt(index) : SharedPtr<Item>();
     }
     
+    SharedPtr<Item> DecoderImpl::itemAtPath(const Path & path) const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_opened) {
+            const char * utf8 = path.utf8();
+            plzma_size_t index = 0;
+            if (_openCallback->indexForPath(utf8, strlen(utf8), index)) {
+                return _openCallback->itemAt(index);
+            }
+        }
+        return SharedPtr<Item>();
+    }
+    
+    SharedPtr<ItemArray> DecoderImpl::itemsAtPaths(const Path * LIBPLZMA_NONNULL paths, const plzma_size_t count) const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (!_opened) {
+            return SharedPtr<ItemArray>();
+        }
+        auto items = makeShared<ItemArray>(count);
+        for (plzma_size_t i = 0; i < count; i++) {
+            const char * utf8 = paths[i].utf8();
+            plzma_size_t index = 0;
+            if (_openCallback->indexForPath(utf8, strlen(utf8), index)) {
+                items->push(_openCallback->itemAt(index));
+            }
+        }
+        return items;
+    }
+    
 #if !defined(LIBPLZMA_NO_C_BINDINGS)
     void DecoderImpl::setUtf8Callback(plzma_progress_delegate_utf8_callback LIBPLZMA_NULLABLE callback) {
 #if !defined(LIBPLZMA_NO_PROGRESS)
@@ -251,6 +489,42 @@ void plzma_decoder_set_password_utf8_string(plzma_decoder * LIBPLZMA_NONNULL dec
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(decoder)
 }
 
+uint32_t plzma_decoder_number_of_threads(plzma_decoder * LIBPLZMA_NONNULL decoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(decoder, 0)
+    return static_cast<DecoderImpl *>(decoder->object)->numberOfThreads();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(decoder, 0)
+}
+
+void plzma_decoder_set_number_of_threads(plzma_decoder * LIBPLZMA_NONNULL decoder, const uint32_t threads) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(decoder)
+    static_cast<DecoderImpl *>(decoder->object)->setNumberOfThreads(threads);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(decoder)
+}
+
+uint64_t plzma_decoder_memory_limit(plzma_decoder * LIBPLZMA_NONNULL decoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(decoder, 0)
+    return static_cast<DecoderImpl *>(decoder->object)->memoryLimit();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(decoder, 0)
+}
+
+void plzma_decoder_set_memory_limit(plzma_decoder * LIBPLZMA_NONNULL decoder, const uint64_t limit) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(decoder)
+    static_cast<DecoderImpl *>(decoder->object)->setMemoryLimit(limit);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(decoder)
+}
+
+uint32_t plzma_decoder_extract_workers(plzma_decoder * LIBPLZMA_NONNULL decoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(decoder, 0)
+    return static_cast<DecoderImpl *>(decoder->object)->extractWorkers();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(decoder, 0)
+}
+
+void plzma_decoder_set_extract_workers(plzma_decoder * LIBPLZMA_NONNULL decoder, const uint32_t workers) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(decoder)
+    static_cast<DecoderImpl *>(decoder->object)->setExtractWorkers(workers);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(decoder)
+}
+
 bool plzma_decoder_open(plzma_decoder * LIBPLZMA_NONNULL decoder) {
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(decoder, false)
     return static_cast<DecoderImpl *>(decoder->object)->open();
@@ -276,6 +550,13 @@ plzma_item_array plzma_decoder_items(plzma_decoder * LIBPLZMA_NONNULL decoder) {
     LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
 }
 
+plzma_item_table plzma_decoder_item_table(plzma_decoder * LIBPLZMA_NONNULL decoder) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_item_table, decoder)
+    auto table = static_cast<DecoderImpl *>(decoder->object)->itemTable();
+    createdCObject.object = static_cast<void *>(table.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
 plzma_item plzma_decoder_item_at(plzma_decoder * LIBPLZMA_NONNULL decoder, const plzma_size_t index) {
     LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_item, decoder)
     auto item = static_cast<DecoderImpl *>(decoder->object)->itemAt(index);
@@ -283,6 +564,32 @@ plzma_item plzma_decoder_item_at(plzma_decoder * LIBPLZMA_NONNULL decoder, const
     LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
 }
 
+plzma_item plzma_decoder_item_at_path(plzma_decoder * LIBPLZMA_NONNULL decoder, const plzma_path * LIBPLZMA_NONNULL path) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY_WITH_ARG1(plzma_item, decoder, path)
+    auto item = static_cast<DecoderImpl *>(decoder->object)->itemAtPath(*static_cast<const Path *>(path->object));
+    createdCObject.object = static_cast<void *>(item.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
+plzma_item_array plzma_decoder_items_at_paths(plzma_decoder * LIBPLZMA_NONNULL decoder,
+                                              const plzma_path * LIBPLZMA_NULLABLE paths,
+                                              const plzma_size_t count) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_item_array, decoder)
+    const DecoderImpl * decoderImpl = static_cast<const DecoderImpl *>(decoder->object);
+    auto items = makeShared<ItemArray>(count);
+    for (plzma_size_t i = 0; i < count; i++) {
+        if (paths[i].exception) {
+            continue;
+        }
+        auto item = decoderImpl->itemAtPath(*static_cast<const Path *>(paths[i].object));
+        if (item) {
+            items->push(static_cast<SharedPtr<Item> &&>(item));
+        }
+    }
+    createdCObject.object = static_cast<void *>(items.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
 bool plzma_decoder_extract_all_items_to_path(plzma_decoder * LIBPLZMA_NONNULL decoder,
                                              const plzma_path * LIBPLZMA_NONNULL path,
                                              const bool items_full_path) {
@@ -319,12 +626,51 @@ bool plzma_decoder_test_items(plzma_decoder * LIBPLZMA_NONNULL decoder,
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(decoder, false)
 }
 
+bool plzma_decoder_extract_matching_items_to_path(plzma_decoder * LIBPLZMA_NONNULL decoder,
+                                                  const char * LIBPLZMA_NONNULL pattern,
+                                                  const plzma_path * LIBPLZMA_NONNULL path,
+                                                  const bool items_full_path) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN_WITH_ARG1(decoder, path, false)
+    return static_cast<DecoderImpl *>(decoder->object)->extractMatching(pattern,
+                                                                        *static_cast<const Path *>(path->object),
+                                                                        items_full_path);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(decoder, false)
+}
+
+bool plzma_decoder_test_matching_items(plzma_decoder * LIBPLZMA_NONNULL decoder, const char * LIBPLZMA_NONNULL pattern) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(decoder, false)
+    return static_cast<DecoderImpl *>(decoder->object)->testMatching(pattern);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(decoder, false)
+}
+
 bool plzma_decoder_test(plzma_decoder * LIBPLZMA_NONNULL decoder) {
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(decoder, false)
     return static_cast<DecoderImpl *>(decoder->object)->test();
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(decoder, false)
 }
 
+plzma_item_stream plzma_decoder_open_item_stream(plzma_decoder * LIBPLZMA_NONNULL decoder,
+                                                 plzma_item * LIBPLZMA_NONNULL item) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_item_stream, decoder)
+    SharedPtr<Item> itemSPtr(static_cast<Item *>(item->object));
+    auto stream = static_cast<DecoderImpl *>(decoder->object)->openItemStream(itemSPtr);
+    createdCObject.object = static_cast<void *>(stream.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
+plzma_size_t plzma_decoder_build_checkpoints(plzma_decoder * LIBPLZMA_NONNULL decoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(decoder, 0)
+    return static_cast<DecoderImpl *>(decoder->object)->buildCheckpoints();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(decoder, 0)
+}
+
+plzma_random_access_stream plzma_decoder_open_random_access_stream(plzma_decoder * LIBPLZMA_NONNULL decoder) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_random_access_stream, decoder)
+    auto stream = static_cast<DecoderImpl *>(decoder->object)->openRandomAccessStream();
+    createdCObject.object = static_cast<void *>(stream.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
 void plzma_decoder_release(plzma_decoder * LIBPLZMA_NONNULL decoder) {
     plzma_object_exception_release(decoder);
     SharedPtr<DecoderImpl> decoderSPtr;
@@ -36,6 +36,8 @@
 #include "plzma_out_streams.hpp"
 #include "plzma_open_callback.hpp"
 #include "plzma_extract_callback.hpp"
+#include "plzma_item_stream.hpp"
+#include "plzma_random_access_stream.hpp"
 #include "plzma_common.hpp"
 #include "plzma_c_bindings_private.hpp"
 #include "plzma_progress.hpp"
@@ -51,10 +53,11 @@
 #include "CPP/7zip/IPassword.h"
 #include "CPP/7zip/ICoder.h"
 #include "CPP/Windows/PropVariant.h"
+#include "CPP/Windows/System.h"
 
 namespace plzma {
     
-    class DecoderImpl final : public CMyUnknownImp, public Decoder {
+    class DecoderImpl final : public CMyUnknownImp, public Decoder, public ExtractArchiveProvider {
     private:
         friend struct SharedPtr<DecoderImpl>;
         LIBPLZMA_MUTEX(mutable _mutex)
@@ -67,13 +70,19 @@ namespace plzma {
 #if !defined(LIBPLZMA_NO_PROGRESS)
         SharedPtr<Progress> _progress;
 #endif
+        uint64_t _memoryLimit = 0;
+        uint32_t _numberOfThreads = 0;
+        uint32_t _extractWorkers = 1;
         plzma_file_type _type = plzma_file_type_7z;
+        CRecordVector<UInt64> _checkpoints; // see 'IArchiveSolidCheckpoints'
         bool _opened = false;
         bool _opening = false;
         bool _aborted = false;
         
         virtual void retain() override final;
         virtual void release() override final;
+        void applySettings(IInArchive * archive);
+        bool indicesForPattern(const char * LIBPLZMA_NONNULL pattern, CRecordVector<UInt32> & indices);
         
         template<typename ... ARGS>
         bool process(ARGS&&... args) {
@@ -98,6 +107,7 @@ namespace plzma {
             CMyComPtr<ExtractCallback> extractCallback(new ExtractCallback(_openCallback->archive(), _password, _progress, _type));
 #  endif
 #endif
+            extractCallback->setWorkers((_extractWorkers > 0) ? _extractWorkers : NWindows::NSystem::GetNumberOfProcessors(), _memoryLimit, this);
             _extractCallback = extractCallback;
             
             LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
@@ -122,18 +132,36 @@ namespace plzma {
         virtual void setPassword(const wchar_t * LIBPLZMA_NULLABLE password) override final;
         virtual void setPassword(const char * LIBPLZMA_NULLABLE password) override final;
         virtual void setProgressDelegate(ProgressDelegate * LIBPLZMA_NULLABLE delegate) override final;
+        virtual uint32_t numberOfThreads() const override final;
+        virtual void setNumberOfThreads(const uint32_t threads) override final;
+        virtual uint64_t memoryLimit() const override final;
+        virtual void setMemoryLimit(const uint64_t limit) override final;
+        virtual uint32_t extractWorkers() const override final;
+        virtual void setExtractWorkers(const uint32_t workers) override final;
         virtual bool open() override final;
         virtual void abort() override final;
         virtual plzma_size_t count() const override final;
         virtual SharedPtr<ItemArray> items() const override final;
+        virtual SharedPtr<ItemTable> itemTable() const override final;
         virtual SharedPtr<Item> itemAt(const plzma_size_t index) const override final;
+        virtual SharedPtr<Item> itemAtPath(const Path & path) const override final;
+        virtual SharedPtr<ItemArray> itemsAtPaths(const Path * LIBPLZMA_NONNULL paths, const plzma_size_t count) const override final;
         virtual bool extract(const Path & path, const bool usingItemsFullPath = true) override final;
         virtual bool extract(const SharedPtr<ItemArray> & items,
                              const Path & path,
                              const bool usingItemsFullPath = true) override final;
         virtual bool extract(const SharedPtr<ItemOutStreamArray> & items) override final;
+        virtual bool extractMatching(const char * LIBPLZMA_NONNULL pattern, const Path & path, const bool usingItemsFullPath = true) override final;
         virtual bool test(const SharedPtr<ItemArray> & items) override final;
+        virtual bool testMatching(const char * LIBPLZMA_NONNULL pattern) override final;
         virtual bool test() override final;
+        virtual SharedPtr<ItemStream> openItemStream(const SharedPtr<Item> & item) override final;
+        virtual plzma_size_t buildCheckpoints() override final;
+        virtual SharedPtr<RandomAccessStream> openRandomAccessStream() override final;
+        
+        // ExtractArchiveProvider
+        virtual CMyComPtr<InStreamBase> cloneStream() override final;
+        virtual CMyComPtr<IInArchive> openArchive(const CMyComPtr<InStreamBase> & stream) override final;
         
 #if !defined(LIBPLZMA_NO_C_BINDINGS)
         void setUtf8Callback(plzma_progress_delegate_utf8_callback LIBPLZMA_NULLABLE callback);
@@ -0,0 +1,352 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+#include <cstddef>
+
+#include "plzma_dir_scanner.hpp"
+#include "plzma_path_utils.hpp"
+
+#include "CPP/Windows/System.h"
+
+#if defined(LIBPLZMA_POSIX)
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace plzma {
+    
+    struct DirScannerDIR final {
+        DIR * dir = nullptr;
+        ~DirScannerDIR() noexcept {
+            if (dir) {
+                closedir(dir);
+            }
+        }
+    };
+    
+    using namespace pathUtils;
+    
+    static void dirScannerStat(const struct stat & statbuf, plzma_path_stat & stat) noexcept {
+        stat.size = static_cast<uint64_t>(statbuf.st_size);
+        stat.creation = statbuf.st_ctime;
+        stat.last_access = statbuf.st_atime;
+        stat.last_modification = statbuf.st_mtime;
+    }
+    
+    DirScanner::Dir::~Dir() noexcept {
+        for (plzma_size_t i = 0, n = entries.count(); i < n; i++) {
+            delete entries.at(i).dir;
+        }
+    }
+    
+    void DirScanner::push(Worker * worker, Dir * dir) {
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            _pending++; // before the push, the stolen directory can't be finished earlier
+        }
+        try {
+            LIBPLZMA_LOCKGUARD(lock, worker->mutex)
+            worker->stack.push(dir);
+        } catch (...) {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            _pending--;
+            throw;
+        }
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        _workEvent.Set();
+#endif
+    }
+    
+    DirScanner::Dir * DirScanner::pop(Worker * worker) {
+        Dir * dir = nullptr;
+        bool more = false;
+        {
+            LIBPLZMA_LOCKGUARD(lock, worker->mutex)
+            plzma_size_t count = worker->stack.count();
+            if (count > worker->bottom) {
+                dir = worker->stack.at(--count);
+                worker->stack.pop();
+                if (count == worker->bottom) {
+                    worker->stack.clear();
+                    worker->bottom = 0;
+                }
+                more = worker->stack.count() > worker->bottom;
+            }
+        }
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        const unsigned workersCount = _workers.Size();
+        unsigned index = 0;
+        while (&_workers[index] != worker) { index++; }
+        for (unsigned i = 1; !dir && i < workersCount; i++) {
+            Worker & other = _workers[(index + i) % workersCount];
+            LIBPLZMA_LOCKGUARD(lock, other.mutex)
+            const plzma_size_t count = other.stack.count();
+            if (count > other.bottom) {
+                dir = other.stack.at(other.bottom++);
+                if (count == other.bottom) {
+                    other.stack.clear();
+                    other.bottom = 0;
+                }
+                more = other.stack.count() > other.bottom;
+            }
+        }
+        if (more) {
+            _workEvent.Set(); // the pushes signal once for several waiting workers, wake up the next one
+        }
+#else
+        (void)more;
+#endif
+        return dir;
+    }
+    
+    void DirScanner::scanDir(Worker * worker, Dir * dir) {
+        const char * path = (dir->path.count() > 0) ? dir->path.utf8() : ".";
+        const int fd = openat(_rootFd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd == -1) {
+            return; // skip, same as the not opened directory of the iterator
+        }
+        DirScannerDIR d;
+        if ( !(d.dir = fdopendir(fd)) ) {
+            close(fd);
+            return;
+        }
+        const int dfd = dirfd(d.dir);
+        plzma_size_t filesCount = 0;
+        struct dirent * dp;
+        struct stat statbuf;
+        while ( (dp = readdir(d.dir)) ) {
+            const char * name = dp->d_name;
+            if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) { continue; }
+            bool isDir = false, stated = false;
+            switch (dp->d_type) {
+                case DT_DIR:
+                    isDir = true;
+                    break;
+                case DT_REG:
+                    break;
+                case DT_LNK: // the iterator follows only the links to the directories
+                    if (!(_mode & plzma_open_dir_mode_follow_symlinks) ||
+                        fstatat(dfd, name, &statbuf, 0) != 0 ||
+                        !S_ISDIR(statbuf.st_mode)) {
+                        continue;
+                    }
+                    isDir = true;
+                    break;
+                case DT_UNKNOWN:
+                    if (fstatat(dfd, name, &statbuf, 0) != 0) { continue; }
+                    isDir = S_ISDIR(statbuf.st_mode);
+                    if (!isDir && !S_ISREG(statbuf.st_mode)) { continue; }
+                    stated = true;
+                    break;
+                default:
+                    continue;
+            }
+            Entry & entry = dir->entries.emplace();
+            entry.name.set(name);
+            entry.stat = plzma_path_stat{0, 0, 0, 0};
+            if (isDir) {
+                entry.dir = new Dir();
+                entry.dir->path = dir->path;
+                entry.dir->path.append(entry.name);
+                push(worker, entry.dir);
+            } else {
+                if (stated || fstatat(dfd, name, &statbuf, 0) == 0) {
+                    dirScannerStat(statbuf, entry.stat);
+                }
+                filesCount++;
+            }
+        }
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _filesCount += filesCount;
+    }
+    
+    void DirScanner::work(Worker * worker) {
+        for (;;) {
+            Dir * dir = nullptr;
+            try {
+                dir = pop(worker);
+                if (dir) {
+                    bool failed;
+                    {
+                        LIBPLZMA_LOCKGUARD(lock, _mutex)
+                        failed = _exception != nullptr;
+                    }
+                    if (!failed) { // otherwise drain the pushed directories
+                        scanDir(worker, dir);
+                    }
+                }
+            } catch (const Exception & exception) {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (!_exception) {
+                    _exception = exception.moveToHeapCopy();
+                }
+            }
+#if defined(LIBPLZMA_HAVE_STD)
+            catch (const std::exception & exception) {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (!_exception) {
+                    _exception = Exception::create(plzma_error_code_internal, exception.what(), __FILE__, __LINE__);
+                }
+            }
+#endif
+            catch (...) {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (!_exception) {
+                    _exception = Exception::create(plzma_error_code_unknown, "Can't scan directory.", __FILE__, __LINE__);
+                }
+            }
+            
+            LIBPLZMA_UNIQUE_LOCK(lock, _mutex)
+            if (dir) {
+                _pending--;
+            }
+            const bool finished = _pending == 0;
+            LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
+            if (finished) {
+                break;
+            }
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+            if (!dir) {
+                break;
+            }
+#else
+            if (!dir) {
+                _workEvent.Lock();
+            }
+#endif
+        }
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        _workEvent.Set(); // wake up the next waiting worker
+#endif
+    }
+    
+    THREAD_FUNC_DECL DirScanner::workerThread(void * param) {
+        Worker * worker = static_cast<Worker *>(param);
+        worker->owner->work(worker);
+        return 0;
+    }
+    
+    void DirScanner::flatten(const Dir & dir, Vector<File> & files) const {
+        for (plzma_size_t i = 0, n = dir.entries.count(); i < n; i++) {
+            const Entry & entry = dir.entries.at(i);
+            if (entry.dir) {
+                flatten(*entry.dir, files);
+            } else {
+                File & file = files.emplace();
+                file.path = dir.path;
+                file.path.append(entry.name);
+                file.stat = entry.stat;
+            }
+        }
+    }
+    
+    void DirScanner::scan(const plzma_size_t maxWorkers) {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        const unsigned workersCount = 1;
+#else
+        const unsigned workersCount = (maxWorkers > 0) ? maxWorkers : NWindows::NSystem::GetNumberOfProcessors();
+        if (_workEvent.Create() != 0) {
+            throw Exception(plzma_error_code_internal, "Can't create directory scanner event.", __FILE__, __LINE__);
+        }
+#endif
+        for (unsigned i = 0; i < workersCount; i++) {
+            _workers.AddNew().owner = this;
+        }
+        
+        // The root is scanned in the current thread, the workers are started only for the sub-directories.
+        Worker * mainWorker = &_workers[0];
+        push(mainWorker, &_rootDir);
+        Dir * rootDir = pop(mainWorker);
+        scanDir(mainWorker, rootDir);
+        _pending--;
+        
+        if (_pending > 0) {
+            // If the thread can't be created, the rest of the workers are not started. Their stacks are empty,
+            // so nothing waits for them and the started workers(at least the main one) scan all directories.
+            unsigned startedCount = 1;
+            for (; startedCount < workersCount; startedCount++) {
+                if (_workers[startedCount].thread.Create(workerThread, &_workers[startedCount]) != 0) {
+                    break;
+                }
+            }
+            work(mainWorker);
+            for (unsigned i = 1; i < startedCount; i++) {
+                _workers[i].thread.Wait_Close();
+            }
+        }
+        
+        if (_exception) {
+            Exception * exception = _exception;
+            _exception = nullptr;
+            Exception localException(static_cast<Exception &&>(*exception));
+            delete exception;
+            throw localException;
+        }
+    }
+    
+    Vector<DirScanner::File> DirScanner::takeFiles() {
+        Vector<File> files;
+        files.reserve(_filesCount);
+        flatten(_rootDir, files);
+        return files;
+    }
+    
+    DirScanner::DirScanner(const Path & root, const plzma_open_dir_mode_t mode) :
+        _root(root),
+        _mode(mode) {
+            const char * path = ".";
+            if (_root.count() > 0) {
+                path = _root.utf8();
+                bool isDir = false;
+                if (!pathExists<char>(path, &isDir) || !isDir) {
+                    Exception exception(plzma_error_code_io, nullptr, __FILE__, __LINE__);
+                    exception.setWhat("Can't open and iterate path: ", path, nullptr);
+                    exception.setReason("Path not found or not a directory.", nullptr);
+                    throw exception;
+                }
+            }
+            if ( (_rootFd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1 ) {
+                Exception exception(plzma_error_code_io, nullptr, __FILE__, __LINE__);
+                exception.setWhat("Can't open directory: ", path, nullptr);
+                exception.setReason("No open directory permissions.", nullptr);
+                throw exception;
+            }
+    }
+    
+    DirScanner::~DirScanner() noexcept {
+        if (_rootFd != -1) {
+            close(_rootFd);
+        }
+        delete _exception;
+    }
+    
+} // namespace plzma
+
+#endif // LIBPLZMA_POSIX
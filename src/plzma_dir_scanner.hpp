@@ -0,0 +1,119 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#ifndef __PLZMA_DIR_SCANNER_HPP__
+#define __PLZMA_DIR_SCANNER_HPP__ 1
+
+#include <cstddef>
+
+#include "../libplzma.hpp"
+#include "plzma_private.hpp"
+#include "plzma_mutex.hpp"
+
+#include "CPP/Common/Common.h"
+#include "CPP/Common/MyWindows.h"
+#include "CPP/Common/MyVector.h"
+#include "CPP/Windows/Thread.h"
+#include "CPP/Windows/Synchronization.h"
+
+#if defined(LIBPLZMA_POSIX)
+
+namespace plzma {
+    
+    /// @brief Recursively collects the files of the directory with their stats.
+    ///
+    /// The sub-directories are scanned by the workers, each one takes the directories from own stack and
+    /// steals the oldest ones from the stacks of the other workers when own is empty. The entries are read
+    /// and stated relative to the descriptor of the directory, the type of the entry is taken from the
+    /// directory entry when possible. The files are reported in the same order as the \a Path::Iterator does.
+    class DirScanner final {
+    public:
+        struct File final {
+            Path path; // relative to the root
+            plzma_path_stat stat;
+        };
+        
+    private:
+        struct Dir;
+        struct Entry final {
+            Path name;
+            plzma_path_stat stat;
+            Dir * dir = nullptr; // not null for the sub-directory
+        };
+        struct Dir final {
+            Path path; // relative to the root
+            Vector<Entry> entries;
+            ~Dir() noexcept;
+        };
+        struct Worker final {
+            LIBPLZMA_MUTEX(mutex)
+            NWindows::CThread thread;
+            Vector<Dir *> stack; // the owner pops from the top, the others steal from the bottom
+            plzma_size_t bottom = 0;
+            DirScanner * owner = nullptr;
+        };
+        
+        Path _root;
+        Dir _rootDir;
+        LIBPLZMA_MUTEX(_mutex)
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        NWindows::NSynchronization::CAutoResetEvent _workEvent; // signaled after push or when no more work
+#endif
+        CObjectVector<Worker> _workers;
+        Exception * _exception = nullptr;
+        int _rootFd = -1;
+        plzma_size_t _pending = 0; // the directories pushed and not yet scanned
+        plzma_size_t _filesCount = 0;
+        plzma_open_dir_mode_t _mode = 0;
+        
+        void push(Worker * worker, Dir * dir);
+        Dir * pop(Worker * worker);
+        void scanDir(Worker * worker, Dir * dir);
+        void work(Worker * worker);
+        void flatten(const Dir & dir, Vector<File> & files) const;
+        static THREAD_FUNC_DECL workerThread(void * param);
+        
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(DirScanner)
+        
+    public:
+        /// @brief Scans the directory.
+        /// @param maxWorkers The maximum number of the workers, \a 0 for the number of the processors.
+        /// @exception The \a Exception with \a plzma_error_code_io code in case if the root path is not a directory or can't be opened.
+        void scan(const plzma_size_t maxWorkers = 0);
+        
+        /// @return The scanned files in the order of the directory iteration, the root directory is not included.
+        Vector<File> takeFiles();
+        
+        DirScanner(const Path & root, const plzma_open_dir_mode_t mode);
+        ~DirScanner() noexcept;
+    };
+    
+} // namespace plzma
+
+#endif // LIBPLZMA_POSIX
+
+#endif // !__PLZMA_DIR_SCANNER_HPP__
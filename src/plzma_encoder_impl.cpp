@@ -29,11 +29,14 @@
 
 #include "plzma_encoder_impl.hpp"
 #include "plzma_decoder_impl.hpp"
+#include "plzma_dir_scanner.hpp"
 #include "plzma_in_streams.hpp"
 #include "plzma_common.hpp"
 #include "plzma_open_callback.hpp"
 #include "plzma_c_bindings_private.hpp"
 
+#include "CPP/Common/IntToString.h"
+
 #include <stdint.h>
 #include <limits.h>
 
@@ -113,13 +116,13 @@ namespace plzma {
             NWindows::NCOM::CPropVariant prop;
             switch (propID) {
                 case kpidIsAnti: prop = false; break;
-                case kpidPath: prop = _source.archivePath.wide(); break;
+                case kpidPath: prop = _source.archivePath->wide(); break;
                 case kpidIsDir: prop = false; break;
-                case kpidSize: prop = _source.stat.size; break;
+                case kpidSize: prop = _source.stat->size; break;
                 //case kpidAttrib: prop = dirItem.Attrib; break; // 9
-                case kpidCTime: prop = UnixTimeToFILETIME(_source.stat.creation); break;
-                case kpidATime: prop = UnixTimeToFILETIME(_source.stat.last_access); break;
-                case kpidMTime: prop = UnixTimeToFILETIME(_source.stat.last_modification); break;
+                case kpidCTime: prop = UnixTimeToFILETIME(_source.stat->creation); break;
+                case kpidATime: prop = UnixTimeToFILETIME(_source.stat->last_access); break;
+                case kpidMTime: prop = UnixTimeToFILETIME(_source.stat->last_modification); break;
                 
                 // Tar
                 case kpidSymLink:
@@ -164,7 +167,13 @@ namespace plzma {
             }
             
             if (!_source.stream) {
-                _source.stream = SharedPtr<InStreamBase>(new InFileStream(static_cast<Path &&>(_source.path)));
+                if (_source.dirPath) {
+                    Path fullPath(*_source.dirPath);
+                    fullPath.append(*_source.path);
+                    _source.stream = SharedPtr<InStreamBase>(new InFileStream(static_cast<Path &&>(fullPath)));
+                } else {
+                    _source.stream = SharedPtr<InStreamBase>(new InFileStream(*_source.path));
+                }
             }
             
             InStreamBase * baseStream = _source.stream.get();
@@ -173,7 +182,7 @@ namespace plzma {
             baseStream->open();
             
 #if !defined(LIBPLZMA_NO_PROGRESS)
-            _progress->setPath(_source.archivePath);
+            _progress->setPath(*_source.archivePath);
 #endif
             
             return S_OK;
@@ -194,6 +203,61 @@ namespace plzma {
         return S_OK;
     }
     
+    STDMETHODIMP EncoderImpl::GetStream2(UInt32 index, ISequentialInStream ** inStream, UInt32 notifyOp) {
+        if (notifyOp != NUpdateNotifyOp::kAnalyze) {
+            return GetStream(index, inStream);
+        }
+        try {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            *inStream = nullptr;
+            if (_result != S_OK) {
+                return _result;
+            } else if (index >= _sources.count()) {
+                return E_FAIL;
+            }
+            
+            const SourceEntry & entry = _sources.at(index);
+            if (entry.type == SourceTypeStream) {
+                return S_OK; // the streams are read once, without analysis
+            }
+            Path path;
+            if (entry.type == SourceTypeSubDirFile) {
+                const auto & subDir = _subDirs.at(entry.subDirIndex);
+                path = subDir.path;
+                path.append(subDir.files.at(entry.index).path);
+            } else {
+                path = _files.at(entry.index).path;
+            }
+            CMyComPtr<InStreamBase> stream(new InFileStream(static_cast<Path &&>(path)));
+            try {
+                stream->open();
+            } catch (...) {
+                return S_OK; // not analyzed, the error will be reported by the 'GetStream'
+            }
+            *inStream = stream.Detach();
+            return S_OK;
+        } catch (const Exception & exception) {
+            _exception = exception.moveToHeapCopy();
+            return E_FAIL;
+        }
+#if defined(LIBPLZMA_HAVE_STD)
+        catch (const std::exception & exception) {
+            _exception = Exception::create(plzma_error_code_internal, exception.what(), __FILE__, __LINE__);
+            return E_FAIL;
+        }
+#endif
+        catch (...) {
+            _exception = Exception::create(plzma_error_code_not_enough_memory, "Can't create input file stream.", __FILE__, __LINE__);
+            return E_FAIL;
+        }
+        return S_OK;
+    }
+    
+    STDMETHODIMP EncoderImpl::ReportOperation(UInt32 indexType, UInt32 index, UInt32 notifyOp) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _result;
+    }
+    
     STDMETHODIMP EncoderImpl::SetOperationResult(Int32 operationResult) {
         try {
             LIBPLZMA_LOCKGUARD(lock, _mutex)
@@ -309,6 +373,25 @@ namespace plzma {
         }
     }
     
+    void EncoderImpl::addStream(const SharedPtr<InStreamBase> & stream, const Path & archivePath, const uint64_t size) {
+        for (plzma_size_t i = 0, n = _streams.count(); i < n; i++) {
+            const auto & as = _streams.at(i);
+            if (as.archivePath == archivePath) {
+                Exception exception(plzma_error_code_invalid_arguments, nullptr, __FILE__, __LINE__);
+                exception.setWhat("Can't add duplicated stream with archive path: ", archivePath.utf8(), nullptr);
+                throw exception;
+            }
+        }
+        AddedStream addedStream;
+        addedStream.stream = stream;
+        addedStream.archivePath = archivePath;
+        plzma_path_stat stat;
+        stat.creation = stat.last_access = stat.last_modification = time(nullptr);
+        stat.size = size;
+        addedStream.stat = stat;
+        _streams.push(static_cast<AddedStream &&>(addedStream));
+    }
+    
     void EncoderImpl::add(const SharedPtr<InStream> & stream, const Path & archivePath) {
         LIBPLZMA_LOCKGUARD(lock, _mutex)
         if (_archive || _opening || _result == E_ABORT) {
@@ -318,35 +401,113 @@ namespace plzma {
             throw Exception(plzma_error_code_invalid_arguments, "Can't add stream without archive path.", __FILE__, __LINE__);
         }
         if (stream) {
-            for (plzma_size_t i = 0, n = _streams.count(); i < n; i++) {
-                const auto & as = _streams.at(i);
-                if (as.archivePath == archivePath) {
-                    Exception exception(plzma_error_code_invalid_arguments, nullptr, __FILE__, __LINE__);
-                    exception.setWhat("Can't add duplicated stream with archive path: ", archivePath.utf8(), nullptr);
-                    throw exception;
-                }
-            }
-            AddedStream addedStream;
-            addedStream.stream = stream.cast<InStreamBase>();
-            addedStream.archivePath = archivePath;
-            plzma_path_stat stat;
-            stat.creation = stat.last_access = stat.last_modification = time(nullptr);
-            stat.size = 0;
-            addedStream.stat = stat;
-            _streams.push(static_cast<AddedStream &&>(addedStream));
+            addStream(stream.cast<InStreamBase>(), archivePath, 0);
         } else {
             throw Exception(plzma_error_code_invalid_arguments, "Can't add empty stream.", __FILE__, __LINE__);
         }
     }
     
+    void EncoderImpl::addPushItem(const Path & archivePath) {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        Exception exception(plzma_error_code_invalid_arguments, "Can't add push item.", __FILE__, __LINE__);
+        exception.setReason("The thread-safe functionality disabled.", nullptr);
+        throw exception;
+#else
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_archive || _opening || _result == E_ABORT) {
+            return;
+        }
+        if (archivePath.count() == 0) {
+            throw Exception(plzma_error_code_invalid_arguments, "Can't add push item without archive path.", __FILE__, __LINE__);
+        }
+        if (!_pushBuffers) {
+            _pushBuffers = CMyComPtr<InPushStreamBuffers>(new InPushStreamBuffers());
+        }
+        const plzma_size_t index = _pushBuffers->add(archivePath);
+        addStream(SharedPtr<InStreamBase>(new InPushStream(_pushBuffers, index)), archivePath, kInPushStreamSizeHint);
+#endif
+    }
+    
+    bool EncoderImpl::beginItem(const Path & archivePath) {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        return false;
+#else
+        CMyComPtr<InPushStreamBuffers> buffers;
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (_result == E_ABORT) {
+                return false;
+            }
+            buffers = _pushBuffers;
+        }
+        if (buffers) {
+            return buffers->begin(archivePath);
+        }
+        throw Exception(plzma_error_code_invalid_arguments, "Can't begin item without added push items.", __FILE__, __LINE__);
+#endif
+    }
+    
+    bool EncoderImpl::write(const void * LIBPLZMA_NONNULL data, const size_t size) {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        return false;
+#else
+        CMyComPtr<InPushStreamBuffers> buffers;
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (_result == E_ABORT) {
+                return false;
+            }
+            buffers = _pushBuffers;
+        }
+        if (buffers) {
+            return buffers->write(data, size); // blocking, without own lock
+        }
+        throw Exception(plzma_error_code_invalid_arguments, "Can't write without added push items.", __FILE__, __LINE__);
+#endif
+    }
+    
+    bool EncoderImpl::endItem() {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        return false;
+#else
+        CMyComPtr<InPushStreamBuffers> buffers;
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (_result == E_ABORT) {
+                return false;
+            }
+            buffers = _pushBuffers;
+        }
+        if (buffers) {
+            return buffers->end();
+        }
+        throw Exception(plzma_error_code_invalid_arguments, "Can't end item without added push items.", __FILE__, __LINE__);
+#endif
+    }
+    
     uint64_t EncoderImpl::processAddedPaths() {
         uint64_t itemsCount = 0;
         for (plzma_size_t i = 0, n = _paths.count(); i < n; i++) {
             AddedPath addedPath(static_cast<AddedPath &&>(_paths.at(i))); // move -> no longer needed
             Path rootArchivePath = addedPath.archivePath.count() > 0 ? addedPath.archivePath : static_cast<Path &&>(addedPath.path.lastComponent());
             if (addedPath.isDir) {
-                auto it = addedPath.path.openDir(addedPath.openDirMode);
                 AddedSubDir subDir;
+#if defined(LIBPLZMA_POSIX)
+                DirScanner scanner(addedPath.path, addedPath.openDirMode);
+                scanner.scan();
+                auto files = scanner.takeFiles();
+                subDir.files.reserve(files.count());
+                for (plzma_size_t j = 0, m = files.count(); j < m; j++) { // sub-file -> root + scanned path
+                    auto & file = files.at(j);
+                    AddedFile & item = subDir.files.emplace();
+                    item.archivePath = rootArchivePath;
+                    item.archivePath.append(file.path);
+                    item.path = static_cast<Path &&>(file.path);
+                    item.stat = file.stat;
+                }
+                itemsCount += files.count();
+#else
+                auto it = addedPath.path.openDir(addedPath.openDirMode);
                 while (it->next()) {
                     if (!it->isDir()) { // sub-file -> root + iterator path
                         AddedFile item;
@@ -358,6 +519,7 @@ namespace plzma {
                         itemsCount++;
                     }
                 }
+#endif
                 if (subDir.files.count() > 0) {
                     subDir.path = static_cast<Path &&>(addedPath.path);
                     _subDirs.push(static_cast<AddedSubDir &&>(subDir));
@@ -375,66 +537,121 @@ namespace plzma {
         return itemsCount;
     }
     
+    void EncoderImpl::buildSources() {
+        _sources.clear();
+        _sources.reserve(_itemsCount);
+        SourceEntry entry;
+        entry.type = SourceTypeSubDirFile;
+        for (plzma_size_t i = 0, n = _subDirs.count(); i < n; i++) {
+            entry.subDirIndex = i;
+            for (plzma_size_t j = 0, m = _subDirs.at(i).files.count(); j < m; j++) {
+                entry.index = j;
+                _sources.push(entry);
+            }
+        }
+        entry.subDirIndex = 0;
+        entry.type = SourceTypeFile;
+        for (plzma_size_t i = 0, n = _files.count(); i < n; i++) {
+            entry.index = i;
+            _sources.push(entry);
+        }
+        entry.type = SourceTypeStream;
+        for (plzma_size_t i = 0, n = _streams.count(); i < n; i++) {
+            entry.index = i;
+            _sources.push(entry);
+        }
+    }
+    
     HRESULT EncoderImpl::setupSource(UInt32 index) {
         if (_source.itemIndex == index) {
             return S_OK;
         }
         _source.close();
         _source.itemIndex = index;
-        
-        for (plzma_size_t i = 0, n = _subDirs.count(); i < n; i++) {
-            const auto & subDir = _subDirs.at(i);
-            const UInt32 count = subDir.files.count();
-            if (index < count) {
-                const auto & file = subDir.files.at(index);
-                _source.archivePath = file.archivePath;
-                Path fullPath = subDir.path;
-                fullPath.append(file.path);
-                _source.path = static_cast<Path &&>(fullPath);
-                _source.stat = file.stat;
-                return S_OK;
-            }
-            index -= count;
-        }
-        
-        UInt32 count = _files.count();
-        if (index < count) {
-            const auto & file = _files.at(index);
-            _source.path = file.path;
-            _source.archivePath = file.archivePath;
-            _source.stat = file.stat;
-            return S_OK;
+        if (index >= _sources.count()) {
+            return E_FAIL;
         }
-        index -= count;
         
-        count = _streams.count();
-        if (index < count) {
-            auto & stream = _streams.at(index);
-            HRESULT res = S_OK;
-            _source.stream = stream.stream;
-            _source.archivePath = stream.archivePath;
-            if (stream.stat.size == 0) {
-                stream.stream->open();
-                UInt64 pos = 0;
-                res = stream.stream->Seek(0, SZ_SEEK_END, &pos);
-                stream.stream->close();
-                if (res != S_OK) {
-                    return res;
+        const SourceEntry & entry = _sources.at(index);
+        switch (entry.type) {
+            case SourceTypeSubDirFile: {
+                const auto & subDir = _subDirs.at(entry.subDirIndex);
+                const auto & file = subDir.files.at(entry.index);
+                _source.dirPath = &subDir.path;
+                _source.path = &file.path;
+                _source.archivePath = &file.archivePath;
+                _source.stat = &file.stat;
+            } break;
+                
+            case SourceTypeFile: {
+                const auto & file = _files.at(entry.index);
+                _source.path = &file.path;
+                _source.archivePath = &file.archivePath;
+                _source.stat = &file.stat;
+            } break;
+                
+            case SourceTypeStream: {
+                auto & stream = _streams.at(entry.index);
+                if (stream.stat.size == 0) {
+                    stream.stream->open();
+                    UInt64 pos = 0;
+                    const HRESULT res = stream.stream->Seek(0, SZ_SEEK_END, &pos);
+                    stream.stream->close();
+                    if (res != S_OK) {
+                        return res;
+                    }
+                    stream.stat.size = pos;
                 }
-                stream.stat.size = pos;
-            }
-            _source.stat = stream.stat;
-            return S_OK;
+                _source.stream = stream.stream;
+                _source.archivePath = &stream.archivePath;
+                _source.stat = &stream.stat;
+            } break;
+                
+            default:
+                return E_FAIL;
         }
-        
-        return E_FAIL;
+        return S_OK;
     }
 
+    NWindows::NCOM::CPropVariant EncoderImpl::numberOfThreadsProperty() const {
+        // 'true' keeps the handler's default, i.e. the number of hardware threads.
+        // Ignored by the handlers in a single-threaded build.
+        return (_numberOfThreads > 0) ? NWindows::NCOM::CPropVariant(static_cast<UInt32>(_numberOfThreads)) : NWindows::NCOM::CPropVariant(true);
+    }
+    
+    NWindows::NCOM::CPropVariant EncoderImpl::blockSizeProperty() const {
+        // The size string with the bytes suffix, otherwise the small values are parsed as the power of two.
+        wchar_t size[32];
+        wchar_t * end = ConvertUInt64ToString(_blockSize, size);
+        end[0] = L'b';
+        end[1] = 0;
+        return NWindows::NCOM::CPropVariant(size);
+    }
+    
+    NWindows::NCOM::CPropVariant EncoderImpl::solidProperty() const {
+        if (!(_options & OptionSolid) || (_solidBlockSize == 0 && _solidBlockFileCount == 0)) {
+            return NWindows::NCOM::CPropVariant((_options & OptionSolid) ? true : false);
+        }
+        // The limits string, i.e. '<N>f<M>b', the size with the bytes suffix.
+        wchar_t limits[64];
+        wchar_t * end = limits;
+        if (_solidBlockFileCount > 0) {
+            end = ConvertUInt32ToString(_solidBlockFileCount, end);
+            *end++ = L'f';
+        }
+        if (_solidBlockSize > 0) {
+            end = ConvertUInt64ToString(_solidBlockSize, end);
+            *end++ = L'b';
+        }
+        *end = 0;
+        return NWindows::NCOM::CPropVariant(limits);
+    }
+    
     void EncoderImpl::applySettings7z(ISetProperties * properties) {
         using namespace NWindows::NCOM;
         
-        static const UInt32 settingsCount = 9;
-        static const wchar_t * names[settingsCount] = {
+        static const UInt32 settingsCount = 13;
+        const wchar_t * names[settingsCount] = {
             L"0",   // method
             L"s",   // solid
             L"x",   // compression level
@@ -443,8 +660,12 @@ namespace plzma {
             L"tc",  // write creation time
             L"ta",  // write access time
             L"tm",  // write modification time
+            L"mt",  // number of threads
             
-            L"hcf"  // compress header full, true - add, false - don't add/ignore
+            L"hcf", // compress header full, true - add, false - don't add/ignore
+            L"0c",  // LZMA2 block size
+            L"qs",  // sort items by type
+            L"yx"   // analysis level
         };
         
 #if defined(LIBPLZMA_NO_CRYPTO)
@@ -463,16 +684,38 @@ namespace plzma {
         CPropVariant values[settingsCount] = {
             CPropVariant(static_cast<UInt32>(0)),                           // method dummy value
             
-            CPropVariant((_options & OptionSolid) ? true : false),          // solid mode ON
+            solidProperty(),                                                // solid mode ON or the solid block limits
             CPropVariant(static_cast<UInt32>(_compressionLevel)),           // compression level = 9 - ultra
             CPropVariant((_options & OptionCompressHeader) ? true : false), // compress header
             CPropVariant((_options & OptionEncryptHeader) ? true : false),  // encrypt header
             CPropVariant((_options & OptionStoreCTime) ? true : false),     // write creation time
             CPropVariant((_options & OptionStoreATime) ? true : false),     // write access time
             CPropVariant((_options & OptionStoreMTime) ? true : false),     // write modification time
+            numberOfThreadsProperty(),                                      // number of threads
             
-            CPropVariant(true)                                              // compress header full, true - add, false - don't add/ignore
+            CPropVariant(true),                                             // compress header full, true - add, false - don't add/ignore
+            blockSizeProperty(),                                            // LZMA2 block size
+            CPropVariant(true),                                             // sort items by type
+            CPropVariant(static_cast<UInt32>(9))                            // analysis level, read the beginning of each file
+        };
+        
+        // the optional settings are moved to the end of the used ones
+        UInt32 count = settingsCount - 4;
+        const bool optional[4] = {
+            (_options & OptionCompressHeaderFull) ? true : false,
+            (_blockSize > 0 && _method == plzma_method_LZMA2),
+            (_options & OptionSmartSolid) ? true : false,
+            (_options & OptionSmartSolid) ? true : false
         };
+        for (UInt32 i = settingsCount - 4; i < settingsCount; i++) {
+            if (optional[i - (settingsCount - 4)]) {
+                if (count < i) {
+                    names[count] = names[i];
+                    values[count] = values[i];
+                }
+                count++;
+            }
+        }
         
         switch (_method) {
             case plzma_method_LZMA:     values[0] = L"LZMA";  break;
@@ -482,9 +725,7 @@ namespace plzma {
             default: break;
         }
         
-        const HRESULT res = properties->SetProperties(names,
-                                                      values,
-                                                      (_options & OptionCompressHeaderFull) ? settingsCount : (settingsCount - 1));
+        const HRESULT res = properties->SetProperties(names, values, count);
         if (res != S_OK) {
             throw Exception(plzma_error_code_internal, "Can't apply 7z archive properties.", __FILE__, __LINE__);
         }
@@ -493,17 +734,20 @@ namespace plzma {
     void EncoderImpl::applySettingsXz(ISetProperties * properties) {
         using namespace NWindows::NCOM;
         
-        static const UInt32 settingsCount = 3;
+        static const UInt32 settingsCount = 4;
         static const wchar_t * names[settingsCount] = {
             L"0",   // method
-            L"s",   // solid
-            L"x"    // compression level
+            L"s",   // solid or block size
+            L"x",   // compression level
+            L"mt"   // number of threads
         };
         
         CPropVariant values[settingsCount] = {
             CPropVariant(L"LZMA2"),                                         // method
-            CPropVariant((_options & OptionSolid) ? true : false),          // solid mode ON
+            (_blockSize > 0) ? blockSizeProperty() :                        // block size or
+                CPropVariant((_options & OptionSolid) ? true : false),      // solid mode ON
             CPropVariant(static_cast<UInt32>(_compressionLevel)),           // compression level = 9 - ultra
+            numberOfThreadsProperty()                                       // number of threads
         };
         
         const HRESULT res = properties->SetProperties(names, values, settingsCount);
@@ -587,6 +831,7 @@ namespace plzma {
         }
         
         _itemsCount = static_cast<UInt32>(itemsCount);
+        buildSources();
         _stream->open();
         _archive = OpenCallback::createArchive<IOutArchive>(_type);
         
@@ -603,7 +848,7 @@ namespace plzma {
         }
         
         CMyComPtr<EncoderImpl> selfPtr(this);
-        _source.itemIndex = 1;
+        _source.itemIndex = UINT32_MAX;
         HRESULT result = setupSource(0);
         if (result != S_OK) {
             return false;
@@ -621,6 +866,24 @@ namespace plzma {
         _compressing = false;
         _stream->close();
         _source.close();
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        if (_pushBuffers) {
+            _pushBuffers->finish();
+        }
+#endif
+        
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        if (_pushException) {
+            Exception * exception = _pushException;
+            _pushException = nullptr;
+            if (_result != E_ABORT) { // the producer failed and finished the pushed items
+                Exception localException(static_cast<Exception &&>(*exception));
+                delete exception;
+                throw localException;
+            }
+            delete exception;
+        }
+#endif
         
         if (result != S_OK || _result != S_OK) {
             if (result == E_ABORT || _result == E_ABORT) {
@@ -646,6 +909,11 @@ namespace plzma {
     void EncoderImpl::abort() {
         LIBPLZMA_LOCKGUARD(lock, _mutex)
         _result = E_ABORT;
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        if (_pushBuffers) {
+            _pushBuffers->finish();
+        }
+#endif
         if (!_compressing) {
             _stream->close();
             _source.close();
@@ -668,6 +936,8 @@ namespace plzma {
     
     bool EncoderImpl::shouldCreateSolidArchive() const { return hasOption(OptionSolid); }
     void EncoderImpl::setShouldCreateSolidArchive(const bool solid) { setOption(OptionSolid, solid); }
+    bool EncoderImpl::shouldUseSmartSolid() const { return hasOption(OptionSmartSolid); }
+    void EncoderImpl::setShouldUseSmartSolid(const bool smart) { setOption(OptionSmartSolid, smart); }
     bool EncoderImpl::shouldCompressHeader() const { return hasOption(OptionCompressHeader); }
     void EncoderImpl::setShouldCompressHeader(const bool compress) { setOption(OptionCompressHeader, compress); }
     bool EncoderImpl::shouldCompressHeaderFull() const { return hasOption(OptionCompressHeaderFull); }
@@ -693,6 +963,46 @@ namespace plzma {
         _compressionLevel = level > 9 ? 9 : level;
     }
     
+    uint32_t EncoderImpl::numberOfThreads() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _numberOfThreads;
+    }
+    
+    void EncoderImpl::setNumberOfThreads(const uint32_t threads) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _numberOfThreads = threads;
+    }
+    
+    uint64_t EncoderImpl::blockSize() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _blockSize;
+    }
+    
+    void EncoderImpl::setBlockSize(const uint64_t size) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _blockSize = size;
+    }
+    
+    uint64_t EncoderImpl::solidBlockSize() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _solidBlockSize;
+    }
+    
+    void EncoderImpl::setSolidBlockSize(const uint64_t size) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _solidBlockSize = size;
+    }
+    
+    uint32_t EncoderImpl::solidBlockFileCount() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _solidBlockFileCount;
+    }
+    
+    void EncoderImpl::setSolidBlockFileCount(const uint32_t count) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _solidBlockFileCount = count;
+    }
+    
 #if !defined(LIBPLZMA_NO_C_BINDINGS)
     void EncoderImpl::setUtf8Callback(plzma_progress_delegate_utf8_callback LIBPLZMA_NULLABLE callback) {
 #if !defined(LIBPLZMA_NO_PROGRESS)
@@ -703,6 +1013,28 @@ namespace plzma {
     void EncoderImpl::setWideCallback(plzma_progress_delegate_wide_callback LIBPLZMA_NULLABLE callback) {
 #if !defined(LIBPLZMA_NO_PROGRESS)
         _progress->setWideCallback(callback);
+#endif
+    }
+    
+    void EncoderImpl::setPushException(Exception * LIBPLZMA_NULLABLE exception) noexcept {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        delete exception;
+#else
+        CMyComPtr<InPushStreamBuffers> buffers;
+        try {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (_pushException) {
+                delete exception;
+            } else {
+                _pushException = exception;
+            }
+            buffers = _pushBuffers;
+        } catch (...) {
+            delete exception;
+        }
+        if (buffers) {
+            buffers->finish();
+        }
 #endif
     }
 #endif
@@ -726,6 +1058,9 @@ namespace plzma {
     EncoderImpl::~EncoderImpl() {
         _stream->close();
         _source.close();
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        delete _pushException;
+#endif
     }
     
     SharedPtr<Encoder> makeSharedEncoder(const SharedPtr<OutStream> & stream,
@@ -760,6 +1095,28 @@ namespace plzma {
 
 using namespace plzma;
 
+#if defined(LIBPLZMA_HAVE_STD)
+#define LIBPLZMA_C_BINDINGS_ENCODER_PUSH_CATCH(OBJ_PTR) \
+} catch (const Exception & exception) { \
+    static_cast<EncoderImpl *>(OBJ_PTR->object)->setPushException(exception.moveToHeapCopy()); \
+} catch (const std::exception & exception) { \
+    static_cast<EncoderImpl *>(OBJ_PTR->object)->setPushException(Exception::create(plzma_error_code_internal, exception.what(), __FILE__, __LINE__)); \
+} catch (...) { \
+    static_cast<EncoderImpl *>(OBJ_PTR->object)->setPushException(Exception::create(plzma_error_code_unknown, nullptr, __FILE__, __LINE__)); \
+} \
+return false; \
+
+#else
+#define LIBPLZMA_C_BINDINGS_ENCODER_PUSH_CATCH(OBJ_PTR) \
+} catch (const Exception & exception) { \
+    static_cast<EncoderImpl *>(OBJ_PTR->object)->setPushException(exception.moveToHeapCopy()); \
+} catch (...) { \
+    static_cast<EncoderImpl *>(OBJ_PTR->object)->setPushException(Exception::create(plzma_error_code_unknown, nullptr, __FILE__, __LINE__)); \
+} \
+return false; \
+
+#endif // LIBPLZMA_HAVE_STD
+
 plzma_encoder plzma_encoder_create(plzma_out_stream * LIBPLZMA_NONNULL stream,
                                    const plzma_file_type type,
                                    const plzma_method method,
@@ -831,6 +1188,18 @@ void plzma_encoder_set_should_create_solid_archive(plzma_encoder * LIBPLZMA_NONN
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
 }
 
+bool plzma_encoder_should_use_smart_solid(plzma_encoder * LIBPLZMA_NONNULL encoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(encoder, false)
+    return static_cast<EncoderImpl *>(encoder->object)->shouldUseSmartSolid();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(encoder, false)
+}
+
+void plzma_encoder_set_should_use_smart_solid(plzma_encoder * LIBPLZMA_NONNULL encoder, const bool smart) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(encoder)
+    static_cast<EncoderImpl *>(encoder->object)->setShouldUseSmartSolid(smart);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
+}
+
 uint8_t plzma_encoder_compression_level(plzma_encoder * LIBPLZMA_NONNULL encoder) {
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(encoder, 0)
     return static_cast<EncoderImpl *>(encoder->object)->compressionLevel();
@@ -843,6 +1212,54 @@ void plzma_encoder_set_compression_level(plzma_encoder * LIBPLZMA_NONNULL encode
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
 }
 
+uint32_t plzma_encoder_number_of_threads(plzma_encoder * LIBPLZMA_NONNULL encoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(encoder, 0)
+    return static_cast<EncoderImpl *>(encoder->object)->numberOfThreads();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(encoder, 0)
+}
+
+void plzma_encoder_set_number_of_threads(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint32_t threads) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(encoder)
+    static_cast<EncoderImpl *>(encoder->object)->setNumberOfThreads(threads);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
+}
+
+uint64_t plzma_encoder_block_size(plzma_encoder * LIBPLZMA_NONNULL encoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(encoder, 0)
+    return static_cast<EncoderImpl *>(encoder->object)->blockSize();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(encoder, 0)
+}
+
+void plzma_encoder_set_block_size(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint64_t size) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(encoder)
+    static_cast<EncoderImpl *>(encoder->object)->setBlockSize(size);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
+}
+
+uint64_t plzma_encoder_solid_block_size(plzma_encoder * LIBPLZMA_NONNULL encoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(encoder, 0)
+    return static_cast<EncoderImpl *>(encoder->object)->solidBlockSize();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(encoder, 0)
+}
+
+void plzma_encoder_set_solid_block_size(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint64_t size) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(encoder)
+    static_cast<EncoderImpl *>(encoder->object)->setSolidBlockSize(size);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
+}
+
+uint32_t plzma_encoder_solid_block_file_count(plzma_encoder * LIBPLZMA_NONNULL encoder) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(encoder, 0)
+    return static_cast<EncoderImpl *>(encoder->object)->solidBlockFileCount();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(encoder, 0)
+}
+
+void plzma_encoder_set_solid_block_file_count(plzma_encoder * LIBPLZMA_NONNULL encoder, const uint32_t count) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(encoder)
+    static_cast<EncoderImpl *>(encoder->object)->setSolidBlockFileCount(count);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
+}
+
 bool plzma_encoder_should_compress_header(plzma_encoder * LIBPLZMA_NONNULL encoder) {
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(encoder, false)
     return static_cast<EncoderImpl *>(encoder->object)->shouldCompressHeader();
@@ -953,6 +1370,35 @@ void plzma_encoder_add_stream(plzma_encoder * LIBPLZMA_NONNULL encoder,
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
 }
 
+void plzma_encoder_add_push_item(plzma_encoder * LIBPLZMA_NONNULL encoder,
+                                 const plzma_path * LIBPLZMA_NONNULL archive_path) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_WITH_ARG1(encoder, archive_path)
+    static_cast<EncoderImpl *>(encoder->object)->addPushItem(*static_cast<const Path *>(archive_path->object));
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(encoder)
+}
+
+bool plzma_encoder_begin_item(plzma_encoder * LIBPLZMA_NONNULL encoder,
+                              const plzma_path * LIBPLZMA_NONNULL archive_path) {
+    if (archive_path->exception) return false; // the exception of the encoder object belongs to the 'compress' thread
+    try {
+        return static_cast<EncoderImpl *>(encoder->object)->beginItem(*static_cast<const Path *>(archive_path->object));
+    LIBPLZMA_C_BINDINGS_ENCODER_PUSH_CATCH(encoder)
+}
+
+bool plzma_encoder_write(plzma_encoder * LIBPLZMA_NONNULL encoder,
+                         const void * LIBPLZMA_NONNULL data,
+                         const size_t size) {
+    try {
+        return static_cast<EncoderImpl *>(encoder->object)->write(data, size);
+    LIBPLZMA_C_BINDINGS_ENCODER_PUSH_CATCH(encoder)
+}
+
+bool plzma_encoder_end_item(plzma_encoder * LIBPLZMA_NONNULL encoder) {
+    try {
+        return static_cast<EncoderImpl *>(encoder->object)->endItem();
+    LIBPLZMA_C_BINDINGS_ENCODER_PUSH_CATCH(encoder)
+}
+
 bool plzma_encoder_open(plzma_encoder * LIBPLZMA_NONNULL encoder) {
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(encoder, false)
     return static_cast<EncoderImpl *>(encoder->object)->open();
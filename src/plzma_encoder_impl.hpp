@@ -33,6 +33,7 @@
 #include "../libplzma.hpp"
 #include "plzma_private.hpp"
 #include "plzma_in_streams.hpp"
+#include "plzma_in_push_stream.hpp"
 #include "plzma_out_streams.hpp"
 #include "plzma_open_callback.hpp"
 #include "plzma_extract_callback.hpp"
@@ -52,6 +53,7 @@ namespace plzma {
     
     class EncoderImpl final :
         public IArchiveUpdateCallback2,
+        public IArchiveUpdateCallbackFile,
         public ICryptoGetTextPassword,
         public ICryptoGetTextPassword2,
         public Encoder,
@@ -68,6 +70,7 @@ namespace plzma {
             OptionStoreCTime            = 1 << 5,
             OptionStoreMTime            = 1 << 6,
             OptionStoreATime            = 1 << 7,
+            OptionSmartSolid            = 1 << 8,
             
             OptionRequirePassword       = OptionEncryptContent | OptionEncryptHeader
         };
@@ -91,30 +94,50 @@ namespace plzma {
             Path archivePath;
             plzma_path_stat stat;
         };
+        enum SourceType : uint8_t {
+            SourceTypeSubDirFile    = 0,
+            SourceTypeFile          = 1,
+            SourceTypeStream        = 2
+        };
+        struct SourceEntry final { // the location of the item source, index-addressed by the item index
+            UInt32 subDirIndex;
+            UInt32 index;          // the index of the file of the sub-dir, of the file or of the stream
+            SourceType type;
+        };
         CMyComPtr<OutStreamBase> _stream;
         CMyComPtr<IOutArchive> _archive;
         Vector<AddedPath> _paths;
         Vector<AddedSubDir> _subDirs;
         Vector<AddedFile> _files;
         Vector<AddedStream> _streams;
-        struct Source final {
-            Path path;
-            Path archivePath;
+        Vector<SourceEntry> _sources;
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        CMyComPtr<InPushStreamBuffers> _pushBuffers;
+        Exception * _pushException = nullptr; // the failure of the producer, thrown by the 'compress'
+#endif
+        struct Source final { // refers to the added paths, without copying
+            const Path * dirPath = nullptr; // the directory of the sub-dir file
+            const Path * path = nullptr;    // the path of the file, relative to the 'dirPath' if exists
+            const Path * archivePath = nullptr;
+            const plzma_path_stat * stat = nullptr;
             SharedPtr<InStreamBase> stream;
-            plzma_path_stat stat;
-            UInt32 itemIndex;
+            UInt32 itemIndex = UINT32_MAX;
             void close() {
                 if (stream) {
                     stream->close();
                     stream.clear();
                 }
-                path.clear(plzma_erase_zero);
-                archivePath.clear(plzma_erase_zero);
+                dirPath = path = archivePath = nullptr;
+                stat = nullptr;
             }
         } _source;
         plzma_file_type _type = plzma_file_type_7z;
         plzma_method _method = plzma_method_LZMA;
         UInt32 _itemsCount = 0;
+        uint64_t _blockSize = 0;
+        uint64_t _solidBlockSize = 0;
+        uint32_t _solidBlockFileCount = 0;
+        uint32_t _numberOfThreads = 0;
         uint16_t _options = 0;
         uint8_t _compressionLevel = 7;
         bool _opening = false;
@@ -122,8 +145,13 @@ namespace plzma {
         
         virtual void retain();
         virtual void release();
+        void addStream(const SharedPtr<InStreamBase> & stream, const Path & archivePath, const uint64_t size);
         uint64_t processAddedPaths();
+        void buildSources();
         HRESULT setupSource(UInt32 index);
+        NWindows::NCOM::CPropVariant numberOfThreadsProperty() const;
+        NWindows::NCOM::CPropVariant blockSizeProperty() const;
+        NWindows::NCOM::CPropVariant solidProperty() const;
         void applySettings7z(ISetProperties * properties);
         void applySettingsXz(ISetProperties * properties);
         void applySettingsTar(ISetProperties * properties);
@@ -134,7 +162,14 @@ namespace plzma {
         LIBPLZMA_NON_COPYABLE_NON_MOVABLE(EncoderImpl)
         
     public:
-        MY_UNKNOWN_IMP3(IArchiveUpdateCallback2, ICryptoGetTextPassword, ICryptoGetTextPassword2)
+        MY_QUERYINTERFACE_BEGIN2(IArchiveUpdateCallback2)
+        MY_QUERYINTERFACE_ENTRY(ICryptoGetTextPassword)
+        MY_QUERYINTERFACE_ENTRY(ICryptoGetTextPassword2)
+        else if (iid == IID_IArchiveUpdateCallbackFile && (_options & OptionSmartSolid)) { // the handler analyzes the content only via this interface
+            *outObject = static_cast<void *>(static_cast<IArchiveUpdateCallbackFile *>(this));
+        }
+        MY_QUERYINTERFACE_END
+        MY_ADDREF_RELEASE
         
         // IProgress
         STDMETHOD(SetTotal)(UInt64 size);
@@ -148,6 +183,10 @@ namespace plzma {
         STDMETHOD(GetVolumeSize)(UInt32 index, UInt64 * size);
         STDMETHOD(GetVolumeStream)(UInt32 index, ISequentialOutStream ** volumeStream);
         
+        // IArchiveUpdateCallbackFile
+        STDMETHOD(GetStream2)(UInt32 index, ISequentialInStream ** inStream, UInt32 notifyOp);
+        STDMETHOD(ReportOperation)(UInt32 indexType, UInt32 index, UInt32 notifyOp);
+        
         // ICryptoGetTextPassword
         STDMETHOD(CryptoGetTextPassword)(BSTR * password);
         
@@ -159,13 +198,29 @@ namespace plzma {
         virtual void setProgressDelegate(ProgressDelegate * delegate);
         virtual void add(const Path & path, const plzma_open_dir_mode_t openDirMode = 0, const Path & archivePath = Path());
         virtual void add(const SharedPtr<InStream> & stream, const Path & archivePath);
+        virtual void addPushItem(const Path & archivePath);
+        virtual bool beginItem(const Path & archivePath);
+        virtual bool write(const void * LIBPLZMA_NONNULL data, const size_t size);
+        virtual bool endItem();
+
+        
         virtual bool open();
         virtual void abort();
         virtual bool compress();
         virtual bool shouldCreateSolidArchive() const;
         virtual void setShouldCreateSolidArchive(const bool solid);
+        virtual bool shouldUseSmartSolid() const;
+        virtual void setShouldUseSmartSolid(const bool smart);
         virtual uint8_t compressionLevel() const;
         virtual void setCompressionLevel(const uint8_t level);
+        virtual uint32_t numberOfThreads() const;
+        virtual void setNumberOfThreads(const uint32_t threads);
+        virtual uint64_t blockSize() const;
+        virtual void setBlockSize(const uint64_t size);
+        virtual uint64_t solidBlockSize() const;
+        virtual void setSolidBlockSize(const uint64_t size);
+        virtual uint32_t solidBlockFileCount() const;
+        virtual void setSolidBlockFileCount(const uint32_t count);
         virtual bool shouldCompressHeader() const;
         virtual void setShouldCompressHeader(const bool compress);
         virtual bool shouldCompressHeaderFull() const;
@@ -184,6 +239,12 @@ namespace plzma {
 #if !defined(LIBPLZMA_NO_C_BINDINGS)
         void setUtf8Callback(plzma_progress_delegate_utf8_callback callback);
         void setWideCallback(plzma_progress_delegate_wide_callback callback);
+        
+        /// @brief Stores the failure of the producer of the push items and stops the reading of the pushed content.
+        ///
+        /// The producer's thread can't use the exception of the encoder object, it belongs to the thread of the 'compress'.
+        /// The first stored exception is thrown by the 'compress', the others are released.
+        void setPushException(Exception * LIBPLZMA_NULLABLE exception) noexcept;
 #endif
         
         EncoderImpl(const CMyComPtr<OutStreamBase> & stream,
@@ -33,7 +33,9 @@
 
 #include "CPP/Common/Defs.h"
 #include "CPP/Windows/PropVariant.h"
+#include "CPP/Windows/System.h"
 #include "CPP/7zip/Archive/Common/DummyOutStream.h"
+#include "CPP/7zip/Common/StreamUtils.h"
 
 namespace plzma {
     
@@ -63,7 +65,7 @@ namespace plzma {
 #if defined(LIBPLZMA_NO_PROGRESS)
         return S_OK;
 #else
-        return setProgressTotal(size);
+        return _parent ? setWorkerProgress(&size, nullptr) : setProgressTotal(size);
 #endif
     }
     
@@ -71,10 +73,74 @@ namespace plzma {
 #if defined(LIBPLZMA_NO_PROGRESS)
         return S_OK;
 #else
-        return completeValue ? setProgressCompleted(*completeValue) : S_OK;
+        if (completeValue) {
+            return _parent ? setWorkerProgress(nullptr, completeValue) : setProgressCompleted(*completeValue);
+        }
+        return S_OK;
 #endif
     }
     
+#if !defined(LIBPLZMA_NO_PROGRESS)
+    HRESULT ExtractCallback::setWorkerProgress(const UInt64 * total, const UInt64 * completed) noexcept {
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (_result != S_OK) {
+                return _result;
+            }
+        }
+        // without own lock, the parent locks the workers during abort
+        return _parent->updateWorkerProgress(_worker, total, completed);
+    }
+    
+    HRESULT ExtractCallback::updateWorkerProgress(Worker * worker, const UInt64 * total, const UInt64 * completed) noexcept {
+        try {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (_result != S_OK) {
+                return _result;
+            }
+            if (total) {
+                worker->partTotal = *total;
+            }
+            if (completed) {
+                worker->partCompleted = *completed;
+            }
+            double unpacked = 0.0;
+            for (unsigned i = 0; i < _workers.Size(); i++) {
+                const Worker & w = _workers[i];
+                if (w.partNumber > 0) {
+                    double parts = w.partNumber - 1;
+                    if (w.partTotal > 0) {
+                        parts += MyMin<double>(static_cast<double>(w.partCompleted) / static_cast<double>(w.partTotal), 1.0);
+                    }
+                    unpacked += (static_cast<double>(w.size) * parts) / static_cast<double>(w.partsCount);
+                }
+            }
+            _progress->setCompleted(static_cast<uint64_t>(unpacked));
+            return S_OK;
+        } catch (const Exception & exception) {
+            if (!worker->exception) {
+                worker->exception = exception.moveToHeapCopy();
+            }
+            return E_FAIL;
+        }
+#if defined(LIBPLZMA_HAVE_STD)
+        catch (const std::exception & exception) {
+            if (!worker->exception) {
+                worker->exception = Exception::create(plzma_error_code_internal, exception.what(), __FILE__, __LINE__);
+            }
+            return E_FAIL;
+        }
+#endif
+        catch (...) {
+            if (!worker->exception) {
+                worker->exception = Exception::create(plzma_error_code_internal, "Can't set progress completed.", __FILE__, __LINE__);
+            }
+            return E_FAIL;
+        }
+        return S_OK;
+    }
+#endif // !LIBPLZMA_NO_PROGRESS
+    
     STDMETHODIMP ExtractCallback::CryptoGetTextPassword(BSTR * password) {
         _passwordRequested = true;
         return getTextPassword(nullptr, password);
@@ -294,71 +360,62 @@ namespace plzma {
         return S_OK;
     }
     
-    void ExtractCallback::process() {
-        LIBPLZMA_UNIQUE_LOCK(lock, _mutex)
-
-        CMyComPtr<ExtractCallback> selfPtr(this);
-        NWindows::NCOM::CPropVariant prop;
-        if (_archive->GetArchiveProperty(kpidSolid, &prop) != S_OK) {
-            throw Exception(plzma_error_code_internal, "Can't read archive solid property.", __FILE__, __LINE__);
-        }
-        _solidArchive = PROPVARIANTGetBool(prop);
-        
-        UInt32 itemsCount = 0, itemIndex = 0;
-        if (_itemsArray) {
-            _itemsArray->sort();
-            itemsCount = _itemsArray->count();
-        } else if (_itemsMap) {
-            _itemsMap->sort();
-            itemsCount = _itemsMap->count();
-        } else {
-            UInt32 numItems = 0;
-            if (_archive->GetNumberOfItems(&numItems) != S_OK) {
-                throw Exception(plzma_error_code_internal, "Can't get number of archive items.", __FILE__, __LINE__);
-            }
-            itemsCount = numItems;
-        }
-        
-        const UInt32 maxIndicies = 256;
+    void ExtractCallback::startPart() {
 #if !defined(LIBPLZMA_NO_PROGRESS)
-        _progress->reset();
-        UInt32 partsCount = itemsCount / maxIndicies;
-        partsCount = MyMax<UInt32>(1, partsCount);
-        if (itemsCount > partsCount * maxIndicies) {
-            partsCount++;
+        if (_parent) {
+            LIBPLZMA_LOCKGUARD(lock, _parent->_mutex)
+            _worker->partNumber++;
+            _worker->partCompleted = _worker->partTotal = 0;
+        } else {
+            _progress->startPart();
         }
-        _progress->setPartsCount(partsCount);
 #endif
-        
+    }
+    
+    UInt32 ExtractCallback::folderIndex(const UInt32 index) {
+        NWindows::NCOM::CPropVariant prop;
+        if (_archive->GetProperty(index, kpidBlock, &prop) == S_OK && prop.vt == VT_UI4) {
+            return prop.ulVal;
+        }
+        return static_cast<UInt32>(-1);
+    }
+    
+    void ExtractCallback::batchEnds(const CRecordVector<UInt32> & indices, CRecordVector<unsigned> & ends) {
+        const unsigned maxIndicies = 256;
+        const unsigned itemsCount = indices.Size();
+        unsigned from = 0;
+        ends.Clear();
         do {
-            UInt32 indicies[maxIndicies];
-            UInt32 fromIndex = 0, toIndex = 0, indicesCount = 0;
-            if (_itemsArray) {
-                while (indicesCount < maxIndicies && itemIndex < itemsCount) {
-                    indicies[indicesCount] = toIndex = _itemsArray->at(itemIndex)->index();
-                    if (indicesCount == 0) { fromIndex = toIndex; }
-                    itemIndex++; indicesCount++;
-                }
-            } else if (_itemsMap) {
-                while (indicesCount < maxIndicies && itemIndex < itemsCount) {
-                    indicies[indicesCount] = toIndex = _itemsMap->at(itemIndex).first->index();
-                    if (indicesCount == 0) { fromIndex = toIndex; }
-                    itemIndex++; indicesCount++;
-                }
-            } else {
-                fromIndex = itemIndex;
-                while (indicesCount < maxIndicies && itemIndex < itemsCount) {
-                    indicies[indicesCount++] = toIndex = itemIndex++;         // +1
+            unsigned end = MyMin<unsigned>(from + maxIndicies, itemsCount);
+            if (_type == plzma_file_type_7z && end > from && end < itemsCount) {
+                // Don't split the solid block(folder) between the batches,
+                // otherwise the next batch decodes this folder again from the beginning.
+                const UInt32 folder = folderIndex(indices[end - 1]);
+                if (folder != static_cast<UInt32>(-1)) {
+                    while (end < itemsCount && folderIndex(indices[end]) == folder) {
+                        end++;
+                    }
                 }
             }
-            _extractingFirstIndex = fromIndex;
-            _extractingLastIndex = toIndex;
-#if !defined(LIBPLZMA_NO_PROGRESS)
-            _progress->startPart();
-#endif
+            ends.Add(end);
+            from = end;
+        } while (from < itemsCount);
+    }
+    
+    void ExtractCallback::extract(const CRecordVector<UInt32> & indices, const CRecordVector<unsigned> & ends) {
+        unsigned itemIndex = 0;
+        
+        LIBPLZMA_UNIQUE_LOCK(lock, _mutex)
+        for (unsigned batch = 0; batch < ends.Size(); batch++) {
+            const unsigned indicesCount = ends[batch] - itemIndex;
+            const UInt32 * indicies = (indicesCount > 0) ? &indices[itemIndex] : nullptr;
+            _extractingFirstIndex = (indicesCount > 0) ? indicies[0] : 0;
+            _extractingLastIndex = (indicesCount > 0) ? indicies[indicesCount - 1] : 0;
+            itemIndex += indicesCount;
             _extracting = true;
             
             LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
+            startPart();
             const HRESULT result = (indicesCount > 0) ? _archive->Extract(indicies, indicesCount, _mode, this) : S_OK;
             LIBPLZMA_UNIQUE_LOCK_LOCK(lock)
 
@@ -379,10 +436,501 @@ namespace plzma {
                 }
                 throw Exception(plzma_error_code_internal, "Unknown extract error.", __FILE__, __LINE__);
             }
-        } while (itemIndex < itemsCount);
+        }
+    }
+    
+    THREAD_FUNC_DECL ExtractCallback::workerThread(void * param) {
+        Worker * worker = static_cast<Worker *>(param);
+        ExtractCallback * owner = worker->owner;
+        try {
+            CMyComPtr<IInArchive> archive = owner->_archiveProvider->openArchive(worker->stream);
+            if (owner->_type == plzma_file_type_xz) {
+                owner->decodeBlocks(worker, archive);
+            } else if (archive) {
+                CMyComPtr<ExtractCallback> callback(new ExtractCallback(owner, worker, archive));
+                bool canExtract = false;
+                {
+                    LIBPLZMA_LOCKGUARD(lock, owner->_mutex)
+                    if (owner->_result == S_OK && !owner->_workerFailed) {
+                        worker->callback = callback;
+                        canExtract = true;
+                    }
+                }
+                if (canExtract) {
+                    callback->extract(worker->indices, worker->batchEnds);
+                }
+                LIBPLZMA_LOCKGUARD(lock, owner->_mutex)
+                worker->callback.Release();
+            }
+        } catch (const Exception & exception) {
+            if (!worker->exception) {
+                worker->exception = exception.moveToHeapCopy();
+            }
+        }
+#if defined(LIBPLZMA_HAVE_STD)
+        catch (const std::exception & exception) {
+            if (!worker->exception) {
+                worker->exception = Exception::create(plzma_error_code_internal, exception.what(), __FILE__, __LINE__);
+            }
+        }
+#endif
+        catch (...) {
+            if (!worker->exception) {
+                worker->exception = Exception::create(plzma_error_code_unknown, "Unknown extract error.", __FILE__, __LINE__);
+            }
+        }
+        worker->stream->close();
+        if (worker->exception) {
+            owner->abortWorkers();
+        }
+        return 0;
+    }
+    
+    static int compareIndices(const UInt32 * a, const UInt32 * b, void * param) {
+        return MyCompare(*a, *b);
+    }
+    
+    static int compareFolderSizes(const UInt32 * a, const UInt32 * b, void * param) {
+        const UInt64 * sizes = static_cast<const UInt64 *>(param);
+        const UInt64 sa = sizes[*a], sb = sizes[*b];
+        return (sa > sb) ? -1 : ((sa < sb) ? 1 : MyCompare(*a, *b)); // descending by size
+    }
+    
+    UInt64 ExtractCallback::workersMemoryLimit() const {
+        UInt64 memoryLimit = _memoryLimit;
+        if (memoryLimit == 0) {
+            if (!NWindows::NSystem::GetRamSize(memoryLimit)) {
+                memoryLimit = static_cast<UInt64>(sizeof(size_t)) << 28;
+            }
+            memoryLimit /= 2;
+        }
+        return memoryLimit;
+    }
+    
+    bool ExtractCallback::extractParallel(const CRecordVector<UInt32> & indices) {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        return false;
+#else
+        if (_workersCount < 2 || !_archiveProvider) {
+            return false;
+        } else if (_type == plzma_file_type_xz) {
+            return extractBlocksParallel(indices);
+        } else if (_type != plzma_file_type_7z || indices.Size() < 2) {
+            return false;
+        }
+        
+        // Group the indices by the solid blocks(folders). The items of the folder are sequential,
+        // the items without folder(empty files and directories) are stored separately.
+        CRecordVector<UInt32> folderIndices, noFolderIndices, groupStarts, groupFolders;
+        CRecordVector<UInt64> groupSizes;
+        UInt64 noFolderSize = 0, totalSize = 0;
+        UInt32 prevFolder = 0;
+        folderIndices.ClearAndReserve(indices.Size());
+        for (unsigned i = 0; i < indices.Size(); i++) {
+            const UInt32 index = indices[i];
+            NWindows::NCOM::CPropVariant prop;
+            if (_archive->GetProperty(index, kpidSize, &prop) != S_OK) {
+                return false;
+            }
+            const UInt64 size = PROPVARIANTGetUInt64(prop);
+            totalSize += size;
+            prop.Clear();
+            if (_archive->GetProperty(index, kpidBlock, &prop) != S_OK) {
+                return false;
+            }
+            if (prop.vt != VT_UI4) {
+                noFolderIndices.Add(index);
+                noFolderSize += size;
+                continue;
+            }
+            if (folderIndices.IsEmpty() || prop.ulVal != prevFolder) {
+                groupStarts.Add(folderIndices.Size());
+                groupFolders.Add(prop.ulVal);
+                groupSizes.Add(0);
+                prevFolder = prop.ulVal;
+            }
+            folderIndices.AddInReserved(index);
+            groupSizes.Back() += size;
+        }
+        
+        const unsigned groupsCount = groupStarts.Size();
+        if (groupsCount < 2) {
+            return false;
+        }
+        
+        // Each worker opens own archive and decodes own folder, so all workers together must fit the memory limit.
+        UInt64 maxFolderMemory = 0;
+        CMyComPtr<IArchiveFolderMemUsage> foldersMemory;
+        _archive->QueryInterface(IID_IArchiveFolderMemUsage, reinterpret_cast<void**>(&foldersMemory));
+        for (unsigned i = 0; foldersMemory && i < groupsCount; i++) {
+            UInt64 memory = 0;
+            if (foldersMemory->GetFolderMemUsage(groupFolders[i], &memory) != S_OK) {
+                return false;
+            }
+            maxFolderMemory = MyMax<UInt64>(maxFolderMemory, memory);
+        }
+        const UInt64 maxWorkers = (maxFolderMemory > 0) ? (workersMemoryLimit() / maxFolderMemory) : groupsCount;
+        if (maxWorkers < 2) {
+            return false; // the folders don't fit -> serial
+        }
+        
+        // Assign the largest folders first, each to the least loaded worker.
+        CRecordVector<UInt32> order;
+        order.ClearAndReserve(groupsCount);
+        for (unsigned i = 0; i < groupsCount; i++) {
+            order.AddInReserved(i);
+        }
+        order.Sort(compareFolderSizes, &groupSizes[0]);
+        
+        const unsigned workersCount = static_cast<unsigned>(MyMin<UInt64>(MyMin<unsigned>(_workersCount, groupsCount), maxWorkers));
+        _workers.ClearAndReserve(workersCount);
+        for (unsigned i = 0; i < workersCount; i++) {
+            Worker & worker = _workers.AddNew();
+            worker.owner = this;
+        }
+        
+        for (unsigned i = 0; i <= groupsCount; i++) {
+            unsigned minWorker = 0;
+            for (unsigned w = 1; w < workersCount; w++) {
+                if (_workers[w].size < _workers[minWorker].size) {
+                    minWorker = w;
+                }
+            }
+            Worker & worker = _workers[minWorker];
+            if (i == groupsCount) {
+                worker.indices += noFolderIndices;
+                worker.size += noFolderSize;
+                break;
+            }
+            const UInt32 group = order[i];
+            const unsigned from = groupStarts[group];
+            const unsigned to = (group + 1 < groupsCount) ? groupStarts[group + 1] : folderIndices.Size();
+            for (unsigned k = from; k < to; k++) {
+                worker.indices.Add(folderIndices[k]);
+            }
+            worker.size += groupSizes[group];
+        }
+        
+        for (unsigned i = 0; i < workersCount; i++) {
+            Worker & worker = _workers[i];
+            worker.indices.Sort(compareIndices, nullptr);
+            batchEnds(worker.indices, worker.batchEnds);
+            worker.partsCount = worker.batchEnds.Size();
+            worker.stream = _archiveProvider->cloneStream();
+            if (!worker.stream) {
+                _workers.Clear();
+                return false; // not clonable -> serial
+            }
+        }
+        
+#if !defined(LIBPLZMA_NO_PROGRESS)
+        _progress->reset();
+        _progress->setPartsCount(1);
+        _progress->startPart();
+        _progress->setTotal(totalSize);
+#endif
+        
+        LIBPLZMA_UNIQUE_LOCK(lock, _mutex)
+        _extracting = true;
+        LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
+        
+        // The workers which threads can't be created are processed in the current thread.
+        for (unsigned i = 0; i < workersCount; i++) {
+            _workers[i].thread.Create(workerThread, &_workers[i]);
+        }
+        for (unsigned i = 0; i < workersCount; i++) {
+            if (!_workers[i].thread.IsCreated()) {
+                workerThread(&_workers[i]);
+            }
+        }
+        for (unsigned i = 0; i < workersCount; i++) {
+            if (_workers[i].thread.IsCreated()) {
+                _workers[i].thread.Wait_Close();
+            }
+        }
+        
+        LIBPLZMA_UNIQUE_LOCK_LOCK(lock)
+        _extracting = false;
+        if (_result == E_ABORT) {
+            _workers.Clear();
+            return true; // aborted -> without exception
+        }
+        for (unsigned i = 0; i < workersCount; i++) {
+            if (_workers[i].exception) {
+                Exception localException(static_cast<Exception &&>(*_workers[i].exception));
+                _workers.Clear();
+                throw localException;
+            }
+        }
+        _workers.Clear();
+        LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
         
 #if !defined(LIBPLZMA_NO_PROGRESS)
         _progress->finish();
+#endif
+        return true;
+#endif // !LIBPLZMA_THREAD_UNSAFE
+    }
+    
+    void ExtractCallback::decodeBlocks(Worker * worker, const CMyComPtr<IInArchive> & archive) {
+        CMyComPtr<IArchiveIndexedBlocks> blocks;
+        if (archive) {
+            archive->QueryInterface(IID_IArchiveIndexedBlocks, reinterpret_cast<void**>(&blocks));
+        }
+        if (!blocks) {
+            throw Exception(plzma_error_code_internal, "Can't decode the blocks of the archive.", __FILE__, __LINE__);
+        }
+        
+        RawHeapMemory buffer;
+        size_t bufferSize = 0;
+        for (unsigned i = 0; i < worker->indices.Size(); i++) {
+            {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (_result != S_OK || _workerFailed) {
+                    return;
+                }
+            }
+            const UInt32 blockIndex = worker->indices[i];
+            UInt64 unpackPos = 0, unpackSize = 0;
+            if (blocks->GetBlockInfo(blockIndex, &unpackPos, &unpackSize) != S_OK) {
+                throw Exception(plzma_error_code_internal, "Can't read archive block info.", __FILE__, __LINE__);
+            }
+            const size_t size = static_cast<size_t>(unpackSize);
+            if (size > bufferSize) {
+                buffer.resize(size);
+                bufferSize = size;
+            }
+            const HRESULT result = blocks->DecodeBlock(blockIndex, static_cast<Byte *>(buffer));
+            if (result == E_OUTOFMEMORY) {
+                throw Exception(plzma_error_code_not_enough_memory, "Can't allocate memory for the block decoding.", __FILE__, __LINE__);
+            } else if (result != S_OK) {
+                throw Exception(plzma_error_code_internal, "Item extracted with error.", __FILE__, __LINE__);
+            }
+            if (!writeBlock(blockIndex, static_cast<const Byte *>(buffer), size)) {
+                return;
+            }
+        }
+    }
+    
+    bool ExtractCallback::writeBlock(const UInt32 blockIndex, const Byte * data, const size_t size) {
+        const unsigned workersCount = _workers.Size();
+        for (;;) {
+            {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (_result != S_OK || _workerFailed) {
+                    return false;
+                } else if (_nextBlock == blockIndex) {
+                    break;
+                }
+            }
+            _workers[blockIndex % workersCount].turnEvent.Lock();
+        }
+        
+        // The blocks are written in order, the previous block's writer passes the turn.
+        if (_blocksOutStream && WriteStream(_blocksOutStream, data, size) != S_OK) {
+            throw Exception(plzma_error_code_io, "Can't write extracted block.", __FILE__, __LINE__);
+        }
+        
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _nextBlock++;
+        _blocksCompleted += size;
+#if !defined(LIBPLZMA_NO_PROGRESS)
+        _progress->setCompleted(_blocksCompleted);
+#endif
+        _workers[_nextBlock % workersCount].turnEvent.Set();
+        return true;
+    }
+    
+    bool ExtractCallback::extractBlocksParallel(const CRecordVector<UInt32> & indices) {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        return false;
+#else
+        CMyComPtr<IArchiveIndexedBlocks> blocks;
+        _archive->QueryInterface(IID_IArchiveIndexedBlocks, reinterpret_cast<void**>(&blocks));
+        UInt32 blocksCount = 0;
+        if (indices.Size() != 1 || !blocks || blocks->GetNumberOfBlocks(&blocksCount) != S_OK || blocksCount < 2) {
+            return false;
+        }
+        UInt64 unpackPos = 0, unpackSize = 0, maxBlockSize = 0;
+        for (UInt32 i = 0; i < blocksCount; i++) {
+            if (blocks->GetBlockInfo(i, &unpackPos, &unpackSize) != S_OK) {
+                return false;
+            }
+            maxBlockSize = MyMax<UInt64>(maxBlockSize, unpackSize);
+        }
+        
+        // Each worker holds the whole decoded block, so all workers together must fit the memory limit.
+        const UInt64 maxWorkers = (maxBlockSize > 0) ? (workersMemoryLimit() / maxBlockSize) : blocksCount;
+        if (maxWorkers < 2) {
+            return false; // the blocks don't fit -> serial
+        }
+        
+        // Round-robin, each worker decodes every N-th block and writes it after the previous one.
+        const unsigned workersCount = static_cast<unsigned>(MyMin<UInt64>(MyMin<unsigned>(_workersCount, blocksCount), maxWorkers));
+        _workers.ClearAndReserve(workersCount);
+        for (unsigned i = 0; i < workersCount; i++) {
+            Worker & worker = _workers.AddNew();
+            worker.owner = this;
+            worker.indices.ClearAndReserve(blocksCount / workersCount + 1);
+        }
+        for (UInt32 i = 0; i < blocksCount; i++) {
+            _workers[i % workersCount].indices.AddInReserved(i);
+        }
+        for (unsigned i = 0; i < workersCount; i++) {
+            Worker & worker = _workers[i];
+            worker.stream = _archiveProvider->cloneStream();
+            if (!worker.stream) {
+                _workers.Clear();
+                return false; // not clonable -> serial
+            }
+            if (worker.turnEvent.Create() != 0) {
+                _workers.Clear();
+                throw Exception(plzma_error_code_internal, "Can't create extract worker event.", __FILE__, __LINE__);
+            }
+        }
+        
+#if !defined(LIBPLZMA_NO_PROGRESS)
+        _progress->reset();
+        _progress->setPartsCount(1);
+        _progress->startPart();
+        _progress->setTotal(unpackPos + unpackSize);
+#endif
+        
+        CMyComPtr<ISequentialOutStream> outStream;
+        HRESULT result = GetStream(indices[0], &outStream, _mode);
+        if (result == S_OK) {
+            result = PrepareOperation(_mode);
+        }
+        
+        LIBPLZMA_UNIQUE_LOCK(lock, _mutex)
+        if (result != S_OK || _result != S_OK) {
+            _workers.Clear();
+            if (_currentOutStream) {
+                _currentOutStream->close();
+                _currentOutStream.Release();
+            }
+            if (result == E_ABORT || _result == E_ABORT) {
+                return true; // aborted -> without exception
+            } else if (_exception) {
+                Exception localException(static_cast<Exception &&>(*_exception));
+                delete _exception;
+                _exception = nullptr;
+                throw localException;
+            }
+            throw Exception(plzma_error_code_internal, "Unknown extract error.", __FILE__, __LINE__);
+        }
+        _blocksOutStream = outStream;
+        _nextBlock = 0;
+        _blocksCompleted = 0;
+        _extracting = true;
+        LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
+        
+        // The workers are waiting for each other, so all of them must be running.
+        bool threadsCreated = true;
+        for (unsigned i = 0; i < workersCount; i++) {
+            if (_workers[i].thread.Create(workerThread, &_workers[i]) != 0) {
+                threadsCreated = false;
+                abortWorkers();
+                break;
+            }
+        }
+        for (unsigned i = 0; i < workersCount; i++) {
+            if (_workers[i].thread.IsCreated()) {
+                _workers[i].thread.Wait_Close();
+            }
+        }
+        
+        LIBPLZMA_UNIQUE_LOCK_LOCK(lock)
+        _extracting = false;
+        _blocksOutStream.Release();
+        if (_currentOutStream) {
+            _currentOutStream->close();
+            _currentOutStream.Release();
+        }
+        if (_result == E_ABORT) {
+            _workers.Clear();
+            return true; // aborted -> without exception
+        }
+        for (unsigned i = 0; i < workersCount; i++) {
+            if (_workers[i].exception) {
+                Exception localException(static_cast<Exception &&>(*_workers[i].exception));
+                _workers.Clear();
+                throw localException;
+            }
+        }
+        _workers.Clear();
+        if (!threadsCreated) {
+            throw Exception(plzma_error_code_internal, "Can't create extract worker thread.", __FILE__, __LINE__);
+        } else if (_nextBlock != blocksCount) {
+            throw Exception(plzma_error_code_internal, "Item extracted with error.", __FILE__, __LINE__);
+        }
+        LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
+        
+#if !defined(LIBPLZMA_NO_PROGRESS)
+        _progress->finish();
+#endif
+        return true;
+#endif // !LIBPLZMA_THREAD_UNSAFE
+    }
+    
+    void ExtractCallback::process() {
+        CMyComPtr<ExtractCallback> selfPtr(this);
+        CRecordVector<UInt32> indices;
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            NWindows::NCOM::CPropVariant prop;
+            if (_archive->GetArchiveProperty(kpidSolid, &prop) != S_OK) {
+                throw Exception(plzma_error_code_internal, "Can't read archive solid property.", __FILE__, __LINE__);
+            }
+            _solidArchive = PROPVARIANTGetBool(prop);
+            
+            if (_itemsArray) {
+                _itemsArray->sort();
+                const plzma_size_t itemsCount = _itemsArray->count();
+                indices.ClearAndReserve(itemsCount);
+                for (plzma_size_t i = 0; i < itemsCount; i++) {
+                    indices.AddInReserved(_itemsArray->at(i)->index());
+                }
+            } else if (_itemsMap) {
+                _itemsMap->sort();
+                const plzma_size_t itemsCount = _itemsMap->count();
+                indices.ClearAndReserve(itemsCount);
+                for (plzma_size_t i = 0; i < itemsCount; i++) {
+                    indices.AddInReserved(_itemsMap->at(i).first->index());
+                }
+            } else if (_indicesSelected) {
+                indices = _selectedIndices;
+            } else {
+                UInt32 numItems = 0;
+                if (_archive->GetNumberOfItems(&numItems) != S_OK) {
+                    throw Exception(plzma_error_code_internal, "Can't get number of archive items.", __FILE__, __LINE__);
+                }
+                indices.ClearAndReserve(numItems);
+                for (UInt32 i = 0; i < numItems; i++) {
+                    indices.AddInReserved(i);
+                }
+            }
+        }
+        
+        if (extractParallel(indices)) {
+            return;
+        }
+        
+        CRecordVector<unsigned> ends;
+        batchEnds(indices, ends);
+        
+#if !defined(LIBPLZMA_NO_PROGRESS)
+        _progress->reset();
+        _progress->setPartsCount(ends.Size());
+#endif
+        
+        extract(indices, ends);
+        
+#if !defined(LIBPLZMA_NO_PROGRESS)
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_result == S_OK) {
+            _progress->finish();
+        }
 #endif
     }
     
@@ -413,6 +961,22 @@ namespace plzma {
         process();
     }
     
+    void ExtractCallback::process(const Int32 mode, const CRecordVector<UInt32> & indices, const Path & path, const bool itemsFullPath) {
+        _path.set(path);
+        _mode = mode;
+        _selectedIndices = indices;
+        _indicesSelected = true;
+        _itemsFullPath = itemsFullPath;
+        process();
+    }
+    
+    void ExtractCallback::process(const Int32 mode, const CRecordVector<UInt32> & indices) {
+        _mode = mode;
+        _selectedIndices = indices;
+        _indicesSelected = true;
+        process();
+    }
+    
     void ExtractCallback::process(const Int32 mode) {
         _mode = mode;
         process();
@@ -425,6 +989,34 @@ namespace plzma {
             _currentOutStream->close();
             _currentOutStream.Release();
         }
+        for (unsigned i = 0; i < _workers.Size(); i++) {
+            if (_workers[i].callback) {
+                _workers[i].callback->abort();
+            }
+            if (_workers[i].turnEvent.IsCreated()) {
+                _workers[i].turnEvent.Set();
+            }
+        }
+    }
+    
+    void ExtractCallback::abortWorkers() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _workerFailed = true;
+        for (unsigned i = 0; i < _workers.Size(); i++) {
+            if (_workers[i].callback) {
+                _workers[i].callback->abort();
+            }
+            if (_workers[i].turnEvent.IsCreated()) {
+                _workers[i].turnEvent.Set();
+            }
+        }
+    }
+    
+    void ExtractCallback::setWorkers(const UInt32 count, const UInt64 memoryLimit, ExtractArchiveProvider * provider) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _workersCount = count;
+        _memoryLimit = memoryLimit;
+        _archiveProvider = provider;
     }
     
     ExtractCallback::ExtractCallback(const CMyComPtr<IInArchive> & archive,
@@ -445,4 +1037,26 @@ namespace plzma {
 #endif
     }
     
+    ExtractCallback::ExtractCallback(ExtractCallback * parent, Worker * worker, const CMyComPtr<IInArchive> & archive) : CMyUnknownImp(),
+        _path(parent->_path),
+        _archive(archive),
+        _itemsMap(parent->_itemsMap),
+        _parent(parent),
+        _worker(worker),
+        _mode(parent->_mode),
+        _type(parent->_type),
+        _itemsFullPath(parent->_itemsFullPath),
+        _solidArchive(parent->_solidArchive) {
+#if !defined(LIBPLZMA_NO_CRYPTO)
+            _password = parent->_password;
+#endif
+#if !defined(LIBPLZMA_NO_PROGRESS)
+            _progress = parent->_progress;
+#endif
+    }
+    
+    ExtractCallback::~ExtractCallback() {
+        
+    }
+    
 } // namespace plzma
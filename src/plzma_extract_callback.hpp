@@ -42,6 +42,9 @@
 #include "CPP/Common/MyWindows.h"
 #include "CPP/Common/MyString.h"
 #include "CPP/Common/MyCom.h"
+#include "CPP/Common/MyVector.h"
+#include "CPP/Windows/Thread.h"
+#include "CPP/Windows/Synchronization.h"
 #include "CPP/7zip/Archive/IArchive.h"
 #include "CPP/7zip/IPassword.h"
 #include "CPP/7zip/ICoder.h"
@@ -49,6 +52,19 @@
 
 namespace plzma {
     
+    /// @brief Provides independent archive instances for the parallel extract workers.
+    class ExtractArchiveProvider {
+    public:
+        /// @return The new, closed stream with the archive content or empty pointer if the stream can't be cloned.
+        virtual CMyComPtr<InStreamBase> cloneStream() = 0;
+        
+        /// @brief Opens the stream and the archive with the same settings as the original one.
+        /// @return The opened archive or empty pointer if the opening was aborted.
+        virtual CMyComPtr<IInArchive> openArchive(const CMyComPtr<InStreamBase> & stream) = 0;
+        
+        virtual ~ExtractArchiveProvider() { }
+    };
+    
     class ExtractCallback final :
         public IArchiveExtractCallback,
         public IArchiveExtractCallbackMessage,
@@ -58,26 +74,73 @@ namespace plzma {
         public BaseCallback,
         public CMyUnknownImp {
     private:
+        struct Worker final {
+            NWindows::CThread thread;
+            NWindows::NSynchronization::CAutoResetEvent turnEvent; // signaled when the next block can be written
+            CRecordVector<UInt32> indices; // items of the folders or the blocks of the stream
+            CRecordVector<unsigned> batchEnds; // the end of each extract batch in the indices
+            CMyComPtr<InStreamBase> stream;
+            CMyComPtr<ExtractCallback> callback;
+            ExtractCallback * owner = nullptr;
+            Exception * exception = nullptr;
+            UInt64 size = 0; // unpack size of the items
+            UInt64 partCompleted = 0;
+            UInt64 partTotal = 0;
+            UInt32 partsCount = 1;
+            UInt32 partNumber = 0;
+            ~Worker() { delete exception; }
+        };
+        
         Path _path;
         CMyComPtr<InStreamBase> _stream;
         CMyComPtr<OutStreamBase> _currentOutStream;
         CMyComPtr<IInArchive> _archive;
+        CMyComPtr<ISequentialOutStream> _blocksOutStream;
         SharedPtr<ItemOutStreamArray> _itemsMap;
         SharedPtr<ItemArray> _itemsArray;
+        CRecordVector<UInt32> _selectedIndices; // ascending indices of the items matched by the decoder
+        CObjectVector<Worker> _workers;
+        ExtractArchiveProvider * _archiveProvider = nullptr;
+        ExtractCallback * _parent = nullptr; // owner of the worker's callback, not retained
+        Worker * _worker = nullptr;
+        UInt64 _memoryLimit = 0;
+        UInt32 _workersCount = 1;
         UInt32 _extractingFirstIndex = 0;
         UInt32 _extractingLastIndex = 0;
+        UInt32 _nextBlock = 0; // the index of the next block to write in order
+        UInt64 _blocksCompleted = 0;
         Int32 _mode = 0; // The value of the 'NArchive::NExtract::NAskMode' anonymous enum.
         plzma_file_type _type = plzma_file_type_7z;
         bool _itemsFullPath = true;
         bool _solidArchive = false;
         bool _extracting = false;
         bool _passwordRequested = false;
+        bool _workerFailed = false;
+        bool _indicesSelected = false;
         
         void getTestStream(const UInt32 index, ISequentialOutStream ** outStream);
         void getExtractStream(const UInt32 index, ISequentialOutStream ** outStream);
         
+        UInt32 folderIndex(const UInt32 index);
+        void batchEnds(const CRecordVector<UInt32> & indices, CRecordVector<unsigned> & ends);
+        void startPart();
+        void extract(const CRecordVector<UInt32> & indices, const CRecordVector<unsigned> & ends);
+        UInt64 workersMemoryLimit() const;
+        bool extractParallel(const CRecordVector<UInt32> & indices);
+        bool extractBlocksParallel(const CRecordVector<UInt32> & indices);
+        void decodeBlocks(Worker * worker, const CMyComPtr<IInArchive> & archive);
+        bool writeBlock(const UInt32 blockIndex, const Byte * data, const size_t size);
+        void abortWorkers();
+#if !defined(LIBPLZMA_NO_PROGRESS)
+        HRESULT setWorkerProgress(const UInt64 * total, const UInt64 * completed) noexcept;
+        HRESULT updateWorkerProgress(Worker * worker, const UInt64 * total, const UInt64 * completed) noexcept;
+#endif
+        static THREAD_FUNC_DECL workerThread(void * param);
+        
         void process();
         
+        ExtractCallback(ExtractCallback * parent, Worker * worker, const CMyComPtr<IInArchive> & archive);
+        
         LIBPLZMA_NON_COPYABLE_NON_MOVABLE(ExtractCallback)
         
     public:
@@ -98,8 +161,18 @@ namespace plzma {
         void process(const Int32 mode, const Path & path, const bool itemsFullPath = true);
         void process(const Int32 mode, const SharedPtr<ItemOutStreamArray> & items);
         void process(const Int32 mode, const SharedPtr<ItemArray> & items);
+        void process(const Int32 mode, const CRecordVector<UInt32> & indices, const Path & path, const bool itemsFullPath = true);
+        void process(const Int32 mode, const CRecordVector<UInt32> & indices);
         void process(const Int32 mode);
         void abort();
+        
+        /// @brief Allows to extract the independent solid blocks(folders) of the 7z archive
+        /// or the indexed blocks of the xz stream in parallel.
+        /// @param count The maximum number of the workers, each worker opens own copy of the archive.
+        /// @param memoryLimit The memory limit of the decoder, \a 0 means a half of the physical memory.
+        /// The workers of the xz stream hold the decoded blocks, so their number is limited by this memory.
+        void setWorkers(const UInt32 count, const UInt64 memoryLimit, ExtractArchiveProvider * provider);
+        
         ExtractCallback(const CMyComPtr<IInArchive> & archive,
 #if !defined(LIBPLZMA_NO_CRYPTO)
                         const String & passwd,
@@ -108,7 +181,7 @@ namespace plzma {
                         const SharedPtr<Progress> & progress,
 #endif
                         const plzma_file_type type);
-        virtual ~ExtractCallback() { }
+        virtual ~ExtractCallback();
     };
     
 } // namespace plzma
@@ -0,0 +1,279 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <cstddef>
+
+#include "plzma_in_push_stream.hpp"
+
+#include "CPP/Common/Defs.h"
+
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+
+namespace plzma {
+    
+    /// InPushStreamBuffers
+    // The bounded size of the buffer of the written item.
+    static const size_t kInPushStreamBufferCapacity = 1 << 20;
+    
+    static const plzma_size_t kInPushStreamNoIndex = static_cast<plzma_size_t>(-1);
+    
+    plzma_size_t InPushStreamBuffers::add(const Path & archivePath) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        Buffer buffer;
+        buffer.archivePath = archivePath;
+        _buffers.push(static_cast<Buffer &&>(buffer));
+        return _buffers.count() - 1;
+    }
+    
+    bool InPushStreamBuffers::begin(const Path & archivePath) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_finished) {
+            return false;
+        }
+        if (_writing != kInPushStreamNoIndex) {
+            throw Exception(plzma_error_code_invalid_arguments, "Can't begin item before ending the previous one.", __FILE__, __LINE__);
+        }
+        for (plzma_size_t i = 0, n = _buffers.count(); i < n; i++) {
+            Buffer & buffer = _buffers.at(i);
+            if (buffer.archivePath == archivePath) {
+                if (buffer.began) {
+                    Exception exception(plzma_error_code_invalid_arguments, nullptr, __FILE__, __LINE__);
+                    exception.setWhat("Can't begin already pushed item: ", archivePath.utf8(), nullptr);
+                    throw exception;
+                }
+                buffer.began = true;
+                _writing = i;
+                return true;
+            }
+        }
+        Exception exception(plzma_error_code_invalid_arguments, nullptr, __FILE__, __LINE__);
+        exception.setWhat("Can't begin not added push item: ", archivePath.utf8(), nullptr);
+        throw exception;
+    }
+    
+    void InPushStreamBuffers::write(Buffer & buffer, const void * data, const size_t size) {
+        if (buffer.start + buffer.count + size > buffer.capacity) {
+            if (buffer.count + size > buffer.capacity) {
+                const size_t required = buffer.count + size;
+                size_t capacity = MyMax<size_t>(buffer.capacity + (buffer.capacity / 2), kInPushStreamBufferCapacity);
+                if (capacity < required) {
+                    capacity = required;
+                }
+                if (buffer.start > 0) {
+                    memmove(buffer.memory, static_cast<uint8_t *>(buffer.memory) + buffer.start, buffer.count);
+                    buffer.start = 0;
+                }
+                buffer.memory.resize(capacity);
+                buffer.capacity = capacity;
+            } else {
+                memmove(buffer.memory, static_cast<uint8_t *>(buffer.memory) + buffer.start, buffer.count);
+                buffer.start = 0;
+            }
+        }
+        memcpy(static_cast<uint8_t *>(buffer.memory) + buffer.start + buffer.count, data, size);
+        buffer.count += size;
+    }
+    
+    bool InPushStreamBuffers::write(const void * data, const size_t size) {
+        const uint8_t * src = static_cast<const uint8_t *>(data);
+        size_t written = 0;
+        while (written < size) {
+            size_t chunk = 0;
+            {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (_finished) {
+                    return false;
+                }
+                if (_writing == kInPushStreamNoIndex) {
+                    throw Exception(plzma_error_code_invalid_arguments, "Can't write without beginning the item.", __FILE__, __LINE__);
+                }
+                Buffer & buffer = _buffers.at(_writing);
+                if (buffer.closed) {
+                    return true; // the encoder no longer reads the item, i.e. failed
+                }
+                if (_readerWaiting && _reading != _writing) {
+                    chunk = size - written; // the encoder waits for the other item -> grow
+                } else {
+                    const size_t space = MyMax<size_t>(buffer.capacity, kInPushStreamBufferCapacity) - buffer.count;
+                    chunk = MyMin<size_t>(space, size - written);
+                }
+                if (chunk > 0) {
+                    write(buffer, src + written, chunk);
+                    written += chunk;
+                }
+            }
+            if (chunk > 0) {
+                _readEvent.Set();
+            }
+            if (written < size) {
+                _writeEvent.Lock();
+            }
+        }
+        return true;
+    }
+    
+    bool InPushStreamBuffers::end() {
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            if (_finished) {
+                return false;
+            }
+            if (_writing == kInPushStreamNoIndex) {
+                throw Exception(plzma_error_code_invalid_arguments, "Can't end not begun item.", __FILE__, __LINE__);
+            }
+            _buffers.at(_writing).ended = true;
+            _writing = kInPushStreamNoIndex;
+        }
+        _readEvent.Set();
+        return true;
+    }
+    
+    HRESULT InPushStreamBuffers::read(const plzma_size_t index, void * data, UInt32 size, UInt32 * processedSize) {
+        LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, 0)
+        for (;;) {
+            UInt32 copied = 0;
+            {
+                const FailableLockGuard lock(_mutex);
+                RINOK(lock.res())
+                if (_finished) {
+                    return E_ABORT;
+                }
+                Buffer & buffer = _buffers.at(index);
+                if (buffer.count == 0 && !buffer.ended && size > 0) {
+                    _readerWaiting = true;
+                } else {
+                    _readerWaiting = false;
+                    copied = static_cast<UInt32>(MyMin<size_t>(buffer.count, size));
+                    if (copied == 0) {
+                        return S_OK; // ended
+                    }
+                    memcpy(data, static_cast<const uint8_t *>(buffer.memory) + buffer.start, copied);
+                    buffer.count -= copied;
+                    buffer.start = (buffer.count > 0) ? (buffer.start + copied) : 0;
+                }
+            }
+            _writeEvent.Set(); // the space is available or the writer might grow the buffer
+            if (copied > 0) {
+                LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, copied)
+                return S_OK;
+            }
+            _readEvent.Lock();
+        }
+        return S_OK;
+    }
+    
+    void InPushStreamBuffers::open(const plzma_size_t index) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _reading = index;
+    }
+    
+    void InPushStreamBuffers::close(const plzma_size_t index) {
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            Buffer & buffer = _buffers.at(index);
+            buffer.closed = true;
+            buffer.memory.clear();
+            buffer.capacity = buffer.start = buffer.count = 0;
+            if (_reading == index) {
+                _reading = kInPushStreamNoIndex;
+                _readerWaiting = false;
+            }
+        }
+        _writeEvent.Set();
+    }
+    
+    void InPushStreamBuffers::finish() noexcept {
+        try {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            _finished = true;
+        } catch (...) {
+            // do nothing
+        }
+        _readEvent.Set();
+        _writeEvent.Set();
+    }
+    
+    InPushStreamBuffers::InPushStreamBuffers() : CMyUnknownImp(),
+        _writing(kInPushStreamNoIndex),
+        _reading(kInPushStreamNoIndex) {
+            if (_readEvent.Create() != 0 || _writeEvent.Create() != 0) {
+                throw Exception(plzma_error_code_internal, "Can't create push stream events.", __FILE__, __LINE__);
+            }
+    }
+    
+    /// InPushStream
+    STDMETHODIMP InPushStream::Seek(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition) {
+        if (offset == 0 && seekOrigin == SZ_SEEK_CUR) {
+            LIBPLZMA_SET_VALUE_TO_PTR(newPosition, _position)
+            return S_OK;
+        }
+        return E_NOTIMPL;
+    }
+    
+    STDMETHODIMP InPushStream::Read(void * data, UInt32 size, UInt32 * processedSize) {
+        UInt32 processed = 0;
+        const HRESULT res = _buffers->read(_index, data, size, &processed);
+        _position += processed;
+        LIBPLZMA_SET_VALUE_TO_PTR(processedSize, processed)
+        return res;
+    }
+    
+    void InPushStream::open() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (!_opened) {
+            _buffers->open(_index);
+            _position = 0;
+            _opened = true;
+        }
+    }
+    
+    void InPushStream::close() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_opened) {
+            _buffers->close(_index);
+            _opened = false;
+        }
+    }
+    
+    bool InPushStream::opened() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _opened;
+    }
+    
+    InPushStream::InPushStream(const CMyComPtr<InPushStreamBuffers> & buffers, const plzma_size_t index) : InStreamBase(),
+        _buffers(buffers),
+        _index(index) {
+        
+    }
+    
+    InPushStream::~InPushStream() noexcept {
+        close();
+    }
+    
+} // namespace plzma
+
+#endif // !LIBPLZMA_THREAD_UNSAFE
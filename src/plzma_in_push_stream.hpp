@@ -0,0 +1,142 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#ifndef __PLZMA_IN_PUSH_STREAM_HPP__
+#define __PLZMA_IN_PUSH_STREAM_HPP__ 1
+
+#include <cstddef>
+
+#include "../libplzma.hpp"
+#include "plzma_private.hpp"
+#include "plzma_in_streams.hpp"
+#include "plzma_mutex.hpp"
+
+#include "CPP/Common/Common.h"
+#include "CPP/Common/MyWindows.h"
+#include "CPP/Common/MyCom.h"
+#include "CPP/Windows/Synchronization.h"
+
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+
+namespace plzma {
+    
+    /// @brief The size of the pushed item reported to the archive handler, the actual size is unknown.
+    ///
+    /// Non-zero, 7z skips the content of the empty items. The 7z coders reduce the dictionary to the reported size,
+    /// the hint is equal to the largest dictionary of the compression levels(LZMA/LZMA2 level 9), a larger dictionary
+    /// is reduced to the hint. The 7z solid block limits count each pushed item as the hint, not as the pushed content.
+    /// Tar rewrites the item header with the actual size.
+    static const uint64_t kInPushStreamSizeHint = static_cast<uint64_t>(1) << 26;
+    
+    /// @brief The buffers of the encoder items which content is pushed by the producer.
+    ///
+    /// The producer writes the items one by one, the encoder reads them in own order.
+    /// The buffer of the written item is bounded, except the case when the encoder waits for the other item.
+    class InPushStreamBuffers final : public CMyUnknownImp {
+    private:
+        struct Buffer final {
+            Path archivePath;
+            RawHeapMemory memory;
+            size_t capacity = 0;
+            size_t start = 0;
+            size_t count = 0;
+            bool began = false;
+            bool ended = false;
+            bool closed = false; // the encoder no longer reads
+        };
+        LIBPLZMA_MUTEX(mutable _mutex)
+        NWindows::NSynchronization::CAutoResetEvent _readEvent;  // signaled after write, end or finish
+        NWindows::NSynchronization::CAutoResetEvent _writeEvent; // signaled after read, waiting of the reader or finish
+        Vector<Buffer> _buffers;
+        plzma_size_t _writing;
+        plzma_size_t _reading;
+        bool _readerWaiting = false;
+        bool _finished = false;
+        
+        void write(Buffer & buffer, const void * data, const size_t size);
+        
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(InPushStreamBuffers)
+        
+    public:
+        MY_ADDREF_RELEASE
+        
+        /// @return The index of the added item buffer.
+        plzma_size_t add(const Path & archivePath);
+        
+        /// @return \a false if the encoder finished or aborted, otherwise \a true.
+        bool begin(const Path & archivePath);
+        
+        /// @brief Blocks while the buffer of the item is full and the encoder reads or not yet started.
+        /// @return \a false if the encoder finished or aborted, otherwise \a true.
+        bool write(const void * data, const size_t size);
+        
+        /// @return \a false if the encoder finished or aborted, otherwise \a true.
+        bool end();
+        
+        /// @brief Blocks until the data of the item is written or the item ended.
+        HRESULT read(const plzma_size_t index, void * data, UInt32 size, UInt32 * processedSize);
+        void open(const plzma_size_t index);
+        void close(const plzma_size_t index);
+        
+        /// @brief The encoder finished or aborted, wakes up the producer and the encoder.
+        void finish() noexcept;
+        
+        InPushStreamBuffers();
+        ~InPushStreamBuffers() noexcept { }
+    };
+    
+    /// @brief The content of a single pushed item, read by the encoder.
+    class InPushStream final : public InStreamBase {
+    private:
+        CMyComPtr<InPushStreamBuffers> _buffers;
+        UInt64 _position = 0;
+        plzma_size_t _index = 0;
+        bool _opened = false;
+        
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(InPushStream)
+        
+    public:
+        MY_UNKNOWN_IMP1(ISequentialInStream)
+        
+        STDMETHOD(Seek)(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition);
+        STDMETHOD(Read)(void * data, UInt32 size, UInt32 * processedSize);
+        
+        virtual void open() final;
+        virtual void close() final;
+        
+        virtual bool opened() const final;
+        virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final { return false; }
+        
+        InPushStream(const CMyComPtr<InPushStreamBuffers> & buffers, const plzma_size_t index);
+        virtual ~InPushStream() noexcept;
+    };
+    
+} // namespace plzma
+
+#endif // !LIBPLZMA_THREAD_UNSAFE
+
+#endif // !__PLZMA_IN_PUSH_STREAM_HPP__
@@ -32,6 +32,14 @@
 #include "plzma_file_utils.hpp"
 
 #include "CPP/Common/MyString.h"
+#include "CPP/Common/Defs.h"
+
+#if defined(LIBPLZMA_POSIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 namespace plzma {
     
@@ -53,11 +61,108 @@ namespace plzma {
 #endif
     }
     
+    CMyComPtr<InStreamBase> InStreamBase::clone() {
+        return CMyComPtr<InStreamBase>();
+    }
+    
     InStreamBase::InStreamBase() : CMyUnknownImp() {
 
     }
     
     /// InFileStream
+#if defined(LIBPLZMA_POSIX)
+    // The POSIX file is read via 'pread' at own position of the stream, without the shared position of the 'FILE'.
+    // The clones of the opened stream read the file of the owner, so the concurrent readers don't need the locks
+    // or the separate file descriptors.
+    STDMETHODIMP InFileStream::Read(void * data, UInt32 size, UInt32 * processedSize) {
+        FILE * file = _sharedFile ? _owner->_file : (_closePending ? nullptr : _file);
+        if (file) {
+            const int fd = fileno(file);
+            size_t processed = 0;
+            while (processed < size) {
+                const ssize_t readed = pread(fd, static_cast<uint8_t *>(data) + processed, size - processed, static_cast<off_t>(_offset + processed));
+                if (readed > 0) {
+                    processed += static_cast<size_t>(readed);
+                } else if (readed == 0) {
+                    break;
+                } else if (errno != EINTR) {
+                    if (processed == 0) {
+                        LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, 0)
+                        return E_FAIL;
+                    }
+                    break;
+                }
+            }
+            _offset += processed;
+            LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, processed)
+            return S_OK;
+        }
+        LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, 0)
+        return S_FALSE;
+    }
+    
+    STDMETHODIMP InFileStream::Seek(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition) {
+        FILE * file = _sharedFile ? _owner->_file : (_closePending ? nullptr : _file);
+        if (file) {
+            Int64 finalOffset;
+            struct stat st;
+            switch (seekOrigin) {
+                case STREAM_SEEK_SET:
+                    finalOffset = offset;
+                    break;
+                case STREAM_SEEK_CUR:
+                    finalOffset = _offset;
+                    finalOffset += offset;
+                    break;
+                case STREAM_SEEK_END:
+                    finalOffset = (fstat(fileno(file), &st) == 0) ? st.st_size + offset : -1;
+                    break;
+                default:
+                    finalOffset = -1;
+                    break;
+            }
+            if (finalOffset >= 0) {
+                _offset = finalOffset;
+                LIBPLZMA_CAST_VALUE_TO_PTR(newPosition, UInt64, _offset)
+                return S_OK;
+            }
+        }
+        LIBPLZMA_CAST_VALUE_TO_PTR(newPosition, UInt64, 0)
+        return S_FALSE;
+    }
+    
+    bool InFileStream::opened() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return (_file != nullptr && !_closePending) || _sharedFile;
+    }
+    
+    void InFileStream::closeFile() noexcept {
+        if (_file) {
+            fclose(_file);
+            _file = nullptr;
+        }
+        _closePending = false;
+    }
+    
+    void InFileStream::closeClone() {
+        LIBPLZMA_LOCKGUARD(lock, _owner->_mutex)
+        if (--_owner->_openedClones == 0 && _owner->_closePending) {
+            _owner->closeFile();
+        }
+    }
+    
+    void InFileStream::close() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_sharedFile) {
+            _sharedFile = false;
+            closeClone();
+        } else if (_openedClones > 0) {
+            _closePending = true; // the clones are still reading the file
+        } else {
+            closeFile();
+        }
+    }
+#else
     STDMETHODIMP InFileStream::Read(void * data, UInt32 size, UInt32 * processedSize) {
         if (_file) {
             const size_t processed = (size > 0) ? fread(data, 1, size, _file) : 0;
@@ -82,11 +187,39 @@ namespace plzma {
         return _file != nullptr;
     }
     
+    void InFileStream::close() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_file) {
+            fclose(_file);
+            _file = nullptr;
+        }
+    }
+#endif
+    
     void InFileStream::open() {
         LIBPLZMA_LOCKGUARD(lock, _mutex)
+#if defined(LIBPLZMA_POSIX)
+        if (_file || _sharedFile) {
+            if (_closePending) { // reopened before the clones finished reading, read from the start as a new file
+                _closePending = false;
+                _offset = 0;
+            }
+            return;
+        }
+        _offset = 0;
+        if (_owner) {
+            LIBPLZMA_LOCKGUARD(ownerLock, _owner->_mutex)
+            if (_owner->_file && !_owner->_closePending) {
+                _owner->_openedClones++;
+                _sharedFile = true;
+                return;
+            }
+        }
+#else
         if (_file) {
             return;
         }
+#endif
         FILE * f = _path.openFile("rb");
         if (f) {
             _file = f;
@@ -98,17 +231,13 @@ namespace plzma {
         }
     }
     
-    void InFileStream::close() {
-        LIBPLZMA_LOCKGUARD(lock, _mutex)
-        if (_file) {
-            fclose(_file);
-            _file = nullptr;
-        }
-    }
-    
     bool InFileStream::erase(const plzma_erase eraseType) {
         LIBPLZMA_LOCKGUARD(lock, _mutex)
+#if defined(LIBPLZMA_POSIX)
+        if (_file || _sharedFile) {
+#else
         if (_file) {
+#endif
             return false; // opened -> false
         }
         bool isDir = true;
@@ -121,6 +250,14 @@ namespace plzma {
         return true;
     }
     
+    CMyComPtr<InStreamBase> InFileStream::clone() {
+#if defined(LIBPLZMA_POSIX)
+        return CMyComPtr<InStreamBase>(new InFileStream(_owner ? _owner : CMyComPtr<InFileStream>(this)));
+#else
+        return CMyComPtr<InStreamBase>(new InFileStream(_path));
+#endif
+    }
+    
     const Path & InFileStream::path() const noexcept {
         return _path;
     }
@@ -143,12 +280,198 @@ namespace plzma {
             }
     }
     
+#if defined(LIBPLZMA_POSIX)
+    InFileStream::InFileStream(const CMyComPtr<InFileStream> & owner) : InStreamBase(),
+        _path(owner->_path),
+        _owner(owner) {
+        
+    }
+#endif
+    
     InFileStream::~InFileStream() noexcept {
+#if defined(LIBPLZMA_POSIX)
+        if (_sharedFile) {
+            try {
+                closeClone();
+            } catch (...) { }
+        }
+#endif
         if (_file) {
             fclose(_file);
         }
     }
     
+    /// InMmapStream
+    // The number of the sequential reads before advising the sequential access to the rest of the mapping.
+    static const UInt32 kMmapSequentialReads = 4;
+    
+    // The size of the region after the new position which will be needed soon.
+    static const UInt64 kMmapWillNeedSize = 1 << 20;
+    
+    void InMmapStream::advise(const UInt64 offset, const UInt64 size, const int advice) noexcept {
+#if defined(LIBPLZMA_POSIX)
+        static const UInt64 pageSize = static_cast<UInt64>(sysconf(_SC_PAGESIZE));
+        if (offset < _size && pageSize > 0) {
+            const UInt64 start = offset - (offset % pageSize);
+            const UInt64 end = MyMin<UInt64>(offset + size, _size);
+            madvise(static_cast<uint8_t *>(_memory) + start, static_cast<size_t>(end - start), advice);
+        }
+#endif
+    }
+    
+    void InMmapStream::unmap() noexcept {
+#if defined(LIBPLZMA_POSIX)
+        if (_memory) {
+            munmap(_memory, static_cast<size_t>(_size));
+        }
+#endif
+        _memory = nullptr;
+        _size = _offset = _readOffset = 0;
+        _sequentialReads = 0;
+        _sequentialAdvised = false;
+    }
+    
+    STDMETHODIMP InMmapStream::Read(void * data, UInt32 size, UInt32 * processedSize) {
+        if (_memory) {
+#if defined(LIBPLZMA_POSIX)
+            if (_offset != _readOffset) {
+                _sequentialReads = 0; // random access
+                if (_sequentialAdvised) {
+                    _sequentialAdvised = false;
+                    advise(0, _size, MADV_NORMAL);
+                }
+            } else if (!_sequentialAdvised && ++_sequentialReads >= kMmapSequentialReads) {
+                _sequentialAdvised = true;
+                advise(_offset, _size, MADV_SEQUENTIAL);
+            }
+#endif
+            const UInt64 available = _size - _offset;
+            const size_t sizeToRead = (size <= available) ? size : static_cast<size_t>(available);
+            if (sizeToRead > 0) {
+                memcpy(data, static_cast<const uint8_t *>(_memory) + _offset, sizeToRead);
+                _offset += sizeToRead;
+            }
+            _readOffset = _offset;
+            LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, sizeToRead)
+            return S_OK;
+        } else if (_fileStream) {
+            return _fileStream->Read(data, size, processedSize);
+        }
+        LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, 0)
+        return S_FALSE;
+    }
+    
+    STDMETHODIMP InMmapStream::Seek(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition) {
+        if (_memory) {
+            Int64 finalOffset;
+            switch (seekOrigin) {
+                case STREAM_SEEK_SET: finalOffset = offset; break;
+                case STREAM_SEEK_CUR: finalOffset = _offset; finalOffset += offset; break;
+                case STREAM_SEEK_END: finalOffset = _size; finalOffset += offset; break;
+                default: finalOffset = -1; break;
+            }
+            if (finalOffset >= 0 && static_cast<UInt64>(finalOffset) <= _size) {
+#if defined(LIBPLZMA_POSIX)
+                if (static_cast<UInt64>(finalOffset) != _offset && !_sequentialAdvised) {
+                    advise(finalOffset, kMmapWillNeedSize, MADV_WILLNEED);
+                }
+#endif
+                _offset = finalOffset;
+                LIBPLZMA_CAST_VALUE_TO_PTR(newPosition, UInt64, _offset)
+                return S_OK;
+            }
+            _offset = 0;
+        } else if (_fileStream) {
+            return _fileStream->Seek(offset, seekOrigin, newPosition);
+        }
+        LIBPLZMA_CAST_VALUE_TO_PTR(newPosition, UInt64, 0);
+        return S_FALSE;
+    }
+    
+    bool InMmapStream::opened() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _opened;
+    }
+    
+    void InMmapStream::open() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_opened) {
+            return;
+        }
+#if defined(LIBPLZMA_POSIX)
+        FILE * f = _path.openFile("rb");
+        if (!f) {
+            Exception exception(plzma_error_code_io, nullptr, __FILE__, __LINE__);
+            exception.setWhat("Can't open in-stream for reading from file in binary mode with path: ", _path.utf8(), nullptr);
+            exception.setReason("File doesn't exist or is not readable.", nullptr);
+            throw exception;
+        }
+        struct stat st;
+        void * memory = MAP_FAILED;
+        if (fstat(fileno(f), &st) == 0 && st.st_size > 0 && static_cast<uint64_t>(st.st_size) <= static_cast<uint64_t>(SIZE_MAX)) {
+            memory = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fileno(f), 0);
+        }
+        fclose(f); // the mapping keeps the reference to the file
+        if (memory != MAP_FAILED) {
+            _memory = memory;
+            _size = static_cast<UInt64>(st.st_size);
+            _offset = _readOffset = 0;
+            advise(0, kMmapWillNeedSize, MADV_WILLNEED);
+            _opened = true;
+            return;
+        }
+#endif
+        if (!_fileStream) {
+            _fileStream = CMyComPtr<InFileStream>(new InFileStream(_path));
+        }
+        _fileStream->open();
+        _opened = true;
+    }
+    
+    void InMmapStream::close() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        unmap();
+        if (_fileStream) {
+            _fileStream->close();
+        }
+        _opened = false;
+    }
+    
+    bool InMmapStream::erase(const plzma_erase eraseType) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_opened) {
+            return false; // opened -> false
+        }
+        CMyComPtr<InFileStream> fileStream(_fileStream ? _fileStream : CMyComPtr<InFileStream>(new InFileStream(_path)));
+        return fileStream->erase(eraseType);
+    }
+    
+    CMyComPtr<InStreamBase> InMmapStream::clone() {
+        return CMyComPtr<InStreamBase>(new InMmapStream(_path));
+    }
+    
+    InMmapStream::InMmapStream(const Path & path) : InStreamBase(),
+        _path(path) {
+            if (_path.count() == 0) {
+                Exception exception(plzma_error_code_invalid_arguments, "Can't instantiate in-stream without path.", __FILE__, __LINE__);
+                exception.setReason("The path is empty.", nullptr);
+                throw exception;
+            }
+    }
+    
+    InMmapStream::InMmapStream(Path && path) : InStreamBase(),
+        _path(static_cast<Path &&>(path)) {
+            if (_path.count() == 0) {
+                Exception exception(plzma_error_code_invalid_arguments, "Can't instantiate in-stream without path.", __FILE__, __LINE__);
+                exception.setReason("The path is empty.", nullptr);
+                throw exception;
+            }
+    }
+    
+    InMmapStream::~InMmapStream() noexcept {
+        unmap();
+    }
+    
     /// InMemStream
     STDMETHODIMP InMemStream::Read(void * data, UInt32 size, UInt32 * processedSize) {
         if (_opened) {
@@ -219,7 +542,7 @@ namespace plzma {
         if (_opened) {
             return false;
         }
-        if (_memory && _size > 0) {
+        if (_memory && _size > 0 && !_owner) { // the shared memory is erasable only by the owner
             switch (eraseType) {
                 case plzma_erase_zero:
                     memset(_memory, 0, static_cast<size_t>(_size));
@@ -266,8 +589,21 @@ namespace plzma {
         }
     }
     
+    CMyComPtr<InStreamBase> InMemStream::clone() {
+        return CMyComPtr<InStreamBase>(new InMemStream(_owner ? _owner : CMyComPtr<InStreamBase>(this), _memory, _size));
+    }
+    
+    InMemStream::InMemStream(const CMyComPtr<InStreamBase> & owner, void * memory, const UInt64 size) : InStreamBase(),
+        _owner(owner),
+        _memory(memory),
+        _size(size) {
+        
+    }
+    
     InMemStream::~InMemStream() noexcept {
-        if (_freeCallback) {
+        if (_owner) {
+            return;
+        } else if (_freeCallback) {
             _freeCallback(_memory);
         } else {
             plzma_free(_memory);
@@ -421,6 +757,23 @@ namespace plzma {
         return true;
     }
     
+    CMyComPtr<InStreamBase> InMultiStream::clone() {
+        Vector<SharedPtr<InStreamBase> > streams(_streams.count());
+        for (plzma_size_t i = 0, n = _streams.count(); i < n; i++) {
+            CMyComPtr<InStreamBase> stream = _streams.at(i)->clone();
+            if (!stream) {
+                return CMyComPtr<InStreamBase>();
+            }
+            streams.push(SharedPtr<InStreamBase>(stream.operator->()));
+        }
+        return CMyComPtr<InStreamBase>(new InMultiStream(static_cast<Vector<SharedPtr<InStreamBase> > &&>(streams)));
+    }
+    
+    InMultiStream::InMultiStream(Vector<SharedPtr<InStreamBase> > && streams) : InStreamBase(),
+        _streams(static_cast<Vector<SharedPtr<InStreamBase> > &&>(streams)) {
+        
+    }
+    
     InMultiStream::InMultiStream(InStreamArray && streams) {
         auto inStreams = static_cast<InStreamArray &&>(streams);
         if (inStreams.count() == 0) {
@@ -447,6 +800,273 @@ namespace plzma {
     
     }
     
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+    /// InReadAheadStream
+    STDMETHODIMP InReadAheadStream::Read(void * data, UInt32 size, UInt32 * processedSize) {
+        LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, 0)
+        if (size == 0) {
+            return S_OK;
+        }
+        uint8_t * dst = static_cast<uint8_t *>(data);
+        for (;;) {
+            UInt32 copied = 0;
+            {
+                const FailableLockGuard lock(_mutex);
+                RINOK(lock.res())
+                if (_stopped) {
+                    return S_FALSE;
+                }
+                while (_filled > 0 && copied < size) {
+                    const UInt32 available = _chunkSizes[_first] - _firstOffset;
+                    const UInt32 chunk = MyMin<UInt32>(available, size - copied);
+                    memcpy(dst + copied, static_cast<const uint8_t *>(_buffer) + static_cast<size_t>(_first) * _chunkSize + _firstOffset, chunk);
+                    copied += chunk;
+                    _firstOffset += chunk;
+                    if (_firstOffset == _chunkSizes[_first]) {
+                        _first = (_first + 1) % _chunksCount;
+                        _filled--;
+                        _firstOffset = 0;
+                    }
+                }
+                _position += copied;
+                if (copied == 0 && _finished) {
+                    return _result;
+                }
+            }
+            if (copied > 0) {
+                LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, copied)
+                _spaceEvent.Set();
+                return S_OK;
+            }
+            _dataEvent.Lock();
+        }
+    }
+    
+    STDMETHODIMP InReadAheadStream::Seek(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition) {
+        LIBPLZMA_CAST_VALUE_TO_PTR(newPosition, UInt64, 0)
+        {
+            const FailableLockGuard lock(_mutex);
+            RINOK(lock.res())
+            if (_stopped) {
+                return S_FALSE;
+            }
+            Int64 finalOffset;
+            switch (seekOrigin) {
+                case STREAM_SEEK_SET:
+                    finalOffset = offset;
+                    break;
+                case STREAM_SEEK_CUR:
+                    finalOffset = _position;
+                    finalOffset += offset;
+                    break;
+                case STREAM_SEEK_END:
+                    finalOffset = _size;
+                    finalOffset += offset;
+                    break;
+                default:
+                    finalOffset = -1;
+                    break;
+            }
+            if (finalOffset < 0) {
+                return S_FALSE;
+            }
+            const UInt64 position = static_cast<UInt64>(finalOffset);
+            LIBPLZMA_CAST_VALUE_TO_PTR(newPosition, UInt64, position)
+            if (position == _position) {
+                return S_OK;
+            }
+            if (position > _position && position < _readPosition) {
+                // skip the read ahead content, the rest of the ring is still valid
+                UInt64 skip = position - _position;
+                while (skip > 0) {
+                    const UInt32 chunk = static_cast<UInt32>(MyMin<UInt64>(_chunkSizes[_first] - _firstOffset, skip));
+                    skip -= chunk;
+                    _firstOffset += chunk;
+                    if (_firstOffset == _chunkSizes[_first]) {
+                        _first = (_first + 1) % _chunksCount;
+                        _filled--;
+                        _firstOffset = 0;
+                    }
+                }
+                _position = position;
+            } else {
+                _generation++;
+                _first = _filled = _firstOffset = 0;
+                _position = _readPosition = position;
+                _seekPending = true;
+                _finished = false;
+                _result = S_OK;
+            }
+        }
+        _spaceEvent.Set();
+        return S_OK;
+    }
+    
+    void InReadAheadStream::readChunks() {
+        for (;;) {
+            UInt32 index = 0, generation = 0;
+            UInt64 seekPosition = 0;
+            bool seek = false;
+            {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (_stopped) {
+                    return;
+                }
+                if (_finished || _filled == _chunksCount) {
+                    index = UINT32_MAX; // wait for the space, seek or stop
+                } else {
+                    index = (_first + _filled) % _chunksCount;
+                    generation = _generation;
+                    seek = _seekPending;
+                    seekPosition = _readPosition;
+                    _seekPending = false;
+                }
+            }
+            if (index == UINT32_MAX) {
+                _spaceEvent.Lock();
+                continue;
+            }
+            
+            HRESULT result = seek ? _stream->Seek(static_cast<Int64>(seekPosition), STREAM_SEEK_SET, nullptr) : S_OK;
+            uint8_t * dst = static_cast<uint8_t *>(_buffer) + static_cast<size_t>(index) * _chunkSize;
+            UInt32 size = 0;
+            while (result == S_OK && size < _chunkSize) {
+                UInt32 processed = 0;
+                result = _stream->Read(dst + size, _chunkSize - size, &processed);
+                if (processed == 0) {
+                    break;
+                }
+                size += processed;
+            }
+            
+            {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (_stopped) {
+                    return;
+                }
+                if (generation != _generation) {
+                    continue; // dropped by the seek
+                }
+                if (size > 0) {
+                    _chunkSizes[index] = size;
+                    _readPosition += size;
+                    _filled++;
+                }
+                if (result != S_OK || size < _chunkSize) {
+                    _finished = true;
+                    _result = result;
+                }
+            }
+            _dataEvent.Set();
+        }
+    }
+    
+    THREAD_FUNC_DECL InReadAheadStream::readThread(void * param) {
+        InReadAheadStream * stream = static_cast<InReadAheadStream *>(param);
+        try {
+            stream->readChunks();
+        } catch (...) {
+            try {
+                LIBPLZMA_LOCKGUARD(lock, stream->_mutex)
+                stream->_finished = true;
+                stream->_result = E_FAIL;
+            } catch (...) { }
+            stream->_dataEvent.Set();
+        }
+        return 0;
+    }
+    
+    void InReadAheadStream::stop() noexcept {
+        try {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            _stopped = true;
+        } catch (...) {
+            // do nothing
+        }
+        _spaceEvent.Set();
+        _dataEvent.Set();
+        if (_thread.IsCreated()) {
+            _thread.Wait_Close();
+        }
+    }
+    
+    bool InReadAheadStream::opened() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return !_stopped;
+    }
+    
+    void InReadAheadStream::open() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (!_stopped) {
+            return;
+        }
+        _stream->open();
+        UInt64 size = 0;
+        if (_stream->Seek(0, STREAM_SEEK_END, &size) != S_OK || _stream->Seek(0, STREAM_SEEK_SET, nullptr) != S_OK) {
+            _stream->close();
+            throw Exception(plzma_error_code_io, "Can't get the size of the read ahead in-stream.", __FILE__, __LINE__);
+        }
+        _buffer.resize(static_cast<size_t>(_chunkSize) * _chunksCount);
+        _size = size;
+        _position = _readPosition = 0;
+        _first = _filled = _firstOffset = 0;
+        _generation++;
+        _result = S_OK;
+        _seekPending = _finished = false;
+        _stopped = false;
+        if (_thread.Create(readThread, this) != 0) {
+            _stopped = true;
+            _stream->close();
+            throw Exception(plzma_error_code_internal, "Can't create read ahead thread.", __FILE__, __LINE__);
+        }
+    }
+    
+    void InReadAheadStream::close() {
+        stop();
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _stream->close();
+        _buffer.clear();
+    }
+    
+    bool InReadAheadStream::erase(const plzma_erase eraseType) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _stopped ? _stream->erase(eraseType) : false;
+    }
+    
+    CMyComPtr<InStreamBase> InReadAheadStream::clone() {
+        CMyComPtr<InStreamBase> stream = _stream->clone();
+        if (stream) {
+            return CMyComPtr<InStreamBase>(new InReadAheadStream(stream, _chunkSize, _chunksCount));
+        }
+        return CMyComPtr<InStreamBase>();
+    }
+    
+    InReadAheadStream::InReadAheadStream(const CMyComPtr<InStreamBase> & stream, const size_t chunkSize, const plzma_size_t chunksCount) : InStreamBase(),
+        _stream(stream),
+        _chunkSize(static_cast<UInt32>(chunkSize)),
+        _chunksCount(chunksCount) {
+            if (!_stream || chunkSize == 0 || chunkSize > UINT32_MAX || chunksCount == 0 ||
+                chunksCount > (SIZE_MAX / chunkSize)) {
+                Exception exception(plzma_error_code_invalid_arguments, "Can't instantiate read ahead in-stream.", __FILE__, __LINE__);
+                exception.setReason("The source stream is empty or the chunk size or the number of chunks is invalid.", nullptr);
+                throw exception;
+            }
+            _chunkSizes.ClearAndSetSize(_chunksCount);
+            if (_dataEvent.Create() != 0 || _spaceEvent.Create() != 0) {
+                throw Exception(plzma_error_code_internal, "Can't create read ahead in-stream events.", __FILE__, __LINE__);
+            }
+    }
+    
+    InReadAheadStream::~InReadAheadStream() noexcept {
+        stop();
+        if (_stream) {
+            try {
+                _stream->close();
+            } catch (...) { }
+        }
+    }
+#endif // !LIBPLZMA_THREAD_UNSAFE
+    
     SharedPtr<InStream> makeSharedInStream(const Path & path) {
         return SharedPtr<InStream>(new InFileStream(path));
     }
@@ -455,6 +1075,20 @@ namespace plzma {
         return SharedPtr<InStream>(new InFileStream(static_cast<Path &&>(path)));
     }
     
+    SharedPtr<InStream> makeSharedInStream(const Path & path, const plzma_in_stream_mode mode) {
+        if (mode == plzma_in_stream_mode_mmap) {
+            return SharedPtr<InStream>(new InMmapStream(path));
+        }
+        return SharedPtr<InStream>(new InFileStream(path));
+    }
+    
+    SharedPtr<InStream> makeSharedInStream(Path && path, const plzma_in_stream_mode mode) {
+        if (mode == plzma_in_stream_mode_mmap) {
+            return SharedPtr<InStream>(new InMmapStream(static_cast<Path &&>(path)));
+        }
+        return SharedPtr<InStream>(new InFileStream(static_cast<Path &&>(path)));
+    }
+    
     SharedPtr<InStream> makeSharedInStream(const void * LIBPLZMA_NONNULL memory, const size_t size) {
         return SharedPtr<InStream>(new InMemStream(memory, size));
     }
@@ -475,6 +1109,20 @@ namespace plzma {
         return SharedPtr<InStream>(new InMultiStream(static_cast<InStreamArray &&>(streams)));
     }
 
+    SharedPtr<InStream> makeSharedInStream(const SharedPtr<InStream> & stream, const size_t chunkSize, const plzma_size_t chunksCount) {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        if (!stream || chunkSize == 0 || chunksCount == 0) {
+            Exception exception(plzma_error_code_invalid_arguments, "Can't instantiate read ahead in-stream.", __FILE__, __LINE__);
+            exception.setReason("The source stream is empty or the chunk size or the number of chunks is invalid.", nullptr);
+            throw exception;
+        }
+        return stream; // no threads, reads the source stream directly
+#else
+        CMyComPtr<InStreamBase> baseStream(stream.cast<InStreamBase>().get());
+        return SharedPtr<InStream>(new InReadAheadStream(baseStream, chunkSize, chunksCount));
+#endif
+    }
+
 } // namespace plzma
 
 
@@ -498,6 +1146,13 @@ plzma_in_stream plzma_in_stream_create_with_pathm(plzma_path * LIBPLZMA_NONNULL
     LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
 }
 
+plzma_in_stream plzma_in_stream_create_with_path_mode(const plzma_path * LIBPLZMA_NONNULL path, const plzma_in_stream_mode mode) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_in_stream, path)
+    auto stream = makeSharedInStream(*static_cast<const Path *>(path->object), mode);
+    createdCObject.object = static_cast<void *>(stream.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
 plzma_in_stream plzma_in_stream_create_with_memory_copy(const void * LIBPLZMA_NONNULL memory,
                                                         const size_t size) {
     LIBPLZMA_C_BINDINGS_CREATE_OBJECT_TRY(plzma_in_stream)
@@ -533,6 +1188,16 @@ plzma_in_stream plzma_in_stream_create_with_stream_arraym(plzma_in_stream_array
     LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
 }
 
+plzma_in_stream plzma_in_stream_create_read_ahead(plzma_in_stream * LIBPLZMA_NONNULL stream,
+                                                  const size_t chunk_size,
+                                                  const plzma_size_t chunks_count) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_in_stream, stream)
+    SharedPtr<InStream> streamSPtr(static_cast<InStream *>(stream->object));
+    auto readAheadStream = makeSharedInStream(streamSPtr, chunk_size, chunks_count);
+    createdCObject.object = static_cast<void *>(readAheadStream.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
 bool plzma_in_stream_opened(plzma_in_stream * LIBPLZMA_NONNULL stream) {
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, false)
     return static_cast<InStream *>(stream->object)->opened();
@@ -40,6 +40,8 @@
 #include "CPP/Common/MyCom.h"
 #include "CPP/7zip/IStream.h"
 #include "CPP/7zip/Archive/Common/MultiStream.h"
+#include "CPP/Windows/Thread.h"
+#include "CPP/Windows/Synchronization.h"
 
 namespace plzma {
     
@@ -62,6 +64,10 @@ namespace plzma {
         virtual void open() = 0;
         virtual void close() = 0;
         
+        /// @brief Creates a new, closed stream with the same content and an independent position.
+        /// @return The stream or empty pointer if the content can't be shared, i.e. user-defined callbacks.
+        virtual CMyComPtr<InStreamBase> clone();
+        
         InStreamBase();
         virtual ~InStreamBase() noexcept { }
     };
@@ -76,6 +82,18 @@ namespace plzma {
     private:
         Path _path;
         FILE * _file = nullptr;
+#if defined(LIBPLZMA_POSIX)
+        CMyComPtr<InFileStream> _owner; // the owner of the shared file of a cloned stream
+        UInt64 _offset = 0;             // own position, the file is read via 'pread'
+        UInt32 _openedClones = 0;       // the clones reading the file of the owner
+        bool _sharedFile = false;       // the clone reads the file of the owner
+        bool _closePending = false;     // the owner is closed, the file is closed after the last clone
+        
+        void closeFile() noexcept;
+        void closeClone();
+        
+        InFileStream(const CMyComPtr<InFileStream> & owner);
+#endif
         
         LIBPLZMA_NON_COPYABLE_NON_MOVABLE(InFileStream)
         
@@ -90,6 +108,7 @@ namespace plzma {
         
         virtual bool opened() const final;
         virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final;
+        virtual CMyComPtr<InStreamBase> clone() final;
         
         const Path & path() const noexcept;
         
@@ -98,8 +117,44 @@ namespace plzma {
         virtual ~InFileStream() noexcept;
     };
     
+    class InMmapStream final : public InStreamBase {
+    private:
+        Path _path;
+        CMyComPtr<InFileStream> _fileStream; // fallback in case if the file can't be mapped
+        void * _memory = nullptr;
+        UInt64 _size = 0;
+        UInt64 _offset = 0;
+        UInt64 _readOffset = 0; // the end of the last read
+        UInt32 _sequentialReads = 0;
+        bool _sequentialAdvised = false;
+        bool _opened = false;
+        
+        void advise(const UInt64 offset, const UInt64 size, const int advice) noexcept;
+        void unmap() noexcept;
+        
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(InMmapStream)
+        
+    public:
+        MY_UNKNOWN_IMP1(IInStream)
+        
+        STDMETHOD(Seek)(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition);
+        STDMETHOD(Read)(void * data, UInt32 size, UInt32 * processedSize);
+        
+        virtual void open() final;
+        virtual void close() final;
+        
+        virtual bool opened() const final;
+        virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final;
+        virtual CMyComPtr<InStreamBase> clone() final;
+        
+        InMmapStream(const Path & path);
+        InMmapStream(Path && path);
+        virtual ~InMmapStream() noexcept;
+    };
+    
     class InMemStream final : public InStreamBase {
     private:
+        CMyComPtr<InStreamBase> _owner; // the owner of the shared memory of a cloned stream
         void * _memory = nullptr;
         plzma_free_callback _freeCallback = nullptr;
         UInt64 _size = 0;
@@ -119,9 +174,11 @@ namespace plzma {
         
         virtual bool opened() const final;
         virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final;
+        virtual CMyComPtr<InStreamBase> clone() final;
         
         InMemStream(const void * memory, const size_t size);
         InMemStream(void * memory, const size_t size, plzma_free_callback freeCallback);
+        InMemStream(const CMyComPtr<InStreamBase> & owner, void * memory, const UInt64 size);
         
         virtual ~InMemStream() noexcept;
     };
@@ -177,10 +234,64 @@ namespace plzma {
         
         virtual bool opened() const final;
         virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final;
+        virtual CMyComPtr<InStreamBase> clone() final;
         
         InMultiStream(InStreamArray && streams);
+        InMultiStream(Vector<SharedPtr<InStreamBase> > && streams);
         virtual ~InMultiStream() noexcept;
     };
+    
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+    /// @brief Reads the content of the source stream ahead in a separate thread.
+    ///
+    /// The thread fills the ring of chunks while the reader consumes them, so the reading of the source stream
+    /// overlaps with the decoding. The seek outside of the read ahead content drops the ring and the thread
+    /// continues from the new position.
+    class InReadAheadStream final : public InStreamBase {
+    private:
+        CMyComPtr<InStreamBase> _stream;
+        NWindows::CThread _thread;
+        NWindows::NSynchronization::CAutoResetEvent _dataEvent;  // signaled after the chunk is read or the reading finished
+        NWindows::NSynchronization::CAutoResetEvent _spaceEvent; // signaled after the chunk is consumed, seek or stop
+        RawHeapMemory _buffer;
+        CRecordVector<UInt32> _chunkSizes;
+        UInt64 _size = 0;           // the size of the source content
+        UInt64 _position = 0;       // the position of the reader
+        UInt64 _readPosition = 0;   // the position of the source stream after the last filled chunk
+        UInt32 _chunkSize = 0;
+        UInt32 _chunksCount = 0;
+        UInt32 _first = 0;          // the index of the first filled chunk
+        UInt32 _filled = 0;         // the number of filled chunks
+        UInt32 _firstOffset = 0;    // the consumed bytes of the first filled chunk
+        UInt32 _generation = 0;     // incremented by the seek, the chunk read for the previous generation is dropped
+        HRESULT _result = S_OK;     // the result of reading the source stream
+        bool _seekPending = false;  // the source stream must be moved to the '_readPosition' before the next chunk
+        bool _finished = false;     // the end of the source content or the reading error
+        bool _stopped = true;
+        
+        static THREAD_FUNC_DECL readThread(void * param);
+        void readChunks();
+        void stop() noexcept;
+        
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(InReadAheadStream)
+        
+    public:
+        MY_UNKNOWN_IMP1(IInStream)
+        
+        STDMETHOD(Seek)(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition);
+        STDMETHOD(Read)(void * data, UInt32 size, UInt32 * processedSize);
+        
+        virtual void open() final;
+        virtual void close() final;
+        
+        virtual bool opened() const final;
+        virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final;
+        virtual CMyComPtr<InStreamBase> clone() final;
+        
+        InReadAheadStream(const CMyComPtr<InStreamBase> & stream, const size_t chunkSize, const plzma_size_t chunksCount);
+        virtual ~InReadAheadStream() noexcept;
+    };
+#endif
 
 } // namespace plzma
 
@@ -0,0 +1,127 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+
+#include <cstddef>
+#include <cstring>
+
+#include "plzma_index_cache.hpp"
+#include "plzma_mutex.hpp"
+
+#include "CPP/Common/MyVector.h"
+
+namespace plzma {
+    
+    struct IndexCacheEntry final {
+        IndexCacheKey key;
+        NArchive::N7z::CDbEx db;
+        
+        IndexCacheEntry(const IndexCacheKey & k) : key(k) { }
+    };
+    
+    struct IndexCacheStorage final {
+        LIBPLZMA_MUTEX(mutex)
+        CRecordVector<IndexCacheEntry *> entries; // the most recently used first
+        plzma_size_t capacity = 0;
+        
+        void evict(const plzma_size_t count) {
+            while (entries.Size() > count) {
+                delete entries.Back();
+                entries.DeleteBack();
+            }
+        }
+        
+        ~IndexCacheStorage() {
+            evict(0);
+        }
+    };
+    
+    static IndexCacheStorage _indexCache;
+    
+    bool IndexCacheKey::operator == (const IndexCacheKey & key) const noexcept {
+        return (startPosition == key.startPosition &&
+                fileEndPosition == key.fileEndPosition &&
+                memcmp(header, key.header, NArchive::N7z::kHeaderSize) == 0);
+    }
+    
+    IndexCacheKey::IndexCacheKey(const NArchive::N7z::CInArchive & archive) noexcept :
+        startPosition(archive.GetStartPosition()),
+        fileEndPosition(archive.GetFileEndPosition()) {
+            memcpy(header, archive.GetStartHeader(), NArchive::N7z::kHeaderSize);
+    }
+    
+    bool IndexCache::find(const IndexCacheKey & key, NArchive::N7z::CDbEx & db) {
+        LIBPLZMA_LOCKGUARD(lock, _indexCache.mutex)
+        for (unsigned i = 0; i < _indexCache.entries.Size(); i++) {
+            IndexCacheEntry * entry = _indexCache.entries[i];
+            if (entry->key == key) {
+                if (i > 0) {
+                    _indexCache.entries.Delete(i);
+                    _indexCache.entries.Insert(0, entry);
+                }
+                db.CopyFrom(entry->db);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void IndexCache::add(const IndexCacheKey & key, const NArchive::N7z::CDbEx & db) {
+        LIBPLZMA_LOCKGUARD(lock, _indexCache.mutex)
+        const plzma_size_t capacity = _indexCache.capacity;
+        if (capacity == 0) {
+            return;
+        }
+        for (unsigned i = 0; i < _indexCache.entries.Size(); i++) {
+            if (_indexCache.entries[i]->key == key) {
+                return; // added by the other decoder
+            }
+        }
+        IndexCacheEntry * entry = new IndexCacheEntry(key);
+        try {
+            entry->db.CopyFrom(db);
+            _indexCache.entries.Insert(0, entry);
+        } catch (...) {
+            delete entry;
+            throw;
+        }
+        _indexCache.evict(capacity);
+    }
+    
+    plzma_size_t IndexCache::capacity() {
+        LIBPLZMA_LOCKGUARD(lock, _indexCache.mutex)
+        return _indexCache.capacity;
+    }
+    
+    void IndexCache::setCapacity(const plzma_size_t capacity) {
+        LIBPLZMA_LOCKGUARD(lock, _indexCache.mutex)
+        _indexCache.capacity = capacity;
+        _indexCache.evict(capacity);
+    }
+    
+} // namespace plzma
@@ -0,0 +1,78 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+
+#ifndef __PLZMA_INDEX_CACHE_HPP__
+#define __PLZMA_INDEX_CACHE_HPP__ 1
+
+#include <cstddef>
+
+#include "../libplzma.hpp"
+#include "plzma_private.hpp"
+
+#include "CPP/Common/Common.h"
+#include "CPP/Common/MyWindows.h"
+#include "CPP/7zip/Archive/7z/7zIn.h"
+
+namespace plzma {
+    
+    /// @brief The key of the parsed 7z archive database.
+    ///
+    /// The signature header contains the CRC of the next header, which contains the CRC of the packed header,
+    /// so the header content is identified without reading it.
+    struct IndexCacheKey final {
+        Byte header[NArchive::N7z::kHeaderSize];
+        UInt64 startPosition = 0;
+        UInt64 fileEndPosition = 0;
+        
+        bool operator == (const IndexCacheKey & key) const noexcept;
+        
+        IndexCacheKey(const NArchive::N7z::CInArchive & archive) noexcept;
+    };
+    
+    /// @brief The process-wide LRU cache of the parsed 7z archive databases.
+    ///
+    /// Skips reading and decoding the header of the archive opened again.
+    /// Disabled by default, see \a plzma_set_index_cache_capacity.
+    /// @note Thread-safe.
+    class IndexCache final {
+    public:
+        /// @brief Copies the cached database of the archive.
+        /// @return \a true if the database found, otherwise \a false.
+        static bool find(const IndexCacheKey & key, NArchive::N7z::CDbEx & db);
+        
+        /// @brief Copies the database of the archive to the cache and evicts the least recently used databases.
+        static void add(const IndexCacheKey & key, const NArchive::N7z::CDbEx & db);
+        
+        static plzma_size_t capacity();
+        static void setCapacity(const plzma_size_t capacity);
+    };
+    
+} // namespace plzma
+
+#endif // !__PLZMA_INDEX_CACHE_HPP__
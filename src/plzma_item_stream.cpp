@@ -0,0 +1,363 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <cstddef>
+
+#include "plzma_item_stream.hpp"
+#include "plzma_common.hpp"
+#include "plzma_c_bindings_private.hpp"
+
+#include "CPP/Common/Defs.h"
+
+namespace plzma {
+
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+    /// ItemStreamPipe
+    // The size of the buffer between the decode thread and the reader.
+    static const size_t kItemStreamPipeCapacity = 1 << 20;
+
+    STDMETHODIMP ItemStreamPipe::Write(const void * data, UInt32 size, UInt32 * processedSize) {
+        LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, 0)
+        const uint8_t * src = static_cast<const uint8_t *>(data);
+        UInt32 written = 0;
+        while (written < size) {
+            size_t copied = 0;
+            {
+                const FailableLockGuard lock(_mutex);
+                RINOK(lock.res())
+                if (_cancelled) {
+                    return E_ABORT;
+                }
+                while (_count < _capacity && written < size) {
+                    const size_t end = (_start + _count) % _capacity;
+                    const size_t chunk = MyMin<size_t>(_capacity - MyMax<size_t>(end, _count), size - written);
+                    memcpy(static_cast<uint8_t *>(_buffer) + end, src + written, chunk);
+                    _count += chunk;
+                    written += static_cast<UInt32>(chunk);
+                    copied += chunk;
+                }
+            }
+            if (copied > 0) {
+                LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, written)
+                _dataEvent.Set();
+            } else {
+                _spaceEvent.Lock();
+            }
+        }
+        return S_OK;
+    }
+
+    STDMETHODIMP ItemStreamPipe::Seek(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition) {
+        LIBPLZMA_CAST_VALUE_TO_PTR(newPosition, UInt64, 0)
+        return E_NOTIMPL;
+    }
+
+    STDMETHODIMP ItemStreamPipe::SetSize(UInt64 newSize) {
+        return E_NOTIMPL;
+    }
+
+    size_t ItemStreamPipe::read(void * buffer, const size_t size) {
+        uint8_t * dst = static_cast<uint8_t *>(buffer);
+        while (size > 0) {
+            size_t copied = 0;
+            {
+                LIBPLZMA_LOCKGUARD(lock, _mutex)
+                if (_cancelled) {
+                    return 0;
+                }
+                while (_count > 0 && copied < size) {
+                    const size_t chunk = MyMin<size_t>(MyMin<size_t>(_capacity - _start, _count), size - copied);
+                    memcpy(dst + copied, static_cast<const uint8_t *>(_buffer) + _start, chunk);
+                    _start = (_start + chunk) % _capacity;
+                    _count -= chunk;
+                    copied += chunk;
+                }
+                if (copied == 0 && _finished) {
+                    if (_exception) {
+                        Exception localException(static_cast<Exception &&>(*_exception));
+                        delete _exception;
+                        _exception = nullptr;
+                        throw localException;
+                    }
+                    return 0;
+                }
+            }
+            if (copied > 0) {
+                _spaceEvent.Set();
+                return copied;
+            }
+            _dataEvent.Lock();
+        }
+        return 0;
+    }
+
+    void ItemStreamPipe::finish(Exception * exception) noexcept {
+        try {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            _finished = true;
+            delete _exception;
+            _exception = exception;
+        } catch (...) {
+            delete exception;
+        }
+        _dataEvent.Set();
+    }
+
+    void ItemStreamPipe::cancel() noexcept {
+        try {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            _cancelled = true;
+        } catch (...) {
+            // do nothing
+        }
+        _spaceEvent.Set();
+        _dataEvent.Set();
+    }
+
+    bool ItemStreamPipe::opened() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _opened;
+    }
+
+    void ItemStreamPipe::open() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _opened = true;
+    }
+
+    void ItemStreamPipe::close() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _opened = false;
+    }
+
+    ItemStreamPipe::ItemStreamPipe(const size_t capacity) : OutStreamBase(),
+        _buffer(capacity),
+        _capacity(capacity) {
+            if (_dataEvent.Create() != 0 || _spaceEvent.Create() != 0) {
+                throw Exception(plzma_error_code_internal, "Can't create item stream events.", __FILE__, __LINE__);
+            }
+    }
+
+    ItemStreamPipe::~ItemStreamPipe() noexcept {
+        delete _exception;
+    }
+#endif // !LIBPLZMA_THREAD_UNSAFE
+
+    /// ItemStreamImpl
+    void ItemStreamImpl::retain() {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        LIBPLZMA_RETAIN_IMPL(__m_RefCount)
+#else
+        LIBPLZMA_RETAIN_LOCKED_IMPL(__m_RefCount, _mutex)
+#endif
+    }
+
+    void ItemStreamImpl::release() {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        LIBPLZMA_RELEASE_IMPL(__m_RefCount)
+#else
+        LIBPLZMA_RELEASE_LOCKED_IMPL(__m_RefCount, _mutex)
+#endif
+    }
+
+    SharedPtr<Item> ItemStreamImpl::item() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _item;
+    }
+
+    size_t ItemStreamImpl::read(void * LIBPLZMA_NONNULL buffer, const size_t size) {
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        CMyComPtr<ItemStreamPipe> pipe;
+        {
+            LIBPLZMA_LOCKGUARD(lock, _mutex)
+            pipe = _pipe;
+        }
+        if (pipe) {
+            return pipe->read(buffer, size); // blocking, without own lock
+        }
+#endif
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_closed || size == 0) {
+            return 0;
+        } else if (_archiveStream) {
+            UInt32 processedSize = 0;
+            const UInt32 sizeToRead = static_cast<UInt32>(MyMin<size_t>(size, static_cast<size_t>(1) << 30));
+            const HRESULT result = _archiveStream->Read(buffer, sizeToRead, &processedSize);
+            if (result != S_OK) {
+                throw Exception(plzma_error_code_internal, "Can't read item stream.", __FILE__, __LINE__);
+            }
+            return static_cast<size_t>(processedSize);
+        }
+        const size_t sizeToRead = MyMin<size_t>(size, _contentSize - _contentOffset);
+        if (sizeToRead > 0) {
+            memcpy(buffer, static_cast<const uint8_t *>(_content) + _contentOffset, sizeToRead);
+            _contentOffset += sizeToRead;
+        }
+        return sizeToRead;
+    }
+
+    void ItemStreamImpl::close() {
+        LIBPLZMA_UNIQUE_LOCK(lock, _mutex)
+        if (_closed) {
+            return;
+        }
+        _closed = true;
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        if (_pipe) {
+            _pipe->cancel();
+            _extractCallback->abort();
+            LIBPLZMA_UNIQUE_LOCK_UNLOCK(lock)
+            if (_thread.IsCreated()) {
+                _thread.Wait_Close();
+            }
+            LIBPLZMA_UNIQUE_LOCK_LOCK(lock)
+        }
+#endif
+        _archiveStream.Release();
+        _archive.Release();
+        if (_stream) {
+            _stream->close();
+        }
+        _content.clear();
+        _contentSize = _contentOffset = 0;
+    }
+
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+    THREAD_FUNC_DECL ItemStreamImpl::decodeThread(void * param) {
+        ItemStreamImpl * itemStream = static_cast<ItemStreamImpl *>(param);
+        Exception * exception = nullptr;
+        try {
+            itemStream->_extractCallback->process(NArchive::NExtract::NAskMode::kExtract, itemStream->_itemsMap);
+        } catch (const Exception & e) {
+            exception = e.moveToHeapCopy();
+        }
+#if defined(LIBPLZMA_HAVE_STD)
+        catch (const std::exception & e) {
+            exception = Exception::create(plzma_error_code_internal, e.what(), __FILE__, __LINE__);
+        }
+#endif
+        catch (...) {
+            exception = Exception::create(plzma_error_code_unknown, "Unknown extract error.", __FILE__, __LINE__);
+        }
+        itemStream->_pipe->finish(exception);
+        return 0;
+    }
+#endif
+
+    ItemStreamImpl::ItemStreamImpl(const SharedPtr<Item> & item,
+                                   const CMyComPtr<InStreamBase> & stream,
+                                   const CMyComPtr<IInArchive> & archive,
+#if !defined(LIBPLZMA_NO_CRYPTO)
+                                   const String & password,
+#endif
+                                   const plzma_file_type type) : CMyUnknownImp(),
+        _item(item),
+        _stream(stream),
+        _archive(archive) {
+            CMyComPtr<IInArchiveGetStream> getStream;
+            _archive->QueryInterface(IID_IInArchiveGetStream, reinterpret_cast<void**>(&getStream));
+            if (getStream) {
+                ISequentialInStream * archiveStream = nullptr;
+                if (getStream->GetStream(static_cast<UInt32>(_item->index()), &archiveStream) == S_OK && archiveStream) {
+                    _archiveStream.Attach(archiveStream);
+                    return;
+                }
+            }
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+            throw Exception(plzma_error_code_internal, "Can't read item stream without decode thread.", __FILE__, __LINE__);
+#else
+            _pipe = CMyComPtr<ItemStreamPipe>(new ItemStreamPipe(kItemStreamPipeCapacity));
+            _itemsMap = makeShared<ItemOutStreamArray>(1);
+            _itemsMap->push(ItemOutStreamArray::ElementType(_item, SharedPtr<OutStream>(_pipe.operator->())));
+#  if defined(LIBPLZMA_NO_PROGRESS)
+#    if defined(LIBPLZMA_NO_CRYPTO)
+            _extractCallback = CMyComPtr<ExtractCallback>(new ExtractCallback(_archive, type));
+#    else
+            _extractCallback = CMyComPtr<ExtractCallback>(new ExtractCallback(_archive, password, type));
+#    endif
+#  else
+            plzma_context context;
+            context.context = nullptr;
+            context.deinitializer = nullptr;
+#    if defined(LIBPLZMA_NO_CRYPTO)
+            _extractCallback = CMyComPtr<ExtractCallback>(new ExtractCallback(_archive, makeShared<Progress>(context), type));
+#    else
+            _extractCallback = CMyComPtr<ExtractCallback>(new ExtractCallback(_archive, password, makeShared<Progress>(context), type));
+#    endif
+#  endif
+            if (_thread.Create(decodeThread, this) != 0) {
+                throw Exception(plzma_error_code_internal, "Can't create item decode thread.", __FILE__, __LINE__);
+            }
+#endif
+    }
+
+    ItemStreamImpl::ItemStreamImpl(const SharedPtr<Item> & item, RawHeapMemorySize && content) : CMyUnknownImp(),
+        _item(item),
+        _content(static_cast<RawHeapMemory &&>(content.first)),
+        _contentSize(content.second) {
+
+    }
+
+    ItemStreamImpl::~ItemStreamImpl() {
+        close();
+    }
+
+} // namespace plzma
+
+
+#include "plzma_c_bindings_private.hpp"
+
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+
+using namespace plzma;
+
+size_t plzma_item_stream_read(plzma_item_stream * LIBPLZMA_NONNULL stream, void * LIBPLZMA_NONNULL buffer, const size_t size) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, 0)
+    return static_cast<ItemStream *>(stream->object)->read(buffer, size);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(stream, 0)
+}
+
+void plzma_item_stream_close(plzma_item_stream * LIBPLZMA_NONNULL stream) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(stream)
+    static_cast<ItemStream *>(stream->object)->close();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(stream)
+}
+
+plzma_item plzma_item_stream_item(plzma_item_stream * LIBPLZMA_NONNULL stream) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_item, stream)
+    auto item = static_cast<ItemStream *>(stream->object)->item();
+    createdCObject.object = static_cast<void *>(item.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
+void plzma_item_stream_release(plzma_item_stream * LIBPLZMA_NONNULL stream) {
+    plzma_object_exception_release(stream);
+    SharedPtr<ItemStream> streamSPtr;
+    streamSPtr.assign(static_cast<ItemStream *>(stream->object));
+    stream->object = nullptr;
+}
+
+#endif // !LIBPLZMA_NO_C_BINDINGS
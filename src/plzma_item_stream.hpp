@@ -0,0 +1,151 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#ifndef __PLZMA_ITEM_STREAM_HPP__
+#define __PLZMA_ITEM_STREAM_HPP__ 1
+
+#include <cstddef>
+
+#include "../libplzma.hpp"
+#include "plzma_private.hpp"
+#include "plzma_in_streams.hpp"
+#include "plzma_out_streams.hpp"
+#include "plzma_extract_callback.hpp"
+#include "plzma_mutex.hpp"
+
+#include "CPP/Common/Common.h"
+#include "CPP/Common/MyWindows.h"
+#include "CPP/Common/MyCom.h"
+#include "CPP/Windows/Thread.h"
+#include "CPP/Windows/Synchronization.h"
+#include "CPP/7zip/Archive/IArchive.h"
+
+namespace plzma {
+
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+    /// @brief The bounded buffer between the decode thread(writer) and the reader of the item stream.
+    class ItemStreamPipe final : public OutStreamBase {
+    private:
+        NWindows::NSynchronization::CAutoResetEvent _dataEvent;  // signaled after write or finish
+        NWindows::NSynchronization::CAutoResetEvent _spaceEvent; // signaled after read or cancel
+        RawHeapMemory _buffer;
+        Exception * _exception = nullptr;
+        size_t _capacity = 0;
+        size_t _start = 0;
+        size_t _count = 0;
+        bool _opened = false;
+        bool _finished = false;
+        bool _cancelled = false;
+
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(ItemStreamPipe)
+
+    public:
+        MY_UNKNOWN_IMP1(IOutStream)
+
+        STDMETHOD(Write)(const void * data, UInt32 size, UInt32 * processedSize);
+        STDMETHOD(Seek)(Int64 offset, UInt32 seekOrigin, UInt64 * newPosition);
+        STDMETHOD(SetSize)(UInt64 newSize);
+
+        virtual void open() final;
+        virtual void close() final;
+
+        virtual bool opened() const final;
+        virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final { return false; }
+        virtual RawHeapMemorySize copyContent() const final { return RawHeapMemorySize(RawHeapMemory(), 0); }
+        virtual RawHeapMemorySize takeContent() final { return RawHeapMemorySize(RawHeapMemory(), 0); }
+        virtual RawMemoryView contentView() const final { return RawMemoryView(nullptr, 0); }
+        virtual void reserve(const uint64_t size) final { }
+
+        /// @brief Waits for the decoded data.
+        /// @return The number of bytes read or \a 0 if the writer finished or the pipe was cancelled.
+        /// @exception The writer's exception, reported once.
+        size_t read(void * buffer, const size_t size);
+
+        /// @brief The writer finished, wakes up the reader.
+        /// @param exception The optional heap exception, the ownership is transferred to the pipe.
+        void finish(Exception * exception) noexcept;
+
+        /// @brief The reader no longer reads, wakes up the writer.
+        void cancel() noexcept;
+
+        ItemStreamPipe(const size_t capacity);
+        virtual ~ItemStreamPipe() noexcept;
+    };
+#endif
+
+    class ItemStreamImpl final : public ItemStream, public CMyUnknownImp {
+    private:
+        friend struct SharedPtr<ItemStreamImpl>;
+        LIBPLZMA_MUTEX(mutable _mutex)
+        SharedPtr<Item> _item;
+        CMyComPtr<InStreamBase> _stream;
+        CMyComPtr<IInArchive> _archive;
+        CMyComPtr<ISequentialInStream> _archiveStream; // provided by the 'IInArchiveGetStream'
+        RawHeapMemory _content;
+        size_t _contentSize = 0;
+        size_t _contentOffset = 0;
+#if !defined(LIBPLZMA_THREAD_UNSAFE)
+        CMyComPtr<ItemStreamPipe> _pipe;
+        CMyComPtr<ExtractCallback> _extractCallback;
+        SharedPtr<ItemOutStreamArray> _itemsMap;
+        NWindows::CThread _thread;
+
+        static THREAD_FUNC_DECL decodeThread(void * param);
+#endif
+        bool _closed = false;
+
+        virtual void retain() override final;
+        virtual void release() override final;
+
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(ItemStreamImpl)
+
+    public:
+        MY_ADDREF_RELEASE
+
+        virtual SharedPtr<Item> item() const override final;
+        virtual size_t read(void * LIBPLZMA_NONNULL buffer, const size_t size) override final;
+        virtual void close() override final;
+
+        /// @brief Reads the item from the archive opened with own copy of the input stream.
+        ///
+        /// Uses the archive's \a IInArchiveGetStream if available, otherwise decodes the item in a separate thread.
+        ItemStreamImpl(const SharedPtr<Item> & item,
+                       const CMyComPtr<InStreamBase> & stream,
+                       const CMyComPtr<IInArchive> & archive,
+#if !defined(LIBPLZMA_NO_CRYPTO)
+                       const String & password,
+#endif
+                       const plzma_file_type type);
+
+        /// @brief Reads the already extracted content of the item.
+        ItemStreamImpl(const SharedPtr<Item> & item, RawHeapMemorySize && content);
+        virtual ~ItemStreamImpl();
+    };
+
+} // namespace plzma
+
+#endif // !__PLZMA_ITEM_STREAM_HPP__
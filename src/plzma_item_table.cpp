@@ -0,0 +1,191 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <cstddef>
+
+#include "../libplzma.hpp"
+#include "plzma_private.hpp"
+#include "plzma_common.hpp"
+#include "plzma_item_table.hpp"
+
+namespace plzma {
+    
+    plzma_size_t ItemTable::count() const noexcept {
+        return _count;
+    }
+    
+    const char * LIBPLZMA_NONNULL ItemTable::pathUtf8(const plzma_size_t index, size_t * LIBPLZMA_NULLABLE length) const noexcept {
+        if (index < _count) {
+            const size_t * offsets = static_cast<const size_t *>(_pathOffsets);
+            LIBPLZMA_SET_VALUE_TO_PTR(length, offsets[index + 1] - offsets[index] - 1)
+            return static_cast<const char *>(_paths) + offsets[index];
+        }
+        LIBPLZMA_SET_VALUE_TO_PTR(length, 0)
+        return plzma_empty_cstring;
+    }
+    
+    Path ItemTable::path(const plzma_size_t index) const {
+        return Path(pathUtf8(index));
+    }
+    
+    uint64_t ItemTable::size(const plzma_size_t index) const noexcept {
+        return (index < _count) ? static_cast<const uint64_t *>(_sizes)[index] : 0;
+    }
+    
+    uint64_t ItemTable::packSize(const plzma_size_t index) const noexcept {
+        return (index < _count) ? static_cast<const uint64_t *>(_packSizes)[index] : 0;
+    }
+    
+    uint32_t ItemTable::crc32(const plzma_size_t index) const noexcept {
+        return (index < _count) ? static_cast<const uint32_t *>(_crcs)[index] : 0;
+    }
+    
+    time_t ItemTable::creationTime(const plzma_size_t index) const noexcept {
+        return (index < _count) ? static_cast<const time_t *>(_times)[index * 3] : 0;
+    }
+    
+    time_t ItemTable::accessTime(const plzma_size_t index) const noexcept {
+        return (index < _count) ? static_cast<const time_t *>(_times)[index * 3 + 1] : 0;
+    }
+    
+    time_t ItemTable::modificationTime(const plzma_size_t index) const noexcept {
+        return (index < _count) ? static_cast<const time_t *>(_times)[index * 3 + 2] : 0;
+    }
+    
+    bool ItemTable::encrypted(const plzma_size_t index) const noexcept {
+        return (index < _count) ? ((static_cast<const uint8_t *>(_flags)[index] & ItemTableFlagEncrypted) != 0) : false;
+    }
+    
+    bool ItemTable::isDir(const plzma_size_t index) const noexcept {
+        return (index < _count) ? ((static_cast<const uint8_t *>(_flags)[index] & ItemTableFlagDir) != 0) : false;
+    }
+    
+    SharedPtr<Item> ItemTable::itemAt(const plzma_size_t index) const {
+        if (index < _count) {
+            auto item = makeShared<Item>(static_cast<Path &&>(path(index)), index);
+            item->setSize(size(index));
+            item->setPackSize(packSize(index));
+            item->setCrc32(crc32(index));
+            item->setCreationTime(creationTime(index));
+            item->setAccessTime(accessTime(index));
+            item->setModificationTime(modificationTime(index));
+            item->setEncrypted(encrypted(index));
+            item->setIsDir(isDir(index));
+            return item;
+        }
+        return SharedPtr<Item>();
+    }
+    
+    void ItemTable::retain() noexcept {
+        LIBPLZMA_RETAIN_IMPL(_referenceCounter)
+    }
+    
+    void ItemTable::release() noexcept {
+        LIBPLZMA_RELEASE_IMPL(_referenceCounter)
+    }
+    
+    ItemTable::ItemTable(const plzma_size_t count) :
+        _sizes(sizeof(uint64_t) * count, plzma_erase_zero),
+        _packSizes(sizeof(uint64_t) * count, plzma_erase_zero),
+        _times(sizeof(time_t) * 3 * count, plzma_erase_zero),
+        _crcs(sizeof(uint32_t) * count, plzma_erase_zero),
+        _flags(sizeof(uint8_t) * count, plzma_erase_zero),
+        _pathOffsets(sizeof(size_t) * (static_cast<size_t>(count) + 1), plzma_erase_zero),
+        _count(count) {
+            
+    }
+    
+} // namespace plzma
+
+
+#include "plzma_c_bindings_private.hpp"
+
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+
+using namespace plzma;
+
+plzma_size_t plzma_item_table_count(const plzma_item_table * LIBPLZMA_NONNULL table) {
+    return table->exception ? 0 : static_cast<const ItemTable *>(table->object)->count();
+}
+
+const char * LIBPLZMA_NULLABLE plzma_item_table_path_utf8(const plzma_item_table * LIBPLZMA_NONNULL table,
+                                                          const plzma_size_t index,
+                                                          size_t * LIBPLZMA_NULLABLE length) {
+    if (table->exception) {
+        LIBPLZMA_SET_VALUE_TO_PTR(length, 0)
+        return nullptr;
+    }
+    return static_cast<const ItemTable *>(table->object)->pathUtf8(index, length);
+}
+
+uint64_t plzma_item_table_size(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    return table->exception ? 0 : static_cast<const ItemTable *>(table->object)->size(index);
+}
+
+uint64_t plzma_item_table_pack_size(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    return table->exception ? 0 : static_cast<const ItemTable *>(table->object)->packSize(index);
+}
+
+uint32_t plzma_item_table_crc32(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    return table->exception ? 0 : static_cast<const ItemTable *>(table->object)->crc32(index);
+}
+
+time_t plzma_item_table_creation_time(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    return table->exception ? 0 : static_cast<const ItemTable *>(table->object)->creationTime(index);
+}
+
+time_t plzma_item_table_access_time(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    return table->exception ? 0 : static_cast<const ItemTable *>(table->object)->accessTime(index);
+}
+
+time_t plzma_item_table_modification_time(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    return table->exception ? 0 : static_cast<const ItemTable *>(table->object)->modificationTime(index);
+}
+
+bool plzma_item_table_encrypted(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    return table->exception ? false : static_cast<const ItemTable *>(table->object)->encrypted(index);
+}
+
+bool plzma_item_table_is_dir(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    return table->exception ? false : static_cast<const ItemTable *>(table->object)->isDir(index);
+}
+
+plzma_item plzma_item_table_item_at(const plzma_item_table * LIBPLZMA_NONNULL table, const plzma_size_t index) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_FROM_TRY(plzma_item, table)
+    auto item = static_cast<const ItemTable *>(table->object)->itemAt(index);
+    createdCObject.object = static_cast<void *>(item.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
+void plzma_item_table_release(plzma_item_table * LIBPLZMA_NONNULL table) {
+    plzma_object_exception_release(table);
+    SharedPtr<ItemTable> tableSPtr;
+    tableSPtr.assign(static_cast<ItemTable *>(table->object));
+    table->object = nullptr;
+}
+
+#endif // !LIBPLZMA_NO_C_BINDINGS
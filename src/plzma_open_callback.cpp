@@ -26,11 +26,20 @@
 
 
 #include <cstddef>
+#include <cstring>
 
 #include "plzma_open_callback.hpp"
+#include "plzma_item_table.hpp"
 #include "plzma_common.hpp"
+#include "plzma_path_utils.hpp"
+
+#include "C/CpuArch.h"
 
 namespace plzma {
+
+namespace OpenCallbackConvertUTF {
+#include "plzma_convert_utf.hpp"
+} // namespace OpenCallbackConvertUTF
     
     STDMETHODIMP OpenCallback::SetTotal(const UInt64 * files, const UInt64 * bytes) {
         return S_OK; // unused
@@ -169,6 +178,200 @@ namespace plzma {
         return items;
     }
     
+    void OpenCallback::fillPaths(RawHeapMemory & paths, size_t & pathsCapacity, RawHeapMemory & pathOffsets) {
+        using namespace OpenCallbackConvertUTF;
+        
+        size_t * offsets = static_cast<size_t *>(pathOffsets);
+        size_t pathsSize = 0;
+        
+        // The names of the 7z archive are provided without allocation, little-endian UTF-16.
+        IArchiveGetRawProps * getRawPropsRaw = nullptr;
+#if !defined(MY_CPU_BE)
+        _archive->QueryInterface(IID_IArchiveGetRawProps, reinterpret_cast<void**>(&getRawPropsRaw));
+#endif
+        CMyComPtr<IArchiveGetRawProps> getRawProps;
+        getRawProps.Attach(getRawPropsRaw);
+        
+        NWindows::NCOM::CPropVariant prop;
+        for (plzma_size_t i = 0; i < _itemsCount; i++) {
+            const void * data = nullptr;
+            UInt32 dataSize = 0, propType = 0;
+            const wchar_t * wide = nullptr;
+            size_t unitsCount = 0;
+            prop.Clear();
+            if (getRawProps && getRawProps->GetRawProp(i, kpidPath, &data, &dataSize, &propType) == S_OK &&
+                data && propType == NPropDataType::kUtf16z) {
+                unitsCount = dataSize / sizeof(UTF16);
+                if (unitsCount > 0 && static_cast<const UTF16 *>(data)[unitsCount - 1] == 0) {
+                    unitsCount--;
+                }
+            } else if (_archive->GetProperty(i, kpidPath, &prop) == S_OK && prop.vt == VT_BSTR && prop.bstrVal) {
+                wide = prop.bstrVal;
+                unitsCount = wcslen(wide);
+            }
+            
+            // UTF-8 requires at most 4 bytes per UTF-32 and 3 bytes per UTF-16 code unit.
+            const size_t required = pathsSize + (unitsCount * 4) + 1;
+            if (required > pathsCapacity) {
+                size_t capacity = MyMax<size_t>(pathsCapacity + (pathsCapacity / 2), 1024);
+                pathsCapacity = MyMax<size_t>(capacity, required);
+                paths.resize(pathsCapacity);
+            }
+            
+            offsets[i] = pathsSize;
+            UTF8 * dst = static_cast<UTF8 *>(paths) + pathsSize;
+            UTF8 * const dstBegin = dst;
+            UTF8 * const dstEnd = static_cast<UTF8 *>(paths) + pathsCapacity;
+            if (unitsCount > 0) {
+                ConversionResult convRes = sourceIllegal;
+                if (data) {
+                    const UTF16 * src = static_cast<const UTF16 *>(data);
+                    convRes = ConvertUTF16toUTF8(&src, src + unitsCount, &dst, dstEnd, lenientConversion);
+                } else if (sizeof(wchar_t) == sizeof(UTF32)) {
+                    const UTF32 * src = reinterpret_cast<const UTF32 *>(wide);
+                    convRes = ConvertUTF32toUTF8(&src, src + unitsCount, &dst, dstEnd, lenientConversion);
+                } else if (sizeof(wchar_t) == sizeof(UTF16)) {
+                    const UTF16 * src = reinterpret_cast<const UTF16 *>(wide);
+                    convRes = ConvertUTF16toUTF8(&src, src + unitsCount, &dst, dstEnd, lenientConversion);
+                }
+                if (convRes != conversionOK) {
+                    throw Exception(plzma_error_code_internal, "Item path to UTF8 string conversion.", __FILE__, __LINE__);
+                }
+            }
+            *dst = 0;
+            const size_t pathSize = static_cast<size_t>(dst - dstBegin);
+            pathsSize += pathSize - pathUtils::normalize<char>(reinterpret_cast<char *>(dstBegin)) + 1;
+        }
+        offsets[_itemsCount] = pathsSize;
+    }
+    
+    SharedPtr<ItemTable> OpenCallback::itemTable() {
+        SharedPtr<ItemTable> tableSPtr(new ItemTableImpl(_itemsCount));
+        ItemTableImpl * table = static_cast<ItemTableImpl *>(tableSPtr.get());
+        fillPaths(table->_paths, table->_pathsCapacity, table->_pathOffsets);
+        
+        uint64_t * sizes = static_cast<uint64_t *>(table->_sizes);
+        uint64_t * packSizes = static_cast<uint64_t *>(table->_packSizes);
+        time_t * times = static_cast<time_t *>(table->_times);
+        uint32_t * crcs = static_cast<uint32_t *>(table->_crcs);
+        uint8_t * flags = static_cast<uint8_t *>(table->_flags);
+        NWindows::NCOM::CPropVariant prop;
+        for (plzma_size_t i = 0; i < _itemsCount; i++) {
+            prop.Clear();
+            if (_archive->GetProperty(i, kpidSize, &prop) == S_OK) {
+                sizes[i] = PROPVARIANTGetUInt64(prop);
+            }
+            
+            prop.Clear();
+            if (_archive->GetProperty(i, kpidPackSize, &prop) == S_OK) {
+                packSizes[i] = PROPVARIANTGetUInt64(prop);
+            }
+            
+            prop.Clear();
+            if (_archive->GetProperty(i, kpidCTime, &prop) == S_OK && prop.vt == VT_FILETIME) {
+                times[i * 3] = FILETIMEToUnixTime(prop.filetime);
+            }
+            
+            prop.Clear();
+            if (_archive->GetProperty(i, kpidATime, &prop) == S_OK && prop.vt == VT_FILETIME) {
+                times[i * 3 + 1] = FILETIMEToUnixTime(prop.filetime);
+            }
+            
+            prop.Clear();
+            if (_archive->GetProperty(i, kpidMTime, &prop) == S_OK && prop.vt == VT_FILETIME) {
+                times[i * 3 + 2] = FILETIMEToUnixTime(prop.filetime);
+            }
+            
+            prop.Clear();
+            if (_archive->GetProperty(i, kpidEncrypted, &prop) == S_OK && PROPVARIANTGetBool(prop)) {
+                flags[i] |= ItemTableFlagEncrypted;
+            }
+            
+            prop.Clear();
+            if (_archive->GetProperty(i, kpidCRC, &prop) == S_OK) {
+                crcs[i] = static_cast<uint32_t>(PROPVARIANTGetUInt64(prop));
+            }
+            
+            prop.Clear();
+            if (_archive->GetProperty(i, kpidIsDir, &prop) == S_OK && PROPVARIANTGetBool(prop)) {
+                flags[i] |= ItemTableFlagDir;
+            }
+        }
+        return tableSPtr;
+    }
+    
+    static uint32_t OpenCallbackPathHash(const char * LIBPLZMA_NONNULL path, const size_t length) noexcept {
+        uint32_t hash = 2166136261U; // FNV-1a
+        for (size_t i = 0; i < length; i++) {
+            hash ^= static_cast<uint8_t>(path[i]);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+    
+    const char * OpenCallback::indexPathUtf8(const plzma_size_t index, size_t & length) const noexcept {
+        const size_t * offsets = static_cast<const size_t *>(_indexPathOffsets);
+        const char * path = static_cast<const char *>(_indexPaths) + offsets[index];
+        length = offsets[index + 1] - offsets[index] - 1;
+        return path;
+    }
+    
+    void OpenCallback::createPathsIndex() {
+        if (!_pathsIndexCreated) {
+            _indexPathOffsets.resize(sizeof(size_t) * (static_cast<size_t>(_itemsCount) + 1));
+            fillPaths(_indexPaths, _indexPathsCapacity, _indexPathOffsets);
+            
+            // Open addressing with linear probing, at most half of the slots are used.
+            // The slot contains the item index + 1, zero is an empty slot.
+            size_t slotsCount = 16;
+            while (slotsCount < (static_cast<size_t>(_itemsCount) * 2)) {
+                slotsCount *= 2;
+            }
+            _pathsIndex.resize(slotsCount * sizeof(uint32_t));
+            _pathsIndexMask = slotsCount - 1;
+            uint32_t * slots = static_cast<uint32_t *>(_pathsIndex);
+            memset(slots, 0, slotsCount * sizeof(uint32_t));
+            for (plzma_size_t i = 0; i < _itemsCount; i++) {
+                size_t itemPathLength = 0;
+                const char * itemPath = indexPathUtf8(i, itemPathLength);
+                size_t slot = OpenCallbackPathHash(itemPath, itemPathLength) & _pathsIndexMask;
+                while (slots[slot]) {
+                    slot = (slot + 1) & _pathsIndexMask;
+                }
+                slots[slot] = i + 1;
+            }
+            _pathsIndexCreated = true;
+        }
+    }
+    
+    bool OpenCallback::indexForPath(const char * LIBPLZMA_NONNULL path, const size_t length, plzma_size_t & index) {
+        createPathsIndex();
+        const uint32_t * slots = static_cast<const uint32_t *>(_pathsIndex);
+        size_t slot = OpenCallbackPathHash(path, length) & _pathsIndexMask;
+        while (slots[slot]) {
+            const plzma_size_t itemIndex = slots[slot] - 1;
+            size_t itemPathLength = 0;
+            const char * itemPath = indexPathUtf8(itemIndex, itemPathLength);
+            if (itemPathLength == length && memcmp(itemPath, path, length) == 0) {
+                index = itemIndex; // the first inserted, i.e. the lowest index of the duplicated paths
+                return true;
+            }
+            slot = (slot + 1) & _pathsIndexMask;
+        }
+        return false;
+    }
+    
+    void OpenCallback::indicesForPattern(const char * LIBPLZMA_NONNULL pattern, CRecordVector<UInt32> & indices) {
+        createPathsIndex();
+        indices.Clear();
+        size_t itemPathLength = 0;
+        for (plzma_size_t i = 0; i < _itemsCount; i++) {
+            if (pathUtils::matchPattern(pattern, indexPathUtf8(i, itemPathLength))) {
+                indices.Add(i);
+            }
+        }
+    }
+    
     OpenCallback::OpenCallback(const CMyComPtr<InStreamBase> & stream,
 #if !defined(LIBPLZMA_NO_CRYPTO)
                                const String & passwd,
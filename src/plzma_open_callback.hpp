@@ -40,6 +40,7 @@
 #include "CPP/Common/MyWindows.h"
 #include "CPP/Common/MyString.h"
 #include "CPP/Common/MyCom.h"
+#include "CPP/Common/MyVector.h"
 #include "CPP/Windows/PropVariant.h"
 #include "CPP/7zip/Archive/IArchive.h"
 #include "CPP/7zip/IPassword.h"
@@ -55,11 +56,25 @@ namespace plzma {
     private:
         CMyComPtr<IInArchive> _archive;
         CMyComPtr<InStreamBase> _stream;
+        RawHeapMemory _indexPaths;       // null-terminated, normalized UTF-8 paths of the paths index
+        RawHeapMemory _indexPathOffsets; // items count + 1 offsets inside the index paths
+        RawHeapMemory _pathsIndex;
+        size_t _indexPathsCapacity = 0;
+        size_t _pathsIndexMask = 0;
         plzma_size_t _itemsCount = 0;
         bool _passwordRequested = false;
+        bool _pathsIndexCreated = false;
         
         SharedPtr<Item> initialItemAt(const plzma_size_t index);
         
+        /// @brief Converts the paths of all items to the single buffer of null-terminated, normalized UTF-8 paths.
+        /// @param paths The buffer of the paths, grows as needed.
+        /// @param pathsCapacity The current capacity of the \a paths in bytes.
+        /// @param pathOffsets The preallocated items count + 1 offsets inside the \a paths.
+        void fillPaths(RawHeapMemory & paths, size_t & pathsCapacity, RawHeapMemory & pathOffsets);
+        const char * LIBPLZMA_NONNULL indexPathUtf8(const plzma_size_t index, size_t & length) const noexcept;
+        void createPathsIndex();
+        
         LIBPLZMA_NON_COPYABLE_NON_MOVABLE(OpenCallback)
         
     public:
@@ -81,6 +96,15 @@ namespace plzma {
         plzma_size_t itemsCount() noexcept;
         SharedPtr<Item> itemAt(const plzma_size_t index);
         SharedPtr<ItemArray> allItems();
+        SharedPtr<ItemTable> itemTable();
+        
+        /// @brief Looks up the item index by the normalized UTF-8 path.
+        /// @note The hash index of all paths is created on the first call.
+        bool indexForPath(const char * LIBPLZMA_NONNULL path, const size_t length, plzma_size_t & index);
+        
+        /// @brief Selects the ascending indices of the items with paths matching the normalized UTF-8 wildcard pattern.
+        /// @see \a pathUtils::matchPattern function.
+        void indicesForPattern(const char * LIBPLZMA_NONNULL pattern, CRecordVector<UInt32> & indices);
         OpenCallback(const CMyComPtr<InStreamBase> & stream,
 #if !defined(LIBPLZMA_NO_CRYPTO)
                      const String & passwd,
@@ -34,6 +34,7 @@
 #include "plzma_c_bindings_private.hpp"
 
 #include "CPP/Common/MyString.h"
+#include "CPP/Common/Defs.h"
 
 namespace plzma {
 
@@ -156,6 +157,22 @@ namespace plzma {
     }
     
     /// OutMemStream
+    // The minimum capacity of the memory after the first write.
+    static const uint64_t kOutMemStreamMinCapacity = 4 * 1024;
+    
+    void OutMemStream::grow(const uint64_t size) {
+        if (size > _capacity) {
+            uint64_t capacity = MyMax<uint64_t>(_capacity + (_capacity / 2), kOutMemStreamMinCapacity);
+            if (capacity < size) {
+                capacity = size;
+            } else if (capacity >= plzma_max_size()) {
+                capacity = size; // the size is already checked
+            }
+            _memory.resize(static_cast<size_t>(capacity));
+            _capacity = capacity;
+        }
+    }
+    
     STDMETHODIMP OutMemStream::Write(const void * data, UInt32 size, UInt32 * processedSize) {
         if (_opened) {
             const uint64_t dstSize = _offset + static_cast<uint64_t>(size);
@@ -166,7 +183,7 @@ namespace plzma {
                     return E_OUTOFMEMORY;
                 }
                 try {
-                    _memory.resize(static_cast<size_t>(dstSize));
+                    grow(dstSize);
                 }
                 catch (const Exception & exception) {
                     _size = _offset = 0;
@@ -239,7 +256,7 @@ namespace plzma {
                 return E_OUTOFMEMORY;
             }
             try {
-                _memory.resize(static_cast<size_t>(newSize));
+                grow(newSize);
             } catch (const Exception & exception) {
                 _size = _offset = 0;
                 _opened = false;
@@ -299,8 +316,8 @@ namespace plzma {
         if (_opened) {
             return false; // opened -> false
         }
-        _memory.clear(eraseType);
-        _size = _offset = 0;
+        _memory.clear(eraseType, static_cast<size_t>(_capacity));
+        _capacity = _size = _offset = 0;
         return true;
     }
     
@@ -316,6 +333,44 @@ namespace plzma {
         return content;
     }
     
+    RawHeapMemorySize OutMemStream::takeContent() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        RawHeapMemorySize content(RawHeapMemory(), 0);
+        if (!_opened && _size > 0) {
+            const size_t size = static_cast<size_t>(_size);
+            if (_capacity > _size) {
+                _memory.resize(size); // shrinking, usually without copying
+            }
+            content.first = static_cast<RawHeapMemory &&>(_memory);
+            content.second = size;
+            _capacity = _size = _offset = 0;
+        }
+        return content;
+    }
+    
+    RawMemoryView OutMemStream::contentView() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (!_opened && _size > 0) {
+            return RawMemoryView(static_cast<const void *>(_memory), static_cast<size_t>(_size));
+        }
+        return RawMemoryView(nullptr, 0);
+    }
+    
+    void OutMemStream::reserve(const uint64_t size) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (size > _capacity) {
+            if (size >= plzma_max_size()) {
+                throw Exception(plzma_error_code_not_enough_memory, "Can't reserve memory for out memory stream.", __FILE__, __LINE__);
+            }
+            _memory.resize(static_cast<size_t>(size));
+            _capacity = size;
+        }
+    }
+    
+    OutMemStream::OutMemStream(const size_t initialCapacity) : OutStreamBase() {
+        reserve(initialCapacity);
+    }
+    
     OutMemStream::~OutMemStream() noexcept {
         delete _exception;
         _exception = nullptr;
@@ -743,6 +798,10 @@ namespace plzma {
     SharedPtr<OutStream> makeSharedOutStream(void) {
         return SharedPtr<OutStream>(new OutMemStream());
     }
+    
+    SharedPtr<OutStream> makeSharedOutStream(const size_t initialCapacity) {
+        return SharedPtr<OutStream>(new OutMemStream(initialCapacity));
+    }
 
     SharedPtr<OutMultiStream> makeSharedOutMultiStream(const Path & dirPath,
                                                        const String & partName,
@@ -798,6 +857,13 @@ plzma_out_stream plzma_out_stream_create_memory_stream(void) {
     LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
 }
 
+plzma_out_stream plzma_out_stream_create_memory_stream_with_capacity(const size_t initial_capacity) {
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_TRY(plzma_out_stream)
+    auto stream = makeSharedOutStream(initial_capacity);
+    createdCObject.object = static_cast<void *>(stream.take());
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
 plzma_memory plzma_out_stream_copy_content(plzma_out_stream * LIBPLZMA_NONNULL stream) {
     plzma_memory createdCObject;
     createdCObject.memory = nullptr;
@@ -810,6 +876,33 @@ plzma_memory plzma_out_stream_copy_content(plzma_out_stream * LIBPLZMA_NONNULL s
     LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
 }
 
+plzma_memory plzma_out_stream_take_content(plzma_out_stream * LIBPLZMA_NONNULL stream) {
+    plzma_memory createdCObject;
+    createdCObject.memory = nullptr;
+    createdCObject.exception = nullptr;
+    createdCObject.size = 0;
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, createdCObject)
+    auto content = static_cast<OutStream *>(stream->object)->takeContent();
+    createdCObject.memory = content.first.take();
+    createdCObject.size = content.second;
+    LIBPLZMA_C_BINDINGS_CREATE_OBJECT_CATCH
+}
+
+const void * LIBPLZMA_NULLABLE plzma_out_stream_content_view(plzma_out_stream * LIBPLZMA_NONNULL stream, size_t * LIBPLZMA_NULLABLE size) {
+    LIBPLZMA_CAST_VALUE_TO_PTR(size, size_t, 0)
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, nullptr)
+    const auto view = static_cast<const OutStream *>(stream->object)->contentView();
+    LIBPLZMA_CAST_VALUE_TO_PTR(size, size_t, view.second)
+    return view.first;
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(stream, nullptr)
+}
+
+void plzma_out_stream_reserve(plzma_out_stream * LIBPLZMA_NONNULL stream, const uint64_t size) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(stream)
+    static_cast<OutStream *>(stream->object)->reserve(size);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(stream)
+}
+
 bool plzma_out_stream_opened(plzma_out_stream * LIBPLZMA_NULLABLE stream) {
     LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, false)
     return static_cast<OutStream *>(stream->object)->opened();
@@ -91,6 +91,9 @@ namespace plzma {
         virtual bool opened() const final;
         virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final;
         virtual RawHeapMemorySize copyContent() const final;
+        virtual RawHeapMemorySize takeContent() final { return copyContent(); }
+        virtual RawMemoryView contentView() const final { return RawMemoryView(nullptr, 0); }
+        virtual void reserve(const uint64_t size) final { }
         
         OutFileStream(const Path & path);
         OutFileStream(Path && path);
@@ -101,10 +104,13 @@ namespace plzma {
     private:
         RawHeapMemory _memory;
         Exception * _exception = nullptr;
+        uint64_t _capacity = 0;
         uint64_t _size = 0;
         uint64_t _offset = 0;
         bool _opened = false;
         
+        void grow(const uint64_t size);
+        
         LIBPLZMA_NON_COPYABLE_NON_MOVABLE(OutMemStream)
         
     public:
@@ -121,7 +127,11 @@ namespace plzma {
         virtual bool opened() const;
         virtual bool erase(const plzma_erase eraseType = plzma_erase_none);
         RawHeapMemorySize copyContent() const;
+        virtual RawHeapMemorySize takeContent() final;
+        virtual RawMemoryView contentView() const final;
+        virtual void reserve(const uint64_t size) final;
         
+        OutMemStream(const size_t initialCapacity);
         OutMemStream() = default;
         virtual ~OutMemStream() noexcept;
     };
@@ -145,6 +155,9 @@ namespace plzma {
         virtual bool opened() const final;
         virtual bool erase(const plzma_erase eraseType = plzma_erase_none) final;
         virtual RawHeapMemorySize copyContent() const final;
+        virtual RawHeapMemorySize takeContent() final { return copyContent(); }
+        virtual RawMemoryView contentView() const final { return RawMemoryView(nullptr, 0); }
+        virtual void reserve(const uint64_t size) final { }
         
         OutTestStream() = default;
         virtual ~OutTestStream() noexcept { }
@@ -187,6 +200,9 @@ namespace plzma {
         virtual bool opened() const final;
         virtual bool erase(const plzma_erase eraseType = plzma_erase_none);
         virtual RawHeapMemorySize copyContent() const final;
+        virtual RawHeapMemorySize takeContent() final { return copyContent(); }
+        virtual RawMemoryView contentView() const final { return RawMemoryView(nullptr, 0); }
+        virtual void reserve(const uint64_t size) final { }
         
         virtual OutStreamArray streams() const final;
         
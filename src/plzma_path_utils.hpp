@@ -319,7 +319,7 @@ namespace pathUtils {
                             pathCopy.erase(plzma_erase_zero, sizeof(T) * len);
                             return false;
                         }
-                    } else if (!createSingleDir<T>(pathCopy)) {
+                    } else if (!createSingleDir<T>(pathCopy) && !(pathExists<T>(pathCopy, &isDir) && isDir)) { // might be created concurrently
                         pathCopy.erase(plzma_erase_zero, sizeof(T) * len);
                         return false;
                     }
@@ -330,7 +330,7 @@ namespace pathUtils {
                 *s1++ = *cs1++;
             }
         }
-        const bool res = (l1 > 0 && !createSingleDir<T>(pathCopy)) ? false : true;
+        const bool res = (l1 > 0 && !createSingleDir<T>(pathCopy) && !(pathExists<T>(pathCopy, &isDir) && isDir)) ? false : true;
         pathCopy.erase(plzma_erase_zero, sizeof(T) * len);
         return res;
     }
@@ -445,6 +445,41 @@ namespace pathUtils {
         return static_cast<plzma_size_t>(skiped);
     }
     
+    /// @brief Matches the normalized UTF-8 path with the wildcard pattern.
+    ///
+    /// The '*' matches any sequence of characters including separators, the '?' matches a single character.
+    /// The path also matches if the pattern matches one of it's parent directories, i.e. the pattern
+    /// 'assets/textures' or 'assets/textures/' matches all items inside the directory.
+    template<const char PS = platformSeparator<char>()>
+    inline bool matchPattern(const char * LIBPLZMA_NONNULL pattern, const char * LIBPLZMA_NONNULL path) noexcept {
+        const char * p = pattern, * s = path, * starPattern = nullptr, * starPath = nullptr;
+        for (;;) {
+            if (*p == '*') {
+                starPattern = ++p;
+                starPath = s;
+                continue;
+            }
+            if (*p == 0) {
+                if (p > pattern && (*s == 0 || PS == *s || PS == *(p - 1))) {
+                    return true;
+                }
+            } else if (*s != 0 && (*p == '?' || *p == *s)) {
+                if (*p++ == '?') {
+                    while ((static_cast<unsigned char>(*++s) & 0xC0) == 0x80) { } // UTF-8 continuation bytes
+                } else {
+                    s++;
+                }
+                continue;
+            }
+            if (!starPattern || *starPath == 0) {
+                return false;
+            }
+            while ((static_cast<unsigned char>(*++starPath) & 0xC0) == 0x80) { }
+            p = starPattern;
+            s = starPath;
+        }
+    }
+    
     template<typename T, const T PS = platformSeparator<T>()>
     inline Pair<const T *, size_t> lastComp(const T * LIBPLZMA_NONNULL path, const size_t length) {
         Pair<const T *, size_t> res;
@@ -120,6 +120,8 @@ typedef uint32_t DWORD;
 
 #endif // !LIBPLZMA_OS_WINDOWS
 
+#if !defined(LIBPLZMA_MULTITHREAD)
+
 #ifndef USE_MIXER_ST
 #define USE_MIXER_ST
 #endif
@@ -128,6 +130,8 @@ typedef uint32_t DWORD;
 #define _7ZIP_ST 1
 #endif
 
+#endif // !LIBPLZMA_MULTITHREAD
+
 #if defined(LIBPLZMA_NO_TAR)
 #define LIBPLZMA_NO_TAR_EXCEPTION_WHAT "The tar(tarball) support was explicitly disabled. Use cmake option 'LIBPLZMA_OPT_NO_TAR:BOOL=OFF' or undefine 'LIBPLZMA_NO_TAR' preprocessor definition globally to enable tar(tarball) support."
 #endif
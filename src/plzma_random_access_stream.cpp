@@ -0,0 +1,238 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+
+#include <cstddef>
+
+#include "plzma_random_access_stream.hpp"
+#include "plzma_common.hpp"
+#include "plzma_c_bindings_private.hpp"
+
+#include "CPP/Common/Defs.h"
+
+namespace plzma {
+    
+    void RandomAccessStreamImpl::retain() {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        LIBPLZMA_RETAIN_IMPL(__m_RefCount)
+#else
+        LIBPLZMA_RETAIN_LOCKED_IMPL(__m_RefCount, _mutex)
+#endif
+    }
+    
+    void RandomAccessStreamImpl::release() {
+#if defined(LIBPLZMA_THREAD_UNSAFE)
+        LIBPLZMA_RELEASE_IMPL(__m_RefCount)
+#else
+        LIBPLZMA_RELEASE_LOCKED_IMPL(__m_RefCount, _mutex)
+#endif
+    }
+    
+    UInt32 RandomAccessStreamImpl::findBlock(const UInt64 offset) const noexcept {
+        unsigned left = 0, right = _blockPositions.Size() - 1; // the last position is the end
+        while (right - left > 1) {
+            const unsigned mid = (left + right) / 2;
+            if (offset < _blockPositions[mid]) {
+                right = mid;
+            } else {
+                left = mid;
+            }
+        }
+        return static_cast<UInt32>(left);
+    }
+    
+    const RandomAccessStreamImpl::CachedBlock & RandomAccessStreamImpl::cachedBlock(const UInt32 index) {
+        unsigned lru = 0;
+        for (unsigned i = 0; i < kCachedBlocksCount; i++) {
+            CachedBlock & block = _cache[i];
+            if (block.lastUse > 0 && block.index == index) {
+                block.lastUse = ++_useCounter;
+                return block;
+            } else if (block.lastUse < _cache[lru].lastUse) {
+                lru = i;
+            }
+        }
+        
+        CachedBlock & block = _cache[lru];
+        const size_t size = static_cast<size_t>(_blockPositions[index + 1] - _blockPositions[index]);
+        if (size > block.capacity) {
+            block.content.resize(size);
+            block.capacity = size;
+        }
+        block.lastUse = 0;
+        const HRESULT result = _blocks->DecodeBlock(index, static_cast<Byte *>(block.content));
+        if (result == E_OUTOFMEMORY) {
+            throw Exception(plzma_error_code_not_enough_memory, "Can't allocate memory for the block decoding.", __FILE__, __LINE__);
+        } else if (result != S_OK) {
+            throw Exception(plzma_error_code_internal, "Can't decode the block of the stream.", __FILE__, __LINE__);
+        }
+        block.size = size;
+        block.index = index;
+        block.lastUse = ++_useCounter;
+        return block;
+    }
+    
+    size_t RandomAccessStreamImpl::readAt(void * LIBPLZMA_NONNULL buffer, const size_t size, UInt64 offset) {
+        uint8_t * dst = static_cast<uint8_t *>(buffer);
+        const UInt64 contentSize = _blockPositions.Back();
+        size_t processedSize = 0;
+        while (!_closed && processedSize < size && offset < contentSize) {
+            const UInt32 index = findBlock(offset);
+            const CachedBlock & block = cachedBlock(index);
+            const size_t blockOffset = static_cast<size_t>(offset - _blockPositions[index]);
+            const size_t sizeToCopy = MyMin<size_t>(size - processedSize, block.size - blockOffset);
+            memcpy(dst + processedSize, static_cast<const uint8_t *>(block.content) + blockOffset, sizeToCopy);
+            processedSize += sizeToCopy;
+            offset += sizeToCopy;
+        }
+        return processedSize;
+    }
+    
+    uint64_t RandomAccessStreamImpl::size() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _blockPositions.Back();
+    }
+    
+    uint64_t RandomAccessStreamImpl::position() const {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return _position;
+    }
+    
+    void RandomAccessStreamImpl::seek(const uint64_t offset) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        _position = offset;
+    }
+    
+    size_t RandomAccessStreamImpl::read(void * LIBPLZMA_NONNULL buffer, const size_t size) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        const size_t processedSize = readAt(buffer, size, _position);
+        _position += processedSize;
+        return processedSize;
+    }
+    
+    size_t RandomAccessStreamImpl::pread(void * LIBPLZMA_NONNULL buffer, const size_t size, const uint64_t offset) {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        return readAt(buffer, size, offset);
+    }
+    
+    void RandomAccessStreamImpl::close() {
+        LIBPLZMA_LOCKGUARD(lock, _mutex)
+        if (_closed) {
+            return;
+        }
+        _closed = true;
+        _blocks.Release();
+        _archive.Release();
+        if (_stream) {
+            _stream->close();
+        }
+        for (unsigned i = 0; i < kCachedBlocksCount; i++) {
+            _cache[i].content.clear();
+            _cache[i].capacity = _cache[i].size = 0;
+            _cache[i].lastUse = 0;
+        }
+    }
+    
+    RandomAccessStreamImpl::RandomAccessStreamImpl(const CMyComPtr<InStreamBase> & stream,
+                                                   const CMyComPtr<IInArchive> & archive) : CMyUnknownImp(),
+        _stream(stream),
+        _archive(archive) {
+            _archive->QueryInterface(IID_IArchiveIndexedBlocks, reinterpret_cast<void**>(&_blocks));
+            UInt32 blocksCount = 0;
+            if (!_blocks || _blocks->GetNumberOfBlocks(&blocksCount) != S_OK || blocksCount == 0) {
+                _stream->close();
+                Exception exception(plzma_error_code_invalid_arguments, "Can't open random access stream.", __FILE__, __LINE__);
+                exception.setReason("The stream has no index of the blocks or the blocks are too large.", nullptr);
+                throw exception;
+            }
+            _blockPositions.ClearAndReserve(blocksCount + 1);
+            UInt64 unpackPos = 0, unpackSize = 0;
+            for (UInt32 i = 0; i < blocksCount; i++) {
+                if (_blocks->GetBlockInfo(i, &unpackPos, &unpackSize) != S_OK) {
+                    _stream->close();
+                    throw Exception(plzma_error_code_internal, "Can't read archive block info.", __FILE__, __LINE__);
+                }
+                _blockPositions.AddInReserved(unpackPos);
+            }
+            _blockPositions.AddInReserved(unpackPos + unpackSize);
+    }
+    
+    RandomAccessStreamImpl::~RandomAccessStreamImpl() {
+        close();
+    }
+    
+} // namespace plzma
+
+#if !defined(LIBPLZMA_NO_C_BINDINGS)
+
+using namespace plzma;
+
+uint64_t plzma_random_access_stream_size(plzma_random_access_stream * LIBPLZMA_NONNULL stream) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, 0)
+    return static_cast<RandomAccessStream *>(stream->object)->size();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(stream, 0)
+}
+
+uint64_t plzma_random_access_stream_position(plzma_random_access_stream * LIBPLZMA_NONNULL stream) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, 0)
+    return static_cast<RandomAccessStream *>(stream->object)->position();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(stream, 0)
+}
+
+void plzma_random_access_stream_seek(plzma_random_access_stream * LIBPLZMA_NONNULL stream, const uint64_t offset) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(stream)
+    static_cast<RandomAccessStream *>(stream->object)->seek(offset);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(stream)
+}
+
+size_t plzma_random_access_stream_read(plzma_random_access_stream * LIBPLZMA_NONNULL stream, void * LIBPLZMA_NONNULL buffer, const size_t size) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, 0)
+    return static_cast<RandomAccessStream *>(stream->object)->read(buffer, size);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(stream, 0)
+}
+
+size_t plzma_random_access_stream_pread(plzma_random_access_stream * LIBPLZMA_NONNULL stream, void * LIBPLZMA_NONNULL buffer, const size_t size, const uint64_t offset) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY_RETURN(stream, 0)
+    return static_cast<RandomAccessStream *>(stream->object)->pread(buffer, size, offset);
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH_RETURN(stream, 0)
+}
+
+void plzma_random_access_stream_close(plzma_random_access_stream * LIBPLZMA_NONNULL stream) {
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_TRY(stream)
+    static_cast<RandomAccessStream *>(stream->object)->close();
+    LIBPLZMA_C_BINDINGS_OBJECT_EXEC_CATCH(stream)
+}
+
+void plzma_random_access_stream_release(plzma_random_access_stream * LIBPLZMA_NONNULL stream) {
+    plzma_object_exception_release(stream);
+    SharedPtr<RandomAccessStream> streamSPtr;
+    streamSPtr.assign(static_cast<RandomAccessStream *>(stream->object));
+    stream->object = nullptr;
+}
+
+#endif // !LIBPLZMA_NO_C_BINDINGS
@@ -0,0 +1,99 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+
+#ifndef __PLZMA_RANDOM_ACCESS_STREAM_HPP__
+#define __PLZMA_RANDOM_ACCESS_STREAM_HPP__ 1
+
+#include <cstddef>
+
+#include "../libplzma.hpp"
+#include "plzma_private.hpp"
+#include "plzma_in_streams.hpp"
+#include "plzma_mutex.hpp"
+
+#include "CPP/Common/Common.h"
+#include "CPP/Common/MyWindows.h"
+#include "CPP/Common/MyCom.h"
+#include "CPP/Common/MyVector.h"
+#include "CPP/7zip/Archive/IArchive.h"
+
+namespace plzma {
+    
+    class RandomAccessStreamImpl final : public RandomAccessStream, public CMyUnknownImp {
+    private:
+        friend struct SharedPtr<RandomAccessStreamImpl>;
+        
+        struct CachedBlock final {
+            RawHeapMemory content;
+            size_t capacity = 0;
+            size_t size = 0;
+            UInt64 lastUse = 0; // 0 - not used
+            UInt32 index = 0;
+        };
+        
+        static const unsigned kCachedBlocksCount = 4;
+        
+        LIBPLZMA_MUTEX(mutable _mutex)
+        CMyComPtr<InStreamBase> _stream;
+        CMyComPtr<IInArchive> _archive;
+        CMyComPtr<IArchiveIndexedBlocks> _blocks;
+        CRecordVector<UInt64> _blockPositions; // unpack positions of the blocks, the last one is the size of the content
+        CachedBlock _cache[kCachedBlocksCount];
+        UInt64 _position = 0;
+        UInt64 _useCounter = 0;
+        bool _closed = false;
+        
+        UInt32 findBlock(const UInt64 offset) const noexcept;
+        const CachedBlock & cachedBlock(const UInt32 index);
+        size_t readAt(void * LIBPLZMA_NONNULL buffer, const size_t size, UInt64 offset);
+        
+        virtual void retain() override final;
+        virtual void release() override final;
+        
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(RandomAccessStreamImpl)
+        
+    public:
+        MY_ADDREF_RELEASE
+        
+        virtual uint64_t size() const override final;
+        virtual uint64_t position() const override final;
+        virtual void seek(const uint64_t offset) override final;
+        virtual size_t read(void * LIBPLZMA_NONNULL buffer, const size_t size) override final;
+        virtual size_t pread(void * LIBPLZMA_NONNULL buffer, const size_t size, const uint64_t offset) override final;
+        virtual void close() override final;
+        
+        /// @brief Reads the xz stream of the archive opened with own copy of the input stream.
+        /// @exception The \a Exception with \a plzma_error_code_invalid_arguments code in case if the archive
+        /// has no index of the blocks.
+        RandomAccessStreamImpl(const CMyComPtr<InStreamBase> & stream, const CMyComPtr<IInArchive> & archive);
+        virtual ~RandomAccessStreamImpl();
+    };
+    
+} // namespace plzma
+
+#endif // !__PLZMA_RANDOM_ACCESS_STREAM_HPP__
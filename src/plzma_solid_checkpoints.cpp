@@ -0,0 +1,196 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include <cstddef>
+
+#include "plzma_solid_checkpoints.hpp"
+
+#include "CPP/Common/Defs.h"
+#include "CPP/7zip/Common/StreamUtils.h"
+#include "C/Alloc.h"
+#include "C/7zCrc.h"
+
+namespace plzma {
+    
+    // The size of the packed data read at once and the size of the buffer for the skipped data.
+    static const size_t kSolidCheckpointBufferSize = 1 << 16;
+    
+    HRESULT scanLzma2Checkpoints(IInStream * stream,
+                                 const UInt64 packPosition,
+                                 const UInt64 packSize,
+                                 CRecordVector<SolidCheckpoint> & checkpoints) {
+        UInt64 packOffset = 0, unpackOffset = 0;
+        while (packOffset < packSize) {
+            Byte header[6];
+            size_t headerSize = static_cast<size_t>(MyMin<UInt64>(sizeof(header), packSize - packOffset));
+            RINOK(stream->Seek(static_cast<Int64>(packPosition + packOffset), STREAM_SEEK_SET, nullptr))
+            RINOK(ReadStream(stream, header, &headerSize))
+            if (headerSize == 0) {
+                return S_FALSE;
+            }
+            const unsigned control = header[0];
+            if (control == 0) { // end marker
+                return S_OK;
+            }
+            UInt64 chunkPackSize = 0, chunkUnpackSize = 0;
+            size_t chunkHeaderSize = 0;
+            bool resetDictionary = false;
+            if (control & 0x80) { // LZMA chunk
+                const unsigned mode = (control >> 5) & 3;
+                chunkHeaderSize = (mode >= 2) ? 6 : 5;
+                if (headerSize < chunkHeaderSize) {
+                    return S_FALSE;
+                }
+                chunkUnpackSize = ((static_cast<UInt64>(control & 0x1F) << 16) | (static_cast<UInt64>(header[1]) << 8) | header[2]) + 1;
+                chunkPackSize = ((static_cast<UInt64>(header[3]) << 8) | header[4]) + 1;
+                resetDictionary = (mode == 3);
+            } else if (control <= 2) { // uncompressed chunk
+                chunkHeaderSize = 3;
+                if (headerSize < chunkHeaderSize) {
+                    return S_FALSE;
+                }
+                chunkUnpackSize = chunkPackSize = ((static_cast<UInt64>(header[1]) << 8) | header[2]) + 1;
+                resetDictionary = (control == 1);
+            } else {
+                return S_FALSE;
+            }
+            if (resetDictionary && unpackOffset > 0) {
+                SolidCheckpoint checkpoint;
+                checkpoint.unpackOffset = unpackOffset;
+                checkpoint.packOffset = packOffset;
+                checkpoints.Add(checkpoint);
+            }
+            packOffset += chunkHeaderSize + chunkPackSize;
+            unpackOffset += chunkUnpackSize;
+        }
+        return (packOffset == packSize) ? S_OK : S_FALSE;
+    }
+    
+    HRESULT Lzma2CheckpointInStream::readInput() {
+        if (_inPos < _inSize || _packRemaining == 0) {
+            return S_OK;
+        }
+        size_t size = static_cast<size_t>(MyMin<UInt64>(kSolidCheckpointBufferSize, _packRemaining));
+        RINOK(_stream->Seek(static_cast<Int64>(_packPosition), STREAM_SEEK_SET, nullptr))
+        RINOK(ReadStream(_stream, static_cast<void *>(_inBuffer), &size))
+        if (size == 0) {
+            return S_FALSE;
+        }
+        _packPosition += size;
+        _packRemaining -= size;
+        _inPos = 0;
+        _inSize = size;
+        return S_OK;
+    }
+    
+    HRESULT Lzma2CheckpointInStream::decode(Byte * data, size_t size, size_t & processedSize) {
+        processedSize = 0;
+        while (processedSize < size) {
+            RINOK(readInput())
+            SizeT outSize = size - processedSize;
+            SizeT inSize = _inSize - _inPos;
+            ELzmaStatus status = LZMA_STATUS_NOT_SPECIFIED;
+            const SRes res = Lzma2Dec_DecodeToBuf(&_decoder, data + processedSize, &outSize,
+                                                  static_cast<const Byte *>(_inBuffer) + _inPos, &inSize,
+                                                  LZMA_FINISH_ANY, &status);
+            _inPos += inSize;
+            processedSize += outSize;
+            if (res != SZ_OK) {
+                return S_FALSE;
+            }
+            if (inSize == 0 && outSize == 0) {
+                break;
+            }
+        }
+        return S_OK;
+    }
+    
+    STDMETHODIMP Lzma2CheckpointInStream::Read(void * data, UInt32 size, UInt32 * processedSize) {
+        LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, 0)
+        if (!_allocated) {
+            return E_FAIL;
+        }
+        while (_skip > 0) {
+            size_t skipped = 0;
+            RINOK(decode(static_cast<Byte *>(_skipBuffer), static_cast<size_t>(MyMin<UInt64>(kSolidCheckpointBufferSize, _skip)), skipped))
+            if (skipped == 0) {
+                return S_FALSE;
+            }
+            _skip -= skipped;
+        }
+        const size_t sizeToRead = static_cast<size_t>(MyMin<UInt64>(size, _remaining));
+        if (sizeToRead == 0) {
+            return S_OK;
+        }
+        size_t decoded = 0;
+        RINOK(decode(static_cast<Byte *>(data), sizeToRead, decoded))
+        if (decoded != sizeToRead) {
+            return S_FALSE;
+        }
+        _crc = CrcUpdate(_crc, data, decoded);
+        _remaining -= decoded;
+        if (_remaining == 0 && _crcDefined && CRC_GET_DIGEST(_crc) != _expectedCrc) {
+            return S_FALSE;
+        }
+        LIBPLZMA_CAST_VALUE_TO_PTR(processedSize, UInt32, decoded)
+        return S_OK;
+    }
+    
+    HRESULT Lzma2CheckpointInStream::init(const Byte prop) {
+        if (Lzma2Dec_Allocate(&_decoder, prop, &g_Alloc) != SZ_OK) {
+            return E_OUTOFMEMORY;
+        }
+        Lzma2Dec_Init(&_decoder);
+        _allocated = true;
+        return S_OK;
+    }
+    
+    Lzma2CheckpointInStream::Lzma2CheckpointInStream(IInStream * stream,
+                                                     const UInt64 packPosition,
+                                                     const UInt64 packRemaining,
+                                                     const UInt64 skip,
+                                                     const UInt64 size,
+                                                     const bool crcDefined,
+                                                     const UInt32 crc) : CMyUnknownImp(),
+        _stream(stream),
+        _inBuffer(kSolidCheckpointBufferSize),
+        _skipBuffer(skip > 0 ? kSolidCheckpointBufferSize : 0),
+        _packPosition(packPosition),
+        _packRemaining(packRemaining),
+        _skip(skip),
+        _remaining(size),
+        _crc(CRC_INIT_VAL),
+        _expectedCrc(crc),
+        _crcDefined(crcDefined) {
+            Lzma2Dec_Construct(&_decoder);
+    }
+    
+    Lzma2CheckpointInStream::~Lzma2CheckpointInStream() {
+        Lzma2Dec_Free(&_decoder, &g_Alloc);
+    }
+    
+} // namespace plzma
@@ -0,0 +1,114 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#ifndef __PLZMA_SOLID_CHECKPOINTS_HPP__
+#define __PLZMA_SOLID_CHECKPOINTS_HPP__ 1
+
+#include <cstddef>
+
+#include "../libplzma.hpp"
+#include "plzma_private.hpp"
+
+#include "CPP/Common/Common.h"
+#include "CPP/Common/MyWindows.h"
+#include "CPP/Common/MyCom.h"
+#include "CPP/Common/MyVector.h"
+#include "CPP/7zip/IStream.h"
+#include "C/Lzma2Dec.h"
+
+namespace plzma {
+    
+    /// @brief The point of the LZMA2 stream where the dictionary is reset, so the decoding can be started from it.
+    struct SolidCheckpoint final {
+        UInt64 unpackOffset;
+        UInt64 packOffset;
+    };
+    
+    /// @brief Scans the chunk headers of the LZMA2 stream without decoding.
+    /// @param stream The seekable stream with the packed data.
+    /// @param packPosition The position of the LZMA2 stream.
+    /// @param packSize The size of the LZMA2 stream.
+    /// @param checkpoints The dictionary reset points after the start of the stream.
+    /// @return \a S_OK if the chunks are valid, otherwise \a S_FALSE.
+    HRESULT scanLzma2Checkpoints(IInStream * stream,
+                                 const UInt64 packPosition,
+                                 const UInt64 packSize,
+                                 CRecordVector<SolidCheckpoint> & checkpoints);
+    
+    /// @brief Reads the item of the solid LZMA2 folder decoding from the nearest checkpoint.
+    ///
+    /// Skips the decoded bytes between the checkpoint and the item, verifies the CRC of the item if provided.
+    class Lzma2CheckpointInStream final : public ISequentialInStream, public CMyUnknownImp {
+    private:
+        CMyComPtr<IInStream> _stream;
+        CLzma2Dec _decoder;
+        RawHeapMemory _inBuffer;
+        RawHeapMemory _skipBuffer;
+        UInt64 _packPosition = 0;  // absolute position of the next packed byte
+        UInt64 _packRemaining = 0; // packed bytes of the folder after the buffer
+        UInt64 _skip = 0;          // decoded bytes before the item
+        UInt64 _remaining = 0;     // item bytes to read
+        size_t _inPos = 0;
+        size_t _inSize = 0;
+        UInt32 _crc = 0;
+        UInt32 _expectedCrc = 0;
+        bool _crcDefined = false;
+        bool _allocated = false;
+        
+        HRESULT readInput();
+        HRESULT decode(Byte * data, size_t size, size_t & processedSize);
+        
+        LIBPLZMA_NON_COPYABLE_NON_MOVABLE(Lzma2CheckpointInStream)
+        
+    public:
+        MY_UNKNOWN_IMP1(ISequentialInStream)
+        
+        STDMETHOD(Read)(void * data, UInt32 size, UInt32 * processedSize);
+        
+        /// @brief Initializes the decoder.
+        /// @param prop The LZMA2 dictionary property of the coder.
+        /// @return \a S_OK if initialized.
+        HRESULT init(const Byte prop);
+        
+        /// @param stream The seekable archive stream.
+        /// @param packPosition The absolute position of the checkpoint's packed data.
+        /// @param packRemaining The number of packed bytes of the folder after the checkpoint.
+        /// @param skip The number of decoded bytes between the checkpoint and the item.
+        /// @param size The size of the item.
+        Lzma2CheckpointInStream(IInStream * stream,
+                                const UInt64 packPosition,
+                                const UInt64 packRemaining,
+                                const UInt64 skip,
+                                const UInt64 size,
+                                const bool crcDefined,
+                                const UInt32 crc);
+        virtual ~Lzma2CheckpointInStream();
+    };
+    
+} // namespace plzma
+
+#endif // !__PLZMA_SOLID_CHECKPOINTS_HPP__
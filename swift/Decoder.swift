@@ -112,6 +112,23 @@ public final class Decoder {
     }
 
     
+    /// Receives the columnar listing of all archive items.
+    ///
+    /// Preferred for listing large archives, the table doesn't create the item objects.
+    /// - Returns: The table with all archive items.
+    /// - Note: The decoder must be opened.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    public func itemTable() throws -> ItemTable {
+        var decoder = object
+        let table = plzma_decoder_item_table(&decoder)
+        if let exception = table.exception {
+            throw Exception(object: exception)
+        }
+        return ItemTable(object: table)
+    }
+
+    
     /// Receives single archive item at a specific index.
     /// - Parameter index: The index of the item inside the arhive. Must be less than the number of items reported by the `count()` method.
     /// - Returns: The archive item.
@@ -127,6 +144,42 @@ public final class Decoder {
         return Item(object: item)
     }
     
+    
+    /// Receives single archive item by it's path inside the archive.
+    ///
+    /// The hash index of all item paths is created on the first call, the next lookups don't scan the items.
+    /// - Parameter path: The item's path inside the archive.
+    /// - Returns: The archive item or `nil` if the archive has no item with such path.
+    /// - Note: The decoder must be opened.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    public func item(atPath path: Path) throws -> Item? {
+        var decoder = object
+        var pathObject = path.object
+        let item = plzma_decoder_item_at_path(&decoder, &pathObject)
+        if let exception = item.exception {
+            throw Exception(object: exception)
+        }
+        return item.object != nil ? Item(object: item) : nil
+    }
+    
+    
+    /// Receives the archive items by their paths inside the archive, i.e. for extracting or testing selected items.
+    /// - Parameter paths: The item paths inside the archive.
+    /// - Returns: The array with the found items in order of paths, the missed paths are skipped.
+    /// - Note: The decoder must be opened.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    public func items(atPaths paths: [Path]) throws -> ItemArray {
+        var decoder = object
+        let pathObjects = paths.map { $0.object }
+        let items = plzma_decoder_items_at_paths(&decoder, pathObjects, Size(pathObjects.count))
+        if let exception = items.exception {
+            throw Exception(object: exception)
+        }
+        return ItemArray(object: items)
+    }
+    
     // MARK: - Extracting
     
     /// Extracts all archive items to a specific path.
@@ -167,6 +220,28 @@ public final class Decoder {
     }
     
     
+    /// Extracts the archive items with paths matching the wildcard pattern to a specific path.
+    ///
+    /// The '*' matches any sequence of characters including separators, the '?' matches a single character.
+    /// The pattern of a directory, i.e. 'assets/textures/', matches all items inside it.
+    /// - Parameter pattern: The wildcard pattern.
+    /// - Parameter path: The directory path to extract the matched items.
+    /// - Parameter itemsFullPath: Exctract item using it's full path or only the last path component.
+    /// - Note: The extracting progress might be executed in a separate thread.
+    /// - Note: The extracting progress might be aborted via `abort()` method.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    public func extract(matching pattern: String, to path: Path, itemsFullPath: Bool = true) throws -> Bool {
+        var decoder = object
+        var pathObject = path.object
+        let result = plzma_decoder_extract_matching_items_to_path(&decoder, pattern, &pathObject, itemsFullPath)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
     /// Extracts each archive item to a separate out-stream.
     /// - Parameter items: The array with item/out-stream pairs.
     /// - Note: The extracting progress might be executed in a separate thread.
@@ -202,6 +277,22 @@ public final class Decoder {
     }
     
     
+    /// Tests the archive items with paths matching the wildcard pattern.
+    /// - Parameter pattern: The wildcard pattern, see `extract(matching:to:itemsFullPath:)`.
+    /// - Note: The testing progress might be executed in a separate thread.
+    /// - Note: The testing progress might be aborted via `abort()` method.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    public func test(matching pattern: String) throws -> Bool {
+        var decoder = object
+        let result = plzma_decoder_test_matching_items(&decoder, pattern)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
     /// Tests all archive items.
     /// - Note: The testing progress might be executed in a separate thread.
     /// - Note: The testing progress might be aborted via `abort()` method.
@@ -216,6 +307,64 @@ public final class Decoder {
         return result
     }
     
+    /// Opens the stream for reading the decoded content of a single archive item.
+    ///
+    /// The stream reads own copy of the input stream. The xz and tar items are read directly from the archive,
+    /// the 7z items are decoded in a separate thread through a bounded buffer or from the nearest checkpoint
+    /// found by the `buildCheckpoints()` function. In case if the input stream can't be copied(stream with callbacks),
+    /// the item is extracted to memory before reading.
+    /// - Parameter item: The archive item.
+    /// - Returns: The item stream or `nil` if the decoder is not opened.
+    /// - Throws: `Exception`.
+    /// - Note: Thread-safe.
+    public func openItemStream(item: Item) throws -> ItemStream? {
+        var decoder = object
+        var itemObject = item.object
+        let stream = plzma_decoder_open_item_stream(&decoder, &itemObject)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        return stream.object != nil ? ItemStream(object: stream) : nil
+    }
+    
+    
+    /// Finds the checkpoints of the solid LZMA2 folders of the 7z archive.
+    ///
+    /// The checkpoint is the point where the LZMA2 encoder reset the dictionary, i.e. the start of each LZMA2 block.
+    /// Only the chunk headers are read, without decoding. The item streams opened after this call start decoding
+    /// from the nearest checkpoint before the item instead of the start of the solid folder.
+    /// - Returns: The number of found checkpoints.
+    /// - Note: The decoder must be opened.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    @discardableResult
+    public func buildCheckpoints() throws -> Size {
+        var decoder = object
+        let count = plzma_decoder_build_checkpoints(&decoder)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+        return count
+    }
+    
+    
+    /// Opens the stream for reading the decoded content of the xz archive at any offset.
+    ///
+    /// The stream reads own copy of the input stream and decodes only the xz blocks with the requested range.
+    /// The multi-block xz archives can be created via the `Encoder.setBlockSize(_:)` function.
+    /// - Returns: The random access stream or `nil` if the decoder is not opened.
+    /// - Throws: `Exception` in case if the archive type is not xz, the xz stream has no index of the blocks
+    /// or the input stream can't be copied(stream with callbacks).
+    /// - Note: Thread-safe.
+    public func openRandomAccessStream() throws -> RandomAccessStream? {
+        var decoder = object
+        let stream = plzma_decoder_open_random_access_stream(&decoder)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        return stream.object != nil ? RandomAccessStream(object: stream) : nil
+    }
+    
     //MARK: - Initialization
     
     /// Provides the archive password for opening, extracting or testing items.
@@ -236,6 +385,91 @@ public final class Decoder {
         }
     }
     
+    
+    /// Getter for a number of threads used by the coders.
+    /// - Returns: The number of threads or `0` which means all hardware threads.
+    /// - Note: By default the value is `0`. Thread-safe.
+    /// - Throws: `Exception`.
+    public func numberOfThreads() throws -> UInt32 {
+        var decoder = object
+        let result = plzma_decoder_number_of_threads(&decoder)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Setter for a number of threads used by the coders.
+    /// - Parameter threads: The number of threads, `0` means all hardware threads.
+    /// - Note: Has no effect if the library was built without `LIBPLZMA_MULTITHREAD`. Thread-safe. Must be set before opening.
+    /// - Throws: `Exception`.
+    public func setNumberOfThreads(_ threads: UInt32) throws {
+        var decoder = object
+        plzma_decoder_set_number_of_threads(&decoder, threads)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
+    /// Getter for a memory usage limit of the coders.
+    /// - Returns: The limit in bytes or `0` which means the default limit, a half of the physical memory.
+    /// - Note: By default the value is `0`. Thread-safe.
+    /// - Throws: `Exception`.
+    public func memoryLimit() throws -> UInt64 {
+        var decoder = object
+        let result = plzma_decoder_memory_limit(&decoder)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Setter for a memory usage limit of the coders.
+    /// The multithreaded coders reduce the number of threads or fall back to a single thread to keep the memory usage below this limit.
+    /// - Parameter limit: The limit in bytes, `0` means the default limit.
+    /// - Note: Thread-safe. Must be set before opening.
+    /// - Throws: `Exception`.
+    public func setMemoryLimit(_ limit: UInt64) throws {
+        var decoder = object
+        plzma_decoder_set_memory_limit(&decoder, limit)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
+    /// Getter for a number of the extract workers.
+    /// - Returns: The number of workers, `0` means the number of hardware threads.
+    /// - Note: By default the value is `1`, i.e. the items are extracted sequentially. Thread-safe.
+    /// - Throws: `Exception`.
+    public func extractWorkers() throws -> UInt32 {
+        var decoder = object
+        let result = plzma_decoder_extract_workers(&decoder)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Setter for a number of the extract workers.
+    /// The independent solid blocks(folders) of the 7z archive or the indexed blocks of the xz stream are extracted in parallel, each worker reads own copy of the input stream.
+    /// The xz blocks are written to the output in order.
+    /// Falls back to the sequential extraction if the input stream can't be copied, the archive has only one solid block, the xz stream has only one block or the type of the archive is tar.
+    /// - Parameter workers: The number of workers, `0` means the number of hardware threads.
+    /// - Note: Thread-safe. Must be set before extracting.
+    /// - Throws: `Exception`.
+    public func setExtractWorkers(_ workers: UInt32) throws {
+        var decoder = object
+        plzma_decoder_set_extract_workers(&decoder, workers)
+        if let exception = decoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
     /// Initializes the decoder.
     /// - Parameter stream: The input stream with archive file content.
     ///                     After successful opening, the input stream will be opened as long as a decoder exists.
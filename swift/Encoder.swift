@@ -145,6 +145,83 @@ public final class Encoder {
         }
     }
     
+    
+    /// Adds the item which content is pushed during the compression, the size of the content is not required.
+    ///
+    /// The content is pushed from the other thread than `compress()` via `beginItem(archivePath:)`, `write(_:)` and `endItem()`.
+    /// The size of the item is unknown before pushing, the 7z solid block size limit(see `setSolidBlockSize(_:)`)
+    /// counts each push item as 64 MiB regardless of the pushed content.
+    /// - Parameter archivePath: The path of how the item will be presented in archive. Empty path is not allowed.
+    /// - Note: Thread-safe. Must be set before opening.
+    /// - Throws: `Exception`.
+    public func addPushItem(archivePath: Path) throws {
+        var encoder = object
+        var archivePathObject = archivePath.object
+        plzma_encoder_add_push_item(&encoder, &archivePathObject)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
+    /// Begins pushing the content of the previously added push item.
+    ///
+    /// The encoder reads the items in own order, i.e. the 7z archive sorts the items by the archive path.
+    /// The memory usage is bounded if the items are pushed in the same order, otherwise the pushed content
+    /// is buffered until the encoder reads the item.
+    /// - Parameter archivePath: The archive path of the item, provided by `addPushItem(archivePath:)`.
+    /// - Returns: `false` if the encoder finished, aborted or the pushing failed, otherwise `true`.
+    ///   The failure of the pushing is thrown by `compress()`.
+    /// - Note: Thread-safe. The items must be pushed one by one from a single thread.
+    /// - Throws: `Exception`.
+    public func beginItem(archivePath: Path) throws -> Bool {
+        var encoder = object
+        var archivePathObject = archivePath.object
+        let result = plzma_encoder_begin_item(&encoder, &archivePathObject)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Pushes the next portion of the content of the begun item.
+    ///
+    /// Waits while the encoder reads the previously pushed content.
+    /// - Parameter data: The content to push.
+    /// - Returns: `false` if the encoder finished, aborted or the pushing failed, otherwise `true`.
+    ///   The failure of the pushing is thrown by `compress()`.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    public func write(_ data: Data) throws -> Bool {
+        var encoder = object
+        let result = data.withUnsafeBytes { (buffer: UnsafeRawBufferPointer) -> Bool in
+            guard let baseAddress = buffer.baseAddress, buffer.count > 0 else {
+                return true
+            }
+            return plzma_encoder_write(&encoder, baseAddress, buffer.count)
+        }
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Ends pushing the content of the begun item.
+    /// - Returns: `false` if the encoder finished, aborted or the pushing failed, otherwise `true`.
+    ///   The failure of the pushing is thrown by `compress()`.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    public func endItem() throws -> Bool {
+        var encoder = object
+        let result = plzma_encoder_end_item(&encoder)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
     // MARK: - Properties
     
     /// Provides the password for archive.
@@ -196,6 +273,36 @@ public final class Encoder {
     }
     
     
+    /// Should encoder group the similar items of the 7z archive and choose the filters by the item content.
+    /// - Note: Disabled by default, the value is `false`.
+    /// - Note: Thread-safe.
+    /// - Throws: `Exception`.
+    public func shouldUseSmartSolid() throws -> Bool {
+        var encoder = object
+        let result = plzma_encoder_should_use_smart_solid(&encoder)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Set encoder will group the similar items of the 7z archive and choose the filters by the item content.
+    ///
+    /// The items are sorted by the type, i.e. by extension, so the similar content is next to each other in the solid block.
+    /// The beginning of each file is analyzed to apply the executable(BCJ, ARM, etc.) or the Delta(wav) filters to the
+    /// group of the detected items. The added streams are not analyzed.
+    /// - Note: Thread-safe. Must be set before opening.
+    /// - Throws: `Exception`.
+    public func setShouldUseSmartSolid(_ smart: Bool) throws {
+        var encoder = object
+        plzma_encoder_set_should_use_smart_solid(&encoder, smart)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
     /// Getter for a compression level.
     /// - Returns: The level in a range [0; 9].
     /// - Note: Thread-safe.
@@ -223,6 +330,127 @@ public final class Encoder {
     }
     
     
+    /// Getter for a number of threads used by the coders.
+    /// - Returns: The number of threads or `0` which means all hardware threads.
+    /// - Note: By default the value is `0`. Thread-safe.
+    /// - Throws: `Exception`.
+    public func numberOfThreads() throws -> UInt32 {
+        var encoder = object
+        let result = plzma_encoder_number_of_threads(&encoder)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Setter for a number of threads used by the coders.
+    /// - Parameter threads: The number of threads, `0` means all hardware threads.
+    /// - Note: Has no effect if the library was built without `LIBPLZMA_MULTITHREAD`. Thread-safe. Must be set before opening.
+    /// - Throws: `Exception`.
+    public func setNumberOfThreads(_ threads: UInt32) throws {
+        var encoder = object
+        plzma_encoder_set_number_of_threads(&encoder, threads)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
+    /// Getter for a block size of the LZMA2 compression.
+    /// - Returns: The size in bytes or `0` which means the default size of the coder.
+    /// - Note: By default the value is `0`. Thread-safe.
+    /// - Throws: `Exception`.
+    public func blockSize() throws -> UInt64 {
+        var encoder = object
+        let result = plzma_encoder_block_size(&encoder)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Setter for a block size of the LZMA2 compression.
+    ///
+    /// The xz stream is split to the independent blocks of this size, listed in the xz index.
+    /// Such blocks are compressed in parallel by the multithreaded coder and can be decoded in parallel by the extract workers of the decoder.
+    /// The 7z LZMA2 stream resets the dictionary after each block, the multithreaded LZMA2 coder compresses the blocks in parallel
+    /// and the decoder's checkpoints are placed at the block starts. Has no effect for the other 7z methods.
+    /// - Parameter size: The size in bytes, `0` means the default size of the coder.
+    /// - Note: Thread-safe. Must be set before opening.
+    /// - Throws: `Exception`.
+    public func setBlockSize(_ size: UInt64) throws {
+        var encoder = object
+        plzma_encoder_set_block_size(&encoder, size)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
+    /// Getter for a maximum size of the solid block of the 7z archive.
+    /// - Returns: The size in bytes or `0` which means the default size for the compression method and level.
+    /// - Note: By default the value is `0`. Thread-safe.
+    /// - Throws: `Exception`.
+    public func solidBlockSize() throws -> UInt64 {
+        var encoder = object
+        let result = plzma_encoder_solid_block_size(&encoder)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Setter for a maximum size of the solid block of the 7z archive.
+    ///
+    /// The items are compressed to the solid blocks(folders) of the limited unpacked size.
+    /// The smaller blocks decrease the ratio, but the item is decoded from the start of own block
+    /// and the blocks can be decoded in parallel by the extract workers of the decoder. Has no effect if the archive is not solid.
+    /// The items added by `addPushItem(archivePath:)` are counted as 64 MiB each, so a limit less than 64 MiB places each of them to own block.
+    /// - Parameter size: The size in bytes, `0` means the default size for the compression method and level.
+    /// - Note: Thread-safe. Must be set before opening.
+    /// - Throws: `Exception`.
+    public func setSolidBlockSize(_ size: UInt64) throws {
+        var encoder = object
+        plzma_encoder_set_solid_block_size(&encoder, size)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
+    /// Getter for a maximum number of items in the solid block of the 7z archive.
+    /// - Returns: The number of items or `0` which means unlimited.
+    /// - Note: By default the value is `0`. Thread-safe.
+    /// - Throws: `Exception`.
+    public func solidBlockFileCount() throws -> UInt32 {
+        var encoder = object
+        let result = plzma_encoder_solid_block_file_count(&encoder)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Setter for a maximum number of items in the solid block of the 7z archive.
+    ///
+    /// Applied together with the solid block size, the block is finished when any of the limits is reached.
+    /// Has no effect if the archive is not solid.
+    /// - Parameter count: The number of items, `0` means unlimited.
+    /// - Note: Thread-safe. Must be set before opening.
+    /// - Throws: `Exception`.
+    public func setSolidBlockFileCount(_ count: UInt32) throws {
+        var encoder = object
+        plzma_encoder_set_solid_block_file_count(&encoder, count)
+        if let exception = encoder.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
     /// Should encoder compress the archive header.
     /// - Note: Enabled by default, the value is `true`.
     /// - Note: Thread-safe.
@@ -82,3 +82,17 @@ public var decoderWriteSize: Size {
         plzma_set_decoder_write_size(newValue)
     }
 }
+
+
+/// Receives or changes the maximum number of the parsed 7z archive headers kept in the process-wide index cache.
+///
+/// The decoder opening the same archive again copies the cached header instead of reading and decoding it.
+/// The archives with encrypted headers are never cached. Default is 0, the cache is disabled.
+public var indexCacheCapacity: Size {
+    get {
+        return plzma_index_cache_capacity()
+    }
+    set {
+        plzma_set_index_cache_capacity(newValue)
+    }
+}
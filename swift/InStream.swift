@@ -103,6 +103,20 @@ public class InStream {
     }
     
     
+    /// Initializes the input file stream with path and reading mode.
+    /// - Parameter path: The non-empty input file path.
+    /// - Parameter mode: The mode of reading the file content.
+    /// - Throws: `Exception` with `.invalidArguments` code in case if path is empty.
+    public init(path: Path, mode: InStreamMode) throws {
+        var pathObject = path.object
+        let stream = plzma_in_stream_create_with_path_mode(&pathObject, mode.type)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        object = stream
+    }
+    
+    
     /// Initializes the input file stream with the file data.
     /// During the creation, the data will copyed.
     /// - Parameter dataCopy: The file data.
@@ -249,6 +263,25 @@ public class InStream {
         object = stream
     }
     
+    /// Initializes the input stream which reads the content of the source stream ahead in a separate thread.
+    ///
+    /// The thread reads up to `chunksCount` chunks after the current position, so the reading of the source stream
+    /// overlaps with the decoding. The seek outside of the read ahead content drops the chunks.
+    /// The memory usage is limited to `chunkSize` * `chunksCount` bytes while the stream is opened.
+    /// - Parameter readAhead: The source input stream.
+    /// - Parameter chunkSize: The size of the chunk in bytes, less than 4GB.
+    /// - Parameter chunksCount: The maximum number of the read ahead chunks.
+    /// - Throws: `Exception` with `.invalidArguments` code in case if the chunk size or the number of chunks is zero.
+    public init(readAhead source: InStream, chunkSize: Int, chunksCount: Size) throws {
+        var sourceObject = source.object
+        let stream = plzma_in_stream_create_read_ahead(&sourceObject, chunkSize, chunksCount)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        
+        object = stream
+    }
+    
     deinit {
         var stream = object
         plzma_in_stream_release(&stream)
@@ -0,0 +1,104 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+import Foundation
+#if SWIFT_PACKAGE
+import libplzma
+#endif
+
+/// The decoded content of a single archive item.
+///
+/// The content is decoded on demand, while reading, so the memory usage doesn't depend on the item size.
+public final class ItemStream {
+    internal let object: plzma_item_stream
+    
+    /// The archive item of the stream.
+    /// - Throws: `Exception`.
+    /// - Note: Thread-safe.
+    public func item() throws -> Item {
+        var stream = object
+        let item = plzma_item_stream_item(&stream)
+        if let exception = item.exception {
+            throw Exception(object: exception)
+        }
+        return Item(object: item)
+    }
+    
+    
+    /// Reads the next portion of the decoded content.
+    ///
+    /// Waits until some content is decoded.
+    /// - Parameter buffer: The buffer to read to.
+    /// - Returns: The number of bytes read, `0` means the end of the content or the stream is closed.
+    /// - Throws: `Exception` in case of the decoding error, the error is reported once.
+    /// - Note: Read from a single thread.
+    public func read(into buffer: UnsafeMutableRawBufferPointer) throws -> Int {
+        guard let baseAddress = buffer.baseAddress, buffer.count > 0 else {
+            return 0
+        }
+        var stream = object
+        let result = plzma_item_stream_read(&stream, baseAddress, buffer.count)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Reads the next portion of the decoded content to `Data`.
+    /// - Parameter maxLength: The maximum number of bytes to read.
+    /// - Returns: The `Data` with the content, the empty data means the end of the content or the stream is closed.
+    /// - Throws: `Exception` in case of the decoding error, the error is reported once.
+    /// - Note: Read from a single thread.
+    public func read(maxLength: Int) throws -> Data {
+        var data = Data(count: maxLength)
+        let count = try data.withUnsafeMutableBytes { try read(into: $0) }
+        data.count = count
+        return data
+    }
+    
+    
+    /// Stops the decoding and closes the stream.
+    /// - Throws: `Exception`.
+    /// - Note: Thread-safe.
+    public func close() throws {
+        var stream = object
+        plzma_item_stream_close(&stream)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    internal init(object o: plzma_item_stream) {
+        object = o
+    }
+    
+    deinit {
+        var stream = object
+        plzma_item_stream_release(&stream)
+    }
+}
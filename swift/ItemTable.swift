@@ -0,0 +1,136 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+import Foundation
+#if SWIFT_PACKAGE
+import libplzma
+#endif
+
+/// The read-only columnar listing of the archive items.
+///
+/// Holds the paths and properties of all items in a few contiguous blocks.
+/// Preferred for listing large archives instead of the array of items.
+public final class ItemTable {
+    internal let object: plzma_item_table
+    
+    /// The number of items inside the table.
+    public var count: Size {
+        var table = object
+        return plzma_item_table_count(&table)
+    }
+    
+    
+    /// The item's path inside the archive at index.
+    /// - Parameter index: The index of the item. Must be less than the number of items, i.e. the value of the `count` property.
+    /// - Returns: The path or empty string.
+    public func path(at index: Size) -> String {
+        var table = object
+        if let utf8 = plzma_item_table_path_utf8(&table, index, nil) {
+            return String(cString: utf8)
+        }
+        return ""
+    }
+    
+    
+    /// The size in bytes of the item at index.
+    public func size(at index: Size) -> UInt64 {
+        var table = object
+        return plzma_item_table_size(&table, index)
+    }
+    
+    
+    /// The packed size in bytes of the item at index.
+    public func packSize(at index: Size) -> UInt64 {
+        var table = object
+        return plzma_item_table_pack_size(&table, index)
+    }
+    
+    
+    /// The CRC-32 checksum of the item's content at index.
+    public func crc32(at index: Size) -> UInt32 {
+        var table = object
+        return plzma_item_table_crc32(&table, index)
+    }
+    
+    
+    /// The creation date of the item at index.
+    public func creationDate(at index: Size) -> Date {
+        var table = object
+        return Date(timeIntervalSince1970: TimeInterval(plzma_item_table_creation_time(&table, index)))
+    }
+    
+    
+    /// The last access date of the item at index.
+    public func accessDate(at index: Size) -> Date {
+        var table = object
+        return Date(timeIntervalSince1970: TimeInterval(plzma_item_table_access_time(&table, index)))
+    }
+    
+    
+    /// The last modification date of the item at index.
+    public func modificationDate(at index: Size) -> Date {
+        var table = object
+        return Date(timeIntervalSince1970: TimeInterval(plzma_item_table_modification_time(&table, index)))
+    }
+    
+    
+    /// Checks whether the item at index is encrypted.
+    public func encrypted(at index: Size) -> Bool {
+        var table = object
+        return plzma_item_table_encrypted(&table, index)
+    }
+    
+    
+    /// Checks whether the item at index is a directory.
+    public func isDir(at index: Size) -> Bool {
+        var table = object
+        return plzma_item_table_is_dir(&table, index)
+    }
+    
+    
+    /// Creates the retained item at index.
+    /// - Parameter index: The index of the item. Must be less than the number of items, i.e. the value of the `count` property.
+    /// - Returns: The item at index.
+    /// - Throws: `Exception`.
+    public func item(at index: Size) throws -> Item {
+        var table = object
+        let item = plzma_item_table_item_at(&table, index)
+        if let exception = item.exception {
+            throw Exception(object: exception)
+        }
+        return Item(object: item)
+    }
+    
+    internal init(object o: plzma_item_table) {
+        object = o
+    }
+    
+    deinit {
+        var table = object
+        plzma_item_table_release(&table)
+    }
+}
@@ -69,6 +69,65 @@ public class OutStream {
     }
     
     
+    /// Takes the content of the stream to `Data` without copying.
+    ///
+    /// The stream must be closed. The memory stream moves out it's content and becomes empty,
+    /// the content of other streams is copied.
+    /// - Returns: The `Data` with stream's content.
+    /// - Throws: `Exception` with `.notEnoughMemory` code in case if required amount of memory can't be allocated.
+    /// - Note: Thread-safe.
+    public func takeContent() throws -> Data {
+        var stream = object
+        let content = plzma_out_stream_take_content(&stream)
+        if let exception = content.exception {
+            throw Exception(object: exception)
+        }
+        if content.size > 0, let memory = content.memory {
+            return Data(bytesNoCopy: memory, count: content.size, deallocator: .custom({ (memory, _) in
+                plzma_free(memory)
+            }))
+        }
+        plzma_free(content.memory)
+        return Data()
+    }
+    
+    
+    /// Provides the read-only access to the content of the memory stream.
+    ///
+    /// The stream must be closed. The buffer is empty if the stream is opened, empty or is not a memory stream.
+    /// - Parameter body: The closure with the buffer of the stream's content. The buffer is valid only during the closure call.
+    /// - Returns: The result of the `body` closure.
+    /// - Throws: `Exception` or rethrows the error of the `body` closure.
+    /// - Note: Thread-safe.
+    public func withContentView<R>(_ body: (UnsafeRawBufferPointer) throws -> R) throws -> R {
+        var stream = object
+        var size = 0
+        let memory = plzma_out_stream_content_view(&stream, &size)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        return try withExtendedLifetime(self) {
+            try body(UnsafeRawBufferPointer(start: memory, count: memory == nil ? 0 : size))
+        }
+    }
+    
+    
+    /// Reserves the memory for the content of the memory stream.
+    ///
+    /// Helps to avoid reallocations in case if the expected size of the content is known.
+    /// Does nothing for the file streams.
+    /// - Parameter size: The number of bytes to reserve.
+    /// - Throws: `Exception` with `.notEnoughMemory` code in case if required amount of memory can't be allocated.
+    /// - Note: Thread-safe.
+    public func reserve(_ size: UInt64) throws {
+        var stream = object
+        plzma_out_stream_reserve(&stream, size)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
     /// Erases and removes the content of the stream.
     /// - Parameter erase: The type of erasing the content.
     /// - Note: Thread-safe.
@@ -123,6 +182,18 @@ public class OutStream {
         object = stream
     }
     
+    
+    /// Initializes the output file stream object for writing to memory with initial capacity.
+    /// - Parameter capacity: The number of bytes to reserve for the content of the stream.
+    /// - Throws: `Exception` with `.notEnoughMemory` code in case if required amount of memory can't be allocated.
+    public init(capacity: Int) throws {
+        let stream = plzma_out_stream_create_memory_stream_with_capacity(capacity)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        object = stream
+    }
+    
     deinit {
         var stream = object
         plzma_out_stream_release(&stream)
@@ -0,0 +1,148 @@
+//
+// By using this Software, you are accepting original [LZMA SDK] and MIT license below:
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 - 2022 Oleh Kulykov <olehkulykov@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+import Foundation
+#if SWIFT_PACKAGE
+import libplzma
+#endif
+
+/// The decoded content of the xz archive with random access.
+///
+/// Only the xz blocks with the requested range are decoded, the few recently used blocks are cached.
+public final class RandomAccessStream {
+    internal let object: plzma_random_access_stream
+    
+    /// The size of the decoded content in bytes.
+    /// - Throws: `Exception`.
+    /// - Note: Thread-safe.
+    public func size() throws -> UInt64 {
+        var stream = object
+        let result = plzma_random_access_stream_size(&stream)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// The current position of the `read` function.
+    /// - Throws: `Exception`.
+    /// - Note: Thread-safe.
+    public func position() throws -> UInt64 {
+        var stream = object
+        let result = plzma_random_access_stream_position(&stream)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Moves the current position of the `read` function.
+    /// - Parameter offset: The offset from the start of the content.
+    /// - Throws: `Exception`.
+    /// - Note: Thread-safe.
+    public func seek(to offset: UInt64) throws {
+        var stream = object
+        plzma_random_access_stream_seek(&stream, offset)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    
+    /// Reads the decoded content from the current position and moves the position.
+    /// - Parameter buffer: The buffer to read to.
+    /// - Returns: The number of bytes read, `0` means the end of the content or the stream is closed.
+    /// - Throws: `Exception` in case of the decoding error.
+    /// - Note: Thread-safe.
+    public func read(into buffer: UnsafeMutableRawBufferPointer) throws -> Int {
+        guard let baseAddress = buffer.baseAddress, buffer.count > 0 else {
+            return 0
+        }
+        var stream = object
+        let result = plzma_random_access_stream_read(&stream, baseAddress, buffer.count)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Reads the decoded content from the offset without changing the current position.
+    /// - Parameter buffer: The buffer to read to.
+    /// - Parameter offset: The offset from the start of the content.
+    /// - Returns: The number of bytes read, `0` means the offset is at the end of the content or the stream is closed.
+    /// - Throws: `Exception` in case of the decoding error.
+    /// - Note: Thread-safe.
+    public func read(into buffer: UnsafeMutableRawBufferPointer, at offset: UInt64) throws -> Int {
+        guard let baseAddress = buffer.baseAddress, buffer.count > 0 else {
+            return 0
+        }
+        var stream = object
+        let result = plzma_random_access_stream_pread(&stream, baseAddress, buffer.count, offset)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+        return result
+    }
+    
+    
+    /// Reads the decoded content from the offset to `Data` without changing the current position.
+    /// - Parameter maxLength: The maximum number of bytes to read.
+    /// - Parameter offset: The offset from the start of the content.
+    /// - Returns: The `Data` with the content, the empty data means the offset is at the end of the content or the stream is closed.
+    /// - Throws: `Exception` in case of the decoding error.
+    /// - Note: Thread-safe.
+    public func read(maxLength: Int, at offset: UInt64) throws -> Data {
+        var data = Data(count: maxLength)
+        let count = try data.withUnsafeMutableBytes { try read(into: $0, at: offset) }
+        data.count = count
+        return data
+    }
+    
+    
+    /// Closes the stream and releases the cached blocks.
+    /// - Throws: `Exception`.
+    /// - Note: Thread-safe.
+    public func close() throws {
+        var stream = object
+        plzma_random_access_stream_close(&stream)
+        if let exception = stream.exception {
+            throw Exception(object: exception)
+        }
+    }
+    
+    internal init(object o: plzma_random_access_stream) {
+        object = o
+    }
+    
+    deinit {
+        var stream = object
+        plzma_random_access_stream_release(&stream)
+    }
+}
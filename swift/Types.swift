@@ -169,6 +169,24 @@ public struct OpenDirMode: OptionSet {
     public static let followSymlinks = OpenDirMode(rawValue: 1 << 0)
 }
 
+/// The mode of reading the content of the input file stream.
+public enum InStreamMode: UInt8, Enum {
+    
+    public typealias EType = plzma_in_stream_mode
+    
+    /// The file content is read with the buffered file functions, i.e. `fread` and `fseek`.
+    case `default` = 0
+    
+    /// The file is mapped into memory and the content is copied directly from the mapping.
+    /// Falls back to the `default` mode if the file can't be mapped.
+    case mmap = 1
+}
+
+extension plzma_in_stream_mode: Enum {
+    
+    public typealias EType = InStreamMode
+}
+
 public enum MultiStreamPartNameFormat: UInt8, Enum {
 
     public typealias EType = plzma_plzma_multi_stream_part_name_format